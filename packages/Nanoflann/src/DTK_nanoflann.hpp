@@ -292,6 +292,22 @@ namespace nanoflann
 		{
 			return nanoflann::abs(a-b);
 		}
+
+		/** Distances from a to a block of points stored by coordinate: coordinate d of point j is block[d*stride+j]. */
+		inline void block_distances(const T* a, const T* block, const size_t stride, const size_t count, const size_t size, DistanceType* dists) const
+		{
+			for (size_t j=0; j<count; ++j) dists[j] = DistanceType();
+			for (size_t d=0; d<size; ++d) {
+				const T ad = a[d];
+				const T* coords = block + d*stride;
+#if defined(_OPENMP) && (_OPENMP >= 201307)
+#pragma omp simd
+#endif
+				for (size_t j=0; j<count; ++j) {
+					dists[j] += nanoflann::abs(ad - coords[j]);
+				}
+			}
+		}
 	};
 
 	/** Squared Euclidean distance functor (generic version, optimized for high-dimensionality data sets).
@@ -341,6 +357,23 @@ namespace nanoflann
 		{
 			return (a-b)*(a-b);
 		}
+
+		/** Distances from a to a block of points stored by coordinate: coordinate d of point j is block[d*stride+j]. */
+		inline void block_distances(const T* a, const T* block, const size_t stride, const size_t count, const size_t size, DistanceType* dists) const
+		{
+			for (size_t j=0; j<count; ++j) dists[j] = DistanceType();
+			for (size_t d=0; d<size; ++d) {
+				const T ad = a[d];
+				const T* coords = block + d*stride;
+#if defined(_OPENMP) && (_OPENMP >= 201307)
+#pragma omp simd
+#endif
+				for (size_t j=0; j<count; ++j) {
+					const DistanceType diff = ad - coords[j];
+					dists[j] += diff * diff;
+				}
+			}
+		}
 	};
 
 	/** Squared Euclidean distance functor (suitable for low-dimensionality datasets, like 2D or 3D point clouds)
@@ -367,6 +400,23 @@ namespace nanoflann
 		{
 			return (a-b)*(a-b);
 		}
+
+		/** Distances from a to a block of points stored by coordinate: coordinate d of point j is block[d*stride+j]. */
+		inline void block_distances(const T* a, const T* block, const size_t stride, const size_t count, const size_t size, DistanceType* dists) const
+		{
+			for (size_t j=0; j<count; ++j) dists[j] = DistanceType();
+			for (size_t d=0; d<size; ++d) {
+				const T ad = a[d];
+				const T* coords = block + d*stride;
+#if defined(_OPENMP) && (_OPENMP >= 201307)
+#pragma omp simd
+#endif
+				for (size_t j=0; j<count; ++j) {
+					const DistanceType diff = ad - coords[j];
+					dists[j] += diff * diff;
+				}
+			}
+		}
 	};
 
 	/** Metaprogramming helper traits class for the L1 (Manhattan) metric */
@@ -460,6 +510,9 @@ namespace nanoflann
 	const size_t     WORDSIZE=16;
 	const size_t     BLOCKSIZE=8192;
 
+	/** Number of leaf points whose distances are computed together by block_distances(). */
+	const size_t     LEAF_BLOCK_SIZE=64;
+
 	class PooledAllocator
 	{
 		/* We maintain memory alignment to word boundaries by requiring that all
@@ -841,6 +894,21 @@ namespace nanoflann
 		 */
 		PooledAllocator pool;
 
+		/**
+		 * Pooled memory allocators for the subtrees built in parallel,
+		 * indexed by the heap number of the subtree root.
+		 */
+		Teuchos::Array<PooledAllocator> subtree_pools;
+
+		/**
+		 * Coordinates of the points in tree order stored by coordinate:
+		 * coordinate d of point vind[i] is leaf_coords[d*m_size+i]. The
+		 * points of each leaf are then a block of contiguous coordinate
+		 * arrays that are scanned with block_distances(). Empty unless
+		 * buildLeafBlocks() was called.
+		 */
+		Teuchos::Array<ElementType> leaf_coords;
+
 	public:
 
 		Distance distance;
@@ -878,6 +946,8 @@ namespace nanoflann
 		void freeIndex()
 		{
 			pool.free_all();
+			subtree_pools.clear();
+			leaf_coords.clear();
 			root_node=NULL;
 		}
 
@@ -889,7 +959,86 @@ namespace nanoflann
 			init_vind();
 			computeBoundingBox(root_bbox);
 			freeIndex();
-			root_node = divideTree(0, m_size, root_bbox );   // construct the tree
+			root_node = divideTree(0, m_size, root_bbox, pool );   // construct the tree
+		}
+
+		/**
+		 * Builds the index with OpenMP tasks. The root bounding box is
+		 * computed with a parallel reduction over the points, the top
+		 * task_depth levels of splits spawn a task per child and the
+		 * subtrees below them are built concurrently, each in its own
+		 * memory pool. The resulting tree is identical to the one built by
+		 * buildIndex(). Without OpenMP this is buildIndex().
+		 */
+		void buildIndexParallel(const int task_depth)
+		{
+#ifdef _OPENMP
+			init_vind();
+			computeBoundingBoxParallel(root_bbox);
+			freeIndex();
+			subtree_pools.resize( size_t(2) << std::max(task_depth,0) );
+#pragma omp parallel
+			{
+#pragma omp single
+				root_node = divideTreeParallel(0, m_size, root_bbox, task_depth, 1);
+			}
+#else
+			(void) task_depth;
+			buildIndex();
+#endif
+		}
+
+		/**
+		 * Stores a copy of the point coordinates in leaf blocks so leaf
+		 * scans compute the distances to a whole leaf with contiguous,
+		 * vectorizable loops. Must be called after the index is built.
+		 */
+		void buildLeafBlocks()
+		{
+			const int num_dims = (DIM>0 ? DIM : dim);
+			const long num_points = static_cast<long>(m_size);
+			leaf_coords.resize(num_dims*m_size);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+			for (long i=0; i<num_points; ++i) {
+				for (int d=0; d<num_dims; ++d) {
+					leaf_coords[d*m_size+i] = dataset_get(vind[i],d);
+				}
+			}
+		}
+
+		/**
+		 * Returns the permutation of the dataset points into tree order.
+		 * The leaves index contiguous ranges of it.
+		 */
+		const Teuchos::Array<IndexType>& getIndices() const
+		{
+			return vind;
+		}
+
+		/**
+		 * Returns the bounding box of the dataset the index was built with.
+		 */
+		void getRootBoundingBox(ElementType* low, ElementType* high) const
+		{
+			for (int i=0; i<(DIM>0 ? DIM : dim); ++i) {
+				low[i] = root_bbox[i].low;
+				high[i] = root_bbox[i].high;
+			}
+		}
+
+		/**
+		 * Writes the built tree into an array of nodes in depth-first order
+		 * with the root first. FlatNodeType must have the members left,
+		 * right, divfeat, divlow, divhigh, child1 and child2. Children are
+		 * stored as indices into the array and are -1 for leaves.
+		 */
+		template <class FlatNodeType>
+		void flattenIndex(Teuchos::Array<FlatNodeType>& nodes) const
+		{
+			nodes.clear();
+			if (root_node!=NULL) flattenNode(root_node, nodes);
 		}
 
 		/**
@@ -914,7 +1063,11 @@ namespace nanoflann
 		 */
 		size_t usedMemory() const
 		{
-			return pool.usedMemory+pool.wastedMemory+dataset.kdtree_get_point_count()*sizeof(IndexType);  // pool memory and vind array memory
+			size_t subtree_memory = 0;
+			for (typename Teuchos::Array<PooledAllocator>::size_type i=0; i<subtree_pools.size(); ++i) {
+				subtree_memory += subtree_pools[i].usedMemory+subtree_pools[i].wastedMemory;
+			}
+			return pool.usedMemory+pool.wastedMemory+subtree_memory+dataset.kdtree_get_point_count()*sizeof(IndexType)+leaf_coords.size()*sizeof(ElementType);  // pool memory, vind array and leaf block memory
 		}
 
 		/** \name Query methods
@@ -1057,9 +1210,9 @@ namespace nanoflann
 		 *                  first = index of the first vector
 		 *                  last = index of the last vector
 		 */
-		NodePtr divideTree(const IndexType left, const IndexType right, BoundingBox& bbox)
+		NodePtr divideTree(const IndexType left, const IndexType right, BoundingBox& bbox, PooledAllocator& node_pool)
 		{
-			NodePtr node = pool.allocate<Node>(); // allocate memory
+			NodePtr node = node_pool.allocate<Node>(); // allocate memory
 
 			/* If too few exemplars remain, then make this a leaf node. */
 			if ( (right-left) <= m_leaf_max_size) {
@@ -1089,11 +1242,11 @@ namespace nanoflann
 
 				BoundingBox left_bbox(bbox);
 				left_bbox[cutfeat].high = cutval;
-				node->child1 = divideTree(left, left+idx, left_bbox);
+				node->child1 = divideTree(left, left+idx, left_bbox, node_pool);
 
 				BoundingBox right_bbox(bbox);
 				right_bbox[cutfeat].low = cutval;
-				node->child2 = divideTree(left+idx, right, right_bbox);
+				node->child2 = divideTree(left+idx, right, right_bbox, node_pool);
 
 				node->sub.divlow = left_bbox[cutfeat].high;
 				node->sub.divhigh = right_bbox[cutfeat].low;
@@ -1107,6 +1260,120 @@ namespace nanoflann
 			return node;
 		}
 
+#ifdef _OPENMP
+		/**
+		 * Bounding box of the dataset computed with a parallel reduction.
+		 * Must be called outside of a parallel region.
+		 */
+		void computeBoundingBoxParallel(BoundingBox& bbox)
+		{
+			bbox.resize((DIM>0 ? DIM : dim));
+			if (dataset.kdtree_get_bbox(bbox))
+			{
+				// Done! It was implemented in derived class
+			}
+			else
+			{
+				for (int i=0; i<(DIM>0 ? DIM : dim); ++i) {
+					bbox[i].low =
+						bbox[i].high = dataset_get(0,i);
+				}
+				const long N = static_cast<long>(dataset.kdtree_get_point_count());
+#pragma omp parallel
+				{
+					BoundingBox thread_bbox(bbox);
+#pragma omp for nowait
+					for (long k=1; k<N; ++k) {
+						for (int i=0; i<(DIM>0 ? DIM : dim); ++i) {
+							if (dataset_get(k,i)<thread_bbox[i].low) thread_bbox[i].low = dataset_get(k,i);
+							if (dataset_get(k,i)>thread_bbox[i].high) thread_bbox[i].high = dataset_get(k,i);
+						}
+					}
+#pragma omp critical (nanoflann_bbox)
+					{
+						for (int i=0; i<(DIM>0 ? DIM : dim); ++i) {
+							bbox[i].low = std::min(bbox[i].low, thread_bbox[i].low);
+							bbox[i].high = std::max(bbox[i].high, thread_bbox[i].high);
+						}
+					}
+				}
+			}
+		}
+
+		/**
+		 * Task-parallel version of divideTree(). Each split above
+		 * task_depth spawns a task for each child. A node at task_depth, or
+		 * a leaf above it, is built serially by divideTree() into the
+		 * subtree pool given by its heap number. The splits are the same as
+		 * in divideTree() so the tree is identical.
+		 *
+		 * Params: heap_id = heap number of the node (root is 1)
+		 */
+		NodePtr divideTreeParallel(const IndexType left, const IndexType right, BoundingBox& bbox, const int task_depth, const size_t heap_id)
+		{
+			if ( task_depth <= 0 || (right-left) <= m_leaf_max_size ) {
+				return divideTree(left, right, bbox, subtree_pools[heap_id]);
+			}
+
+			NodePtr node;
+#pragma omp critical (nanoflann_pool)
+			node = pool.allocate<Node>();
+
+			IndexType idx;
+			int cutfeat;
+			DistanceType cutval;
+			middleSplit_(&vind[0]+left, right-left, idx, cutfeat, cutval, bbox);
+
+			node->sub.divfeat = cutfeat;
+
+			BoundingBox left_bbox(bbox);
+			left_bbox[cutfeat].high = cutval;
+			BoundingBox right_bbox(bbox);
+			right_bbox[cutfeat].low = cutval;
+
+#pragma omp task shared(left_bbox)
+			node->child1 = divideTreeParallel(left, left+idx, left_bbox, task_depth-1, 2*heap_id);
+#pragma omp task shared(right_bbox)
+			node->child2 = divideTreeParallel(left+idx, right, right_bbox, task_depth-1, 2*heap_id+1);
+#pragma omp taskwait
+
+			node->sub.divlow = left_bbox[cutfeat].high;
+			node->sub.divhigh = right_bbox[cutfeat].low;
+
+			for (int i=0; i<(DIM>0 ? DIM : dim); ++i) {
+				bbox[i].low = std::min(left_bbox[i].low, right_bbox[i].low);
+				bbox[i].high = std::max(left_bbox[i].high, right_bbox[i].high);
+			}
+
+			return node;
+		}
+#endif
+
+		template <class FlatNodeType>
+		int flattenNode(const NodePtr node, Teuchos::Array<FlatNodeType>& nodes) const
+		{
+			const int id = nodes.size();
+			nodes.push_back(FlatNodeType());
+			if ((node->child1 == NULL)&&(node->child2 == NULL)) {
+				nodes[id].left = node->lr.left;
+				nodes[id].right = node->lr.right;
+				nodes[id].divfeat = -1;
+				nodes[id].divlow = nodes[id].divhigh = 0;
+				nodes[id].child1 = nodes[id].child2 = -1;
+			}
+			else {
+				nodes[id].left = nodes[id].right = 0;
+				nodes[id].divfeat = node->sub.divfeat;
+				nodes[id].divlow = node->sub.divlow;
+				nodes[id].divhigh = node->sub.divhigh;
+				const int child1 = flattenNode(node->child1, nodes);
+				const int child2 = flattenNode(node->child2, nodes);
+				nodes[id].child1 = child1;
+				nodes[id].child2 = child2;
+			}
+			return id;
+		}
+
 		void computeMinMax(IndexType* ind, IndexType count, int element, ElementType& min_elem, ElementType& max_elem)
 		{
 			min_elem = dataset_get(ind[0],element);
@@ -1274,6 +1541,19 @@ namespace nanoflann
 			if ((node->child1 == NULL)&&(node->child2 == NULL)) {
 				//count_leaf += (node->lr.right-node->lr.left);  // Removed since was neither used nor returned to the user.
 				DistanceType worst_dist = result_set.worstDist();
+				if (!leaf_coords.empty()) {
+					DistanceType block_dists[LEAF_BLOCK_SIZE];
+					for (IndexType begin=node->lr.left; begin<node->lr.right; begin+=LEAF_BLOCK_SIZE) {
+						const IndexType count = std::min<IndexType>(LEAF_BLOCK_SIZE, node->lr.right-begin);
+						distance.block_distances(vec, &leaf_coords[begin], m_size, count, (DIM>0 ? DIM : dim), block_dists);
+						for (IndexType j=0; j<count; ++j) {
+							if (block_dists[j]<worst_dist) {
+								result_set.addPoint(block_dists[j],vind[begin+j]);
+							}
+						}
+					}
+					return;
+				}
 				for (IndexType i=node->lr.left; i<node->lr.right; ++i) {
 					const IndexType index = vind[i];// reorder... : i;
 					DistanceType dist = distance(vec, index, (DIM>0 ? DIM : dim));
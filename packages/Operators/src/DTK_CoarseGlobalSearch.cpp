@@ -41,6 +41,7 @@
 #include <limits>
 
 #include "DTK_CoarseGlobalSearch.hpp"
+#include "DTK_BoundingBoxTree.hpp"
 
 #include <Teuchos_CommHelpers.hpp>
 
@@ -111,19 +112,24 @@ void CoarseGlobalSearch::search( const EntityIterator& range_iterator,
 
     // Find the domain boxes it intersects with.
     Teuchos::Array<int> neighbor_ranks;
-    Teuchos::Array<Teuchos::Tuple<double,6> > neighbor_boxes;
+    Teuchos::Array<double> neighbor_boxes;
     int num_domains = d_domain_boxes.size();
     for ( int n = 0; n < num_domains; ++n )
     {
 	if ( boxesIntersect(range_box,d_domain_boxes[n]) )
 	{
 	    neighbor_ranks.push_back(n);
-	    neighbor_boxes.push_back( d_domain_boxes[n] );
+	    neighbor_boxes.insert( neighbor_boxes.end(),
+				   d_domain_boxes[n].begin(),
+				   d_domain_boxes[n].end() );
 	}
     }
 
+    // Build a tree over the neighbor boxes so the boxes containing each
+    // centroid are found without checking every neighbor.
+    BoundingBoxTree neighbor_tree( d_space_dim, neighbor_boxes() );
+
     // For each local range entity, find the neighbors we should send it to.
-    int num_neighbors = neighbor_boxes.size();
     EntityIterator range_begin = range_iterator.begin();
     EntityIterator range_end = range_iterator.end();
     EntityIterator range_it;
@@ -131,26 +137,27 @@ void CoarseGlobalSearch::search( const EntityIterator& range_iterator,
     Teuchos::Array<int> send_ranks;
     Teuchos::Array<double> send_centroids;
     Teuchos::Array<double> centroid(d_space_dim);
+    Teuchos::Array<unsigned> centroid_neighbors;
     bool found_entity = false;
     for ( range_it = range_begin; range_it != range_end; ++range_it )
     {
 	// Get the centroid.
 	range_local_map->centroid( *range_it, centroid() );
 
-	// Check the neighbors.
-	found_entity = false;
-	for ( int n = 0; n < num_neighbors; ++n )
+	// Find the neighbors with boxes containing the centroid and add the
+	// entity to their send lists.
+	neighbor_tree.pointSearch( centroid.getRawPtr(), centroid_neighbors );
+	found_entity = !centroid_neighbors.empty();
+	for ( Teuchos::Array<unsigned>::const_iterator 
+		  n = centroid_neighbors.begin();
+	      n != centroid_neighbors.end();
+	      ++n )
 	{
-	    // If the centroid is in the box, add it to the send list.
-	    if ( pointInBox(centroid(),neighbor_boxes[n]) )
+	    send_ids.push_back( range_it->id() );
+	    send_ranks.push_back( neighbor_ranks[*n] );
+	    for ( int d = 0; d < d_space_dim; ++d )
 	    {
-		found_entity = true;
-		send_ids.push_back( range_it->id() );
-		send_ranks.push_back( neighbor_ranks[n] );
-		for ( int d = 0; d < d_space_dim; ++d )
-		{
-		    send_centroids.push_back( centroid[d] );
-		}
+		send_centroids.push_back( centroid[d] );
 	    }
 	}
 
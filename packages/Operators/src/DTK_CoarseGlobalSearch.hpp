@@ -102,10 +102,6 @@ class CoarseGlobalSearch
     inline bool boxesIntersect( const Teuchos::Tuple<double,6>& box_A,
 				const Teuchos::Tuple<double,6>& box_B ) const;
 
-    // Determine if a point is in a bounding box.
-    inline bool pointInBox( const Teuchos::ArrayView<const double>& point,
-			    const Teuchos::Tuple<double,6>& box ) const;
-    
   private:
 
     // Communicator.
@@ -138,40 +134,6 @@ bool CoarseGlobalSearch::boxesIntersect(
 	      ( box_A[2] > box_B[5] || box_A[5] < box_B[2] ) );
 }
 
-//---------------------------------------------------------------------------//
-// Determine if a point is in a bounding box.
-bool CoarseGlobalSearch::pointInBox( 
-    const Teuchos::ArrayView<const double>& point,
-    const Teuchos::Tuple<double,6>& box ) const
-{
-    if( 3 == point.size() )
-    {
-	if ( point[0] >= box[0] && point[1] >= box[1] && point[2] >= box[2] &&
-	     point[0] <= box[3] && point[1] <= box[4] && point[2] <= box[5] )
-	{
-	    return true;
-	}
-    }
-    else if( 2 == point.size() )
-    {
-	if ( point[0] >= box[0] && point[1] >= box[1] &&
-	     point[0] <= box[3] && point[1] <= box[4] )
-	{
-	    return true;
-	}
-    }
-    else if( 1 == point.size() )
-    {
-	if ( point[0] >= box[0] &&
-	     point[0] <= box[3] )
-	{
-	    return true;
-	}
-    }
-
-    return false;
-}
-
 //---------------------------------------------------------------------------//
 
 } // end namespace DataTransferKit
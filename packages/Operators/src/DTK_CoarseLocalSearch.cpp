@@ -40,10 +40,12 @@
 
 #include <cmath>
 #include <algorithm>
+#include <string>
 
 #include "DTK_CoarseLocalSearch.hpp"
 #include "DTK_DBC.hpp"
 #include "DTK_SearchTreeFactory.hpp"
+#include "DTK_SpaceFillingCurve.hpp"
 
 namespace DataTransferKit
 {
@@ -89,8 +91,31 @@ CoarseLocalSearch::CoarseLocalSearch(
 	leaf_size = parameters.get<int>("Coarse Search Local Leaf Size");
     }
     leaf_size = std::min( leaf_size, num_entity );
+    bool parallel_build = false;
+    if ( parameters.isParameter("Coarse Search Local Parallel Build") )
+    {
+	parallel_build = 
+	    parameters.get<bool>("Coarse Search Local Parallel Build");
+    }
+    SpaceFillingCurve::CurveType curve = SpaceFillingCurve::NONE;
+    if ( parameters.isParameter("Space Filling Curve") )
+    {
+	curve = SpaceFillingCurve::curveType(
+	    parameters.get<std::string>("Space Filling Curve") );
+    }
+    bool leaf_blocks = false;
+    if ( parameters.isParameter("Coarse Search Local Leaf Blocks") )
+    {
+	leaf_blocks = parameters.get<bool>("Coarse Search Local Leaf Blocks");
+    }
+    double eps = 0.0;
+    if ( parameters.isParameter("Coarse Local Search Epsilon") )
+    {
+	eps = parameters.get<double>("Coarse Local Search Epsilon");
+    }
     d_tree = SearchTreeFactory::createStaticTree(
-	space_dim, d_entity_centroids(), leaf_size );
+	space_dim, d_entity_centroids(), leaf_size, 
+	parallel_build, curve, leaf_blocks, eps );
     DTK_ENSURE( Teuchos::nonnull(d_tree) );
 }
 
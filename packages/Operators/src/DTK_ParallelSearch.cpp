@@ -40,6 +40,7 @@
 
 #include "DTK_ParallelSearch.hpp"
 #include "DTK_DBC.hpp"
+#include "DTK_SpaceFillingCurve.hpp"
 
 #include <Tpetra_Distributor.hpp>
 
@@ -131,30 +132,78 @@ void ParallelSearch::search(
     Teuchos::Array<EntityId> export_data;
     if ( !d_empty_domain )
     {
-	// For each range centroid, perform a local search.
+	// Get the order to search the range centroids in. Centroids close
+	// on a space-filling curve visit the same tree nodes and domain
+	// entities.
+	SpaceFillingCurve::CurveType curve = SpaceFillingCurve::NONE;
+	if ( parameters.isParameter("Space Filling Curve") )
+	{
+	    curve = SpaceFillingCurve::curveType(
+		parameters.get<std::string>("Space Filling Curve") );
+	}
 	int num_range = range_entity_ids.size();
+	bool reorder = ( SpaceFillingCurve::NONE != curve );
+
+	// If the centroids are reordered, search them along the curve first
+	// and store the results by centroid so they are processed below in
+	// the order the centroids arrived in.
 	Teuchos::Array<Entity> domain_neighbors;
+	Teuchos::Array<Teuchos::Array<Entity> > range_parents;
+	Teuchos::Array<Teuchos::Array<double> > range_reference_coordinates;
+	int n = 0;
+	if ( reorder )
+	{
+	    Teuchos::Array<unsigned> search_order;
+	    SpaceFillingCurve::sortPermutation( 
+		d_physical_dim, range_centroids(), curve, search_order );
+	    range_parents.resize( num_range );
+	    range_reference_coordinates.resize( num_range );
+	    for ( int s = 0; s < num_range; ++s )
+	    {
+		n = search_order[s];
+		d_coarse_local_search->search( 
+		    range_centroids(d_physical_dim*n,d_physical_dim),
+		    parameters,
+		    domain_neighbors );
+		d_fine_local_search->search( 
+		    domain_neighbors,
+		    range_centroids(d_physical_dim*n,d_physical_dim),
+		    parameters,
+		    range_parents[n],
+		    range_reference_coordinates[n] );
+	    }
+	}
+
+	// For each range centroid, perform a local search.
 	Teuchos::Array<Entity> domain_parents;
 	Teuchos::Array<double> reference_coordinates;
 	Teuchos::Array<double> local_coords( d_physical_dim );
 	int num_parents = 0;
-	for ( int n = 0; n < num_range; ++n )
+	for ( n = 0; n < num_range; ++n )
 	{
-	    // Perform a coarse local search to get the nearest domain
-	    // entities to the point.
-	    d_coarse_local_search->search( 
-		range_centroids(d_physical_dim*n,d_physical_dim),
-		parameters,
-		domain_neighbors );
+	    if ( reorder )
+	    {
+		domain_parents.swap( range_parents[n] );
+		reference_coordinates.swap( range_reference_coordinates[n] );
+	    }
+	    else
+	    {
+		// Perform a coarse local search to get the nearest domain
+		// entities to the point.
+		d_coarse_local_search->search( 
+		    range_centroids(d_physical_dim*n,d_physical_dim),
+		    parameters,
+		    domain_neighbors );
 	
-	    // Perform a fine local search to get the entities the point maps
-	    // to.
-	    d_fine_local_search->search( 
-		domain_neighbors,
-		range_centroids(d_physical_dim*n,d_physical_dim),
-		parameters,
-		domain_parents,
-		reference_coordinates );
+		// Perform a fine local search to get the entities the point
+		// maps to.
+		d_fine_local_search->search( 
+		    domain_neighbors,
+		    range_centroids(d_physical_dim*n,d_physical_dim),
+		    parameters,
+		    domain_parents,
+		    reference_coordinates );
+	    }
 
 	    // Store the potentially multiple parametric realizations of the
 	    // point.
@@ -95,6 +95,15 @@ TEUCHOS_UNIT_TEST( CoarseLocalSearch, coarse_local_search_test )
     TEST_EQUALITY( num_neighbors, neighbors.size() );
     TEST_EQUALITY( 4, neighbors[0].id() );
     TEST_EQUALITY( 3, neighbors[1].id() );
+
+    // Build an approximate search. All boxes are in one leaf so it finds
+    // the same neighbors.
+    plist.set<double>("Coarse Local Search Epsilon", 0.5);
+    CoarseLocalSearch approx_local_search( all_it, local_map, plist );
+    approx_local_search.search( point(), plist, neighbors );
+    TEST_EQUALITY( num_neighbors, neighbors.size() );
+    TEST_EQUALITY( 4, neighbors[0].id() );
+    TEST_EQUALITY( 3, neighbors[1].id() );
 }
 
 //---------------------------------------------------------------------------//
@@ -47,6 +47,7 @@
 #include <Teuchos_Comm.hpp>
 #include <Teuchos_ArrayView.hpp>
 #include <Teuchos_Array.hpp>
+#include <Teuchos_ParameterList.hpp>
 
 #include <Tpetra_Distributor.hpp>
 
@@ -60,6 +61,19 @@ namespace DataTransferKit
  * The CenterDistributor distributes the centers to their target
  * processes. In addition, it saves that communication plan to move source
  * field values to the same destination processes.
+ *
+ * If a number of nearest neighbors is given, the halo of each target
+ * process is sized to the largest distance from its target centers to their
+ * k-th nearest local source center (bounded by the given radius) instead of
+ * the full radius.
+ *
+ * The target processes that neighbor a source process are found by default
+ * by gathering the bounding domains of all target processes to all
+ * processes. For large numbers of processes a rendezvous may be used
+ * instead where the domains are sent only to the processes owning the cells
+ * of a coarse global grid they overlap and the neighbors are matched
+ * there. In both cases the neighbor domains are binned in a local grid so
+ * each source center is only tested against the domains in its cell.
  */
 //---------------------------------------------------------------------------//
 template<int DIM>
@@ -73,7 +87,18 @@ class CenterDistributor
 	const Teuchos::ArrayView<const double>& source_centers,
 	const Teuchos::ArrayView<const double>& target_centers,
 	const double radius,
-	Teuchos::Array<double>& target_decomp_source_centers );
+	Teuchos::Array<double>& target_decomp_source_centers,
+	const bool rendezvous = false );
+
+    // k-nearest neighbor constructor.
+    CenterDistributor(
+	const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+	const Teuchos::ArrayView<const double>& source_centers,
+	const Teuchos::ArrayView<const double>& target_centers,
+	const unsigned num_neighbors,
+	const double radius,
+	Teuchos::Array<double>& target_decomp_source_centers,
+	const bool rendezvous = false );
 
     //! Destructor.
     ~CenterDistributor()
@@ -96,8 +121,65 @@ class CenterDistributor
 	const Teuchos::ArrayView<const T>& source_decomp_data,
 	const Teuchos::ArrayView<T>& target_decomp_data ) const;
 
+    // Determine from the "Neighbor Discovery" parameter if the neighbor
+    // processes should be found with a rendezvous.
+    static bool rendezvousDiscovery( const Teuchos::ParameterList& parameters );
+
   private:
 
+    // Build the communication plan and distribute the source centers.
+    void createPlan(
+	const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+	const Teuchos::ArrayView<const double>& source_centers,
+	const Teuchos::ArrayView<const double>& target_centers,
+	const double radius,
+	const bool rendezvous,
+	Teuchos::Array<double>& target_decomp_source_centers );
+
+    // Find the neighbor target domains by gathering all target domains.
+    void gatherNeighborDomains(
+	const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+	const CloudDomain<DIM>& source_domain,
+	const CloudDomain<DIM>& target_domain,
+	Teuchos::Array<CloudDomain<DIM> >& neighbor_domains,
+	Teuchos::Array<int>& neighbor_ranks ) const;
+
+    // Find the neighbor target domains with a rendezvous.
+    void rendezvousNeighborDomains(
+	const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+	const CloudDomain<DIM>& source_domain,
+	const CloudDomain<DIM>& target_domain,
+	const bool has_sources,
+	const bool has_targets,
+	Teuchos::Array<CloudDomain<DIM> >& neighbor_domains,
+	Teuchos::Array<int>& neighbor_ranks ) const;
+
+    // Find the target processes of each source center.
+    void findExportProcs(
+	const Teuchos::ArrayView<const double>& source_centers,
+	const Teuchos::ArrayView<const CloudDomain<DIM> >& neighbor_domains,
+	const Teuchos::ArrayView<const int>& neighbor_ranks,
+	Teuchos::Array<int>& export_procs );
+
+    // Get the range of grid cells a domain overlaps.
+    static bool cellRange( const Teuchos::ArrayView<const double>& domain_bounds,
+			   const Teuchos::ArrayView<const double>& grid_bounds,
+			   const int cells_per_dim,
+			   int lo_cell[DIM],
+			   int hi_cell[DIM] );
+
+    // Get the grid cell index of a coordinate in one dimension.
+    static int cellIndex( const double x, const double lo, const double hi,
+			  const int cells_per_dim );
+
+    // Compute the halo radius of the local target centers needed to capture
+    // their k nearest source centers.
+    double nearestNeighborRadius(
+	const Teuchos::ArrayView<const double>& source_centers,
+	const Teuchos::ArrayView<const double>& target_centers,
+	const unsigned num_neighbors,
+	const double radius ) const;
+
     // Compute the domain of the local set of centers.
     CloudDomain<DIM> localCloudDomain(
 	const Teuchos::ArrayView<const double>& target_centers ) const;
@@ -42,7 +42,14 @@
 #define DTK_CENTERDISTRIBUTOR_IMPL_HPP
 
 #include <algorithm>
+#include <cmath>
 #include <limits>
+#include <utility>
+#include <vector>
+
+#include "DTK_DBC.hpp"
+#include "DTK_StaticSearchTree.hpp"
+#include "DTK_EuclideanDistance.hpp"
 
 #include <Teuchos_CommHelpers.hpp>
 #include <Teuchos_Array.hpp>
@@ -52,6 +59,9 @@ namespace DataTransferKit
 //---------------------------------------------------------------------------//
 /*!
  * \brief Constructor.
+ *
+ * \param rendezvous If true find the neighbor target processes with a
+ * rendezvous instead of gathering the domains of all target processes.
  */
 template<int DIM>
 CenterDistributor<DIM>::CenterDistributor(
@@ -59,8 +69,78 @@ CenterDistributor<DIM>::CenterDistributor(
 	const Teuchos::ArrayView<const double>& source_centers,
 	const Teuchos::ArrayView<const double>& target_centers,
 	const double radius,
-	Teuchos::Array<double>& target_decomp_source_centers )
+	Teuchos::Array<double>& target_decomp_source_centers,
+	const bool rendezvous )
+    : d_distributor( new Tpetra::Distributor(comm) )
+{
+    createPlan( comm, source_centers, target_centers, radius, rendezvous,
+		target_decomp_source_centers );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief k-nearest neighbor constructor.
+ *
+ * \param num_neighbors The number of nearest source centers each target
+ * center requires.
+ *
+ * \param radius The maximum halo radius.
+ *
+ * \param rendezvous If true find the neighbor target processes with a
+ * rendezvous instead of gathering the domains of all target processes.
+ */
+template<int DIM>
+CenterDistributor<DIM>::CenterDistributor(
+	const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+	const Teuchos::ArrayView<const double>& source_centers,
+	const Teuchos::ArrayView<const double>& target_centers,
+	const unsigned num_neighbors,
+	const double radius,
+	Teuchos::Array<double>& target_decomp_source_centers,
+	const bool rendezvous )
     : d_distributor( new Tpetra::Distributor(comm) )
+{
+    double halo_radius = nearestNeighborRadius( 
+	source_centers, target_centers, num_neighbors, radius );
+    createPlan( comm, source_centers, target_centers, halo_radius, 
+		rendezvous, target_decomp_source_centers );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Determine from the "Neighbor Discovery" parameter if the neighbor
+ * processes should be found with a rendezvous. The parameter is either "All
+ * Gather" (default) or "Rendezvous".
+ */
+template<int DIM>
+bool CenterDistributor<DIM>::rendezvousDiscovery(
+    const Teuchos::ParameterList& parameters )
+{
+    if ( parameters.isParameter("Neighbor Discovery") )
+    {
+	if ( "Rendezvous" == 
+	     parameters.get<std::string>("Neighbor Discovery") )
+	{
+	    return true;
+	}
+	DTK_INSIST( "All Gather" == 
+		    parameters.get<std::string>("Neighbor Discovery") );
+    }
+    return false;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Build the communication plan and distribute the source centers.
+ */
+template<int DIM>
+void CenterDistributor<DIM>::createPlan(
+	const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+	const Teuchos::ArrayView<const double>& source_centers,
+	const Teuchos::ArrayView<const double>& target_centers,
+	const double radius,
+	const bool rendezvous,
+	Teuchos::Array<double>& target_decomp_source_centers )
 {
     DTK_REQUIRE( 0 == source_centers.size() % DIM );
     DTK_REQUIRE( 0 == target_centers.size() % DIM );
@@ -72,51 +152,34 @@ CenterDistributor<DIM>::CenterDistributor(
 	double radius_tol = 1.0e-2;
 	double radius_expand = radius * ( 1.0 + radius_tol );
 
-	// Gather the bounding domains for each target proc.
+	// Compute the local source domain and the expanded local target
+	// domain.
 	CloudDomain<DIM> local_target_domain = 
 	    localCloudDomain( target_centers );
 	local_target_domain.expand( radius_expand );
-	Teuchos::Array<CloudDomain<DIM> > global_target_domains( 
-	    comm->getSize() );
-	Teuchos::gatherAll<int,CloudDomain<DIM> >( 
-	    *comm,
-	    1,
-	    &local_target_domain,
-	    global_target_domains.size(),
-	    global_target_domains.getRawPtr() );
-
-	// Get those that are neighbors to this source proc.
 	CloudDomain<DIM> local_source_domain = 
 	    localCloudDomain( source_centers );
+
+	// Get the target domains that are neighbors to this source proc.
 	Teuchos::Array<CloudDomain<DIM> > neighbor_target_domains;
 	Teuchos::Array<int> neighbor_ranks;
-	for ( unsigned i = 0; i < global_target_domains.size(); ++i )
+	if ( rendezvous )
 	{
-	    if ( local_source_domain.checkForIntersection(
-		     global_target_domains[i]) )
-	    {
-		neighbor_target_domains.push_back(global_target_domains[i]);
-		neighbor_ranks.push_back(i);
-	    }
+	    rendezvousNeighborDomains( 
+		comm, local_source_domain, local_target_domain,
+		0 < source_centers.size(), 0 < target_centers.size(),
+		neighbor_target_domains, neighbor_ranks );
 	}
-	global_target_domains.clear();
-
-	// Find the procs to which the sources will be sent.
-	Teuchos::ArrayView<const double> source_point;
-	for ( unsigned source_id = 0; 
-	      source_id < source_centers.size() / DIM;
-	      ++source_id )
+	else
 	{
-	    source_point = source_centers.view( DIM*source_id, DIM );
-	    for ( unsigned b = 0; b < neighbor_target_domains.size(); ++b )
-	    {
-		if ( neighbor_target_domains[b].pointInDomain(source_point) )
-		{
-		    export_procs.push_back( neighbor_ranks[b] );
-		    d_export_ids.push_back( source_id );
-		}
-	    }
+	    gatherNeighborDomains( 
+		comm, local_source_domain, local_target_domain,
+		neighbor_target_domains, neighbor_ranks );
 	}
+
+	// Find the procs to which the sources will be sent.
+	findExportProcs( source_centers, neighbor_target_domains(),
+			 neighbor_ranks(), export_procs );
     }
     DTK_CHECK( d_export_ids.size() == export_procs.size() );
     d_num_exports = d_export_ids.size();
@@ -144,6 +207,392 @@ CenterDistributor<DIM>::CenterDistributor(
 	src_coords_view, DIM, target_decomp_source_centers() );
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Find the neighbor target domains by gathering the target domains
+ * of all processes.
+ */
+template<int DIM>
+void CenterDistributor<DIM>::gatherNeighborDomains(
+    const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+    const CloudDomain<DIM>& source_domain,
+    const CloudDomain<DIM>& target_domain,
+    Teuchos::Array<CloudDomain<DIM> >& neighbor_domains,
+    Teuchos::Array<int>& neighbor_ranks ) const
+{
+    // Gather the bounding domains for each target proc.
+    Teuchos::Array<CloudDomain<DIM> > global_target_domains( 
+	comm->getSize() );
+    Teuchos::gatherAll<int,CloudDomain<DIM> >( 
+	*comm,
+	1,
+	&target_domain,
+	global_target_domains.size(),
+	global_target_domains.getRawPtr() );
+
+    // Get those that are neighbors to this source proc.
+    for ( unsigned i = 0; i < global_target_domains.size(); ++i )
+    {
+	if ( source_domain.checkForIntersection(global_target_domains[i]) )
+	{
+	    neighbor_domains.push_back( global_target_domains[i] );
+	    neighbor_ranks.push_back( i );
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Find the neighbor target domains with a rendezvous.
+ *
+ * The bounding box of all target domains is divided into a coarse grid with
+ * at most one cell per process and each cell is owned by a process. Each
+ * process sends its source domain and its target domain to the owners of
+ * the cells they overlap. The owners match the source and target domains
+ * they receive and send the intersecting target domains back to the source
+ * processes. A pair is matched only by the owner of the cell containing the
+ * lower corner of its intersection so each neighbor is found once. Only a
+ * reduction of the grid bounds is global and all other communication is
+ * between neighbors.
+ */
+template<int DIM>
+void CenterDistributor<DIM>::rendezvousNeighborDomains(
+    const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+    const CloudDomain<DIM>& source_domain,
+    const CloudDomain<DIM>& target_domain,
+    const bool has_sources,
+    const bool has_targets,
+    Teuchos::Array<CloudDomain<DIM> >& neighbor_domains,
+    Teuchos::Array<int>& neighbor_ranks ) const
+{
+    int comm_rank = comm->getRank();
+    int comm_size = comm->getSize();
+
+    // Compute the bounding box of all target domains.
+    Teuchos::ArrayView<const double> target_bounds = target_domain.bounds();
+    double local_lo[DIM];
+    double local_hi[DIM];
+    for ( int d = 0; d < DIM; ++d )
+    {
+	local_lo[d] = has_targets ? 
+		      target_bounds[2*d] : std::numeric_limits<double>::max();
+	local_hi[d] = has_targets ? 
+		      target_bounds[2*d+1] : -std::numeric_limits<double>::max();
+    }
+    double global_lo[DIM];
+    double global_hi[DIM];
+    Teuchos::reduceAll<int,double>( 
+	*comm, Teuchos::REDUCE_MIN, DIM, local_lo, global_lo );
+    Teuchos::reduceAll<int,double>( 
+	*comm, Teuchos::REDUCE_MAX, DIM, local_hi, global_hi );
+
+    // If there are no targets anywhere there are no neighbors.
+    if ( global_lo[0] > global_hi[0] )
+    {
+	return;
+    }
+
+    // Build the rendezvous grid.
+    Teuchos::Array<double> grid_bounds( 2*DIM );
+    for ( int d = 0; d < DIM; ++d )
+    {
+	grid_bounds[2*d] = global_lo[d];
+	grid_bounds[2*d+1] = global_hi[d];
+    }
+    int cells_per_dim = std::max( 
+	1, static_cast<int>(
+	    std::floor(std::pow(comm_size, 1.0/DIM) + 1.0e-8)) );
+
+    // Send the local source and target domains to the owners of the cells
+    // they overlap. Each domain is sent at most once to each owner.
+    Teuchos::Array<CloudDomain<DIM> > local_domains;
+    Teuchos::Array<int> domain_types;
+    Teuchos::Array<int> domain_owners;
+    int lo_cell[DIM];
+    int hi_cell[DIM];
+    int cell[DIM];
+    for ( int type = 0; type < 2; ++type )
+    {
+	const CloudDomain<DIM>& domain = type ? target_domain : source_domain;
+	bool has_centers = type ? has_targets : has_sources;
+	if ( has_centers && 
+	     cellRange(domain.bounds(), grid_bounds(), cells_per_dim, 
+		       lo_cell, hi_cell) )
+	{
+	    Teuchos::Array<int> owners;
+	    std::copy( lo_cell, lo_cell + DIM, cell );
+	    while ( true )
+	    {
+		int cell_id = 0;
+		for ( int d = DIM - 1; d >= 0; --d )
+		{
+		    cell_id = cell_id * cells_per_dim + cell[d];
+		}
+		owners.push_back( cell_id % comm_size );
+
+		int d = 0;
+		while ( d < DIM && ++cell[d] > hi_cell[d] )
+		{
+		    cell[d] = lo_cell[d];
+		    ++d;
+		}
+		if ( DIM == d ) break;
+	    }
+	    std::sort( owners.begin(), owners.end() );
+	    owners.erase( std::unique(owners.begin(), owners.end()),
+			  owners.end() );
+	    for ( int i = 0; i < owners.size(); ++i )
+	    {
+		local_domains.push_back( domain );
+		domain_types.push_back( type );
+		domain_owners.push_back( owners[i] );
+	    }
+	}
+    }
+    Tpetra::Distributor send_distributor( comm );
+    int num_rendezvous = send_distributor.createFromSends( domain_owners() );
+    Teuchos::Array<CloudDomain<DIM> > rendezvous_domains( num_rendezvous );
+    Teuchos::Array<int> rendezvous_types( num_rendezvous );
+    Teuchos::Array<int> rendezvous_ranks( num_rendezvous );
+    Teuchos::Array<int> local_ranks( local_domains.size(), comm_rank );
+    send_distributor.doPostsAndWaits( 
+	Teuchos::ArrayView<const CloudDomain<DIM> >(local_domains()), 
+	1, rendezvous_domains() );
+    send_distributor.doPostsAndWaits( 
+	Teuchos::ArrayView<const int>(domain_types()), 
+	1, rendezvous_types() );
+    send_distributor.doPostsAndWaits( 
+	Teuchos::ArrayView<const int>(local_ranks()), 
+	1, rendezvous_ranks() );
+
+    // Match the source and target domains received. A pair is only matched
+    // here if this process owns the cell containing the lower corner of the
+    // pair intersection.
+    Teuchos::Array<CloudDomain<DIM> > match_domains;
+    Teuchos::Array<int> match_ranks;
+    Teuchos::Array<int> match_procs;
+    for ( int s = 0; s < num_rendezvous; ++s )
+    {
+	if ( 0 != rendezvous_types[s] ) continue;
+	Teuchos::ArrayView<const double> s_bounds = 
+	    rendezvous_domains[s].bounds();
+	for ( int t = 0; t < num_rendezvous; ++t )
+	{
+	    if ( 1 != rendezvous_types[t] ||
+		 !rendezvous_domains[s].checkForIntersection(
+		     rendezvous_domains[t]) ) continue;
+	    Teuchos::ArrayView<const double> t_bounds = 
+		rendezvous_domains[t].bounds();
+	    int cell_id = 0;
+	    for ( int d = DIM - 1; d >= 0; --d )
+	    {
+		cell_id = cell_id * cells_per_dim + 
+			  cellIndex( std::max(s_bounds[2*d],t_bounds[2*d]),
+				     grid_bounds[2*d], grid_bounds[2*d+1],
+				     cells_per_dim );
+	    }
+	    if ( comm_rank == cell_id % comm_size )
+	    {
+		match_domains.push_back( rendezvous_domains[t] );
+		match_ranks.push_back( rendezvous_ranks[t] );
+		match_procs.push_back( rendezvous_ranks[s] );
+	    }
+	}
+    }
+
+    // Send the matched target domains back to the source processes.
+    Tpetra::Distributor return_distributor( comm );
+    int num_neighbors = return_distributor.createFromSends( match_procs() );
+    Teuchos::Array<CloudDomain<DIM> > imported_domains( num_neighbors );
+    Teuchos::Array<int> imported_ranks( num_neighbors );
+    return_distributor.doPostsAndWaits( 
+	Teuchos::ArrayView<const CloudDomain<DIM> >(match_domains()), 
+	1, imported_domains() );
+    return_distributor.doPostsAndWaits( 
+	Teuchos::ArrayView<const int>(match_ranks()), 
+	1, imported_ranks() );
+
+    // Order the neighbors by rank as if they had been gathered.
+    std::vector<std::pair<int,int> > rank_order( num_neighbors );
+    for ( int n = 0; n < num_neighbors; ++n )
+    {
+	rank_order[n] = std::make_pair( imported_ranks[n], n );
+    }
+    std::sort( rank_order.begin(), rank_order.end() );
+    neighbor_domains.resize( num_neighbors );
+    neighbor_ranks.resize( num_neighbors );
+    for ( int n = 0; n < num_neighbors; ++n )
+    {
+	neighbor_domains[n] = imported_domains[ rank_order[n].second ];
+	neighbor_ranks[n] = rank_order[n].first;
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Find the target processes of each source center.
+ *
+ * The neighbor domains are binned in a uniform grid over the local source
+ * domain with about one cell per neighbor such that each source center is
+ * only tested against the domains overlapping its cell. The exports of each
+ * source center are ordered by neighbor.
+ */
+template<int DIM>
+void CenterDistributor<DIM>::findExportProcs(
+    const Teuchos::ArrayView<const double>& source_centers,
+    const Teuchos::ArrayView<const CloudDomain<DIM> >& neighbor_domains,
+    const Teuchos::ArrayView<const int>& neighbor_ranks,
+    Teuchos::Array<int>& export_procs )
+{
+    DTK_REQUIRE( neighbor_domains.size() == neighbor_ranks.size() );
+
+    int num_sources = source_centers.size() / DIM;
+    int num_neighbors = neighbor_domains.size();
+    if ( 0 == num_sources || 0 == num_neighbors )
+    {
+	return;
+    }
+
+    // Build the grid over the local source domain.
+    CloudDomain<DIM> source_domain = localCloudDomain( source_centers );
+    Teuchos::ArrayView<const double> grid_bounds = source_domain.bounds();
+    int cells_per_dim = std::max( 
+	1, static_cast<int>(
+	    std::ceil(std::pow(num_neighbors, 1.0/DIM) - 1.0e-8)) );
+    int num_cells = 1;
+    for ( int d = 0; d < DIM; ++d )
+    {
+	num_cells *= cells_per_dim;
+    }
+
+    // Bin the neighbor domains in the cells they overlap. The first pass
+    // counts the domains in each cell and the second fills them in.
+    Teuchos::Array<int> cell_offsets( num_cells + 1, 0 );
+    Teuchos::Array<int> cell_fill;
+    Teuchos::Array<int> cell_domains;
+    int lo_cell[DIM];
+    int hi_cell[DIM];
+    int cell[DIM];
+    for ( int pass = 0; pass < 2; ++pass )
+    {
+	if ( 1 == pass )
+	{
+	    for ( int c = 0; c < num_cells; ++c )
+	    {
+		cell_offsets[c+1] += cell_offsets[c];
+	    }
+	    cell_domains.resize( cell_offsets.back() );
+	    cell_fill.assign( cell_offsets.begin(), cell_offsets.end() - 1 );
+	}
+
+	for ( int b = 0; b < num_neighbors; ++b )
+	{
+	    if ( !cellRange(neighbor_domains[b].bounds(), grid_bounds,
+			    cells_per_dim, lo_cell, hi_cell) )
+	    {
+		continue;
+	    }
+	    std::copy( lo_cell, lo_cell + DIM, cell );
+	    while ( true )
+	    {
+		int cell_id = 0;
+		for ( int d = DIM - 1; d >= 0; --d )
+		{
+		    cell_id = cell_id * cells_per_dim + cell[d];
+		}
+		if ( 0 == pass )
+		{
+		    ++cell_offsets[cell_id+1];
+		}
+		else
+		{
+		    cell_domains[ cell_fill[cell_id]++ ] = b;
+		}
+
+		int d = 0;
+		while ( d < DIM && ++cell[d] > hi_cell[d] )
+		{
+		    cell[d] = lo_cell[d];
+		    ++d;
+		}
+		if ( DIM == d ) break;
+	    }
+	}
+    }
+
+    // Test each source center against the domains in its cell.
+    Teuchos::ArrayView<const double> source_point;
+    for ( int source_id = 0; source_id < num_sources; ++source_id )
+    {
+	source_point = source_centers.view( DIM*source_id, DIM );
+	int cell_id = 0;
+	for ( int d = DIM - 1; d >= 0; --d )
+	{
+	    cell_id = cell_id * cells_per_dim + 
+		      cellIndex( source_point[d], grid_bounds[2*d],
+				 grid_bounds[2*d+1], cells_per_dim );
+	}
+	for ( int n = cell_offsets[cell_id]; n < cell_offsets[cell_id+1]; ++n )
+	{
+	    int b = cell_domains[n];
+	    if ( neighbor_domains[b].pointInDomain(source_point) )
+	    {
+		export_procs.push_back( neighbor_ranks[b] );
+		d_export_ids.push_back( source_id );
+	    }
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get the range of cells of a uniform grid a domain overlaps.
+ *
+ * \return False if the domain does not overlap the grid.
+ */
+template<int DIM>
+bool CenterDistributor<DIM>::cellRange(
+    const Teuchos::ArrayView<const double>& domain_bounds,
+    const Teuchos::ArrayView<const double>& grid_bounds,
+    const int cells_per_dim,
+    int lo_cell[DIM],
+    int hi_cell[DIM] )
+{
+    for ( int d = 0; d < DIM; ++d )
+    {
+	if ( domain_bounds[2*d] > grid_bounds[2*d+1] ||
+	     domain_bounds[2*d+1] < grid_bounds[2*d] )
+	{
+	    return false;
+	}
+	lo_cell[d] = cellIndex( domain_bounds[2*d], grid_bounds[2*d],
+				grid_bounds[2*d+1], cells_per_dim );
+	hi_cell[d] = cellIndex( domain_bounds[2*d+1], grid_bounds[2*d],
+				grid_bounds[2*d+1], cells_per_dim );
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get the grid cell index of a coordinate in one dimension. The
+ * coordinate is clamped to the grid.
+ */
+template<int DIM>
+int CenterDistributor<DIM>::cellIndex( const double x, 
+				       const double lo, 
+				       const double hi,
+				       const int cells_per_dim )
+{
+    if ( !(hi > lo) )
+    {
+	return 0;
+    }
+    int index = static_cast<int>( 
+	std::floor((x - lo) * cells_per_dim / (hi - lo)) );
+    return std::max( 0, std::min(cells_per_dim - 1, index) );
+}
+
 //---------------------------------------------------------------------------//
 /*!
  * \brief Given a set of scalar values at the given source centers in the
@@ -176,6 +625,52 @@ void CenterDistributor<DIM>::distribute(
     d_distributor->doPostsAndWaits( src_view, 1, target_decomp_data );
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Compute the halo radius of the local target centers needed to
+ * capture their k nearest source centers.
+ *
+ * The distance from a target center to its k-th nearest local source center
+ * is an upper bound on the distance to its k-th nearest global source center
+ * so a halo of the maximum of these distances over the local targets
+ * captures all of the global nearest neighbors.
+ */
+template<int DIM>
+double CenterDistributor<DIM>::nearestNeighborRadius(
+    const Teuchos::ArrayView<const double>& source_centers,
+    const Teuchos::ArrayView<const double>& target_centers,
+    const unsigned num_neighbors,
+    const double radius ) const
+{
+    DTK_REQUIRE( 0 < num_neighbors );
+
+    // If there are not enough local sources we need the full radius.
+    unsigned num_sources = source_centers.size() / DIM;
+    unsigned num_targets = target_centers.size() / DIM;
+    if ( num_sources < num_neighbors || 0 == num_targets )
+    {
+	return radius;
+    }
+
+    // Find the furthest k-th nearest local source. The neighbors of each
+    // target are sorted by distance so the k-th is the last one.
+    unsigned leaf_size = 30;
+    NanoflannTree<DIM> tree( source_centers, leaf_size );
+    Teuchos::Array<std::size_t> offsets;
+    Teuchos::Array<unsigned> neighbors;
+    Teuchos::Array<double> neighbor_dists;
+    tree.nnSearchBatch( target_centers, num_neighbors, offsets, neighbors,
+			Teuchos::ptrFromRef(neighbor_dists) );
+    double halo_radius = 0.0;
+    for ( unsigned t = 0; t < num_targets; ++t )
+    {
+	halo_radius = 
+	    std::max( halo_radius, neighbor_dists[offsets[t+1]-1] );
+    }
+
+    return std::min( halo_radius, radius );
+}
+
 //---------------------------------------------------------------------------//
 /*!
  * \brief Compute the bounding domain of the local set of centers.
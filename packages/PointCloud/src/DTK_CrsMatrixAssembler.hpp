@@ -0,0 +1,115 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_CrsMatrixAssembler.hpp
+ * \author Stuart R. Slattery
+ * \brief  Single pass construction of matrices from compressed row buffers.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef DTK_CRSMATRIXASSEMBLER_HPP
+#define DTK_CRSMATRIXASSEMBLER_HPP
+
+#include <utility>
+
+#include <Teuchos_RCP.hpp>
+#include <Teuchos_ArrayView.hpp>
+
+#include <Tpetra_Map.hpp>
+#include <Tpetra_CrsMatrix.hpp>
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \class CrsMatrixAssembler
+ * \brief Build a matrix in one call from a compressed row buffer.
+ *
+ * The buffer holds segments of entries with one offset per segment. Each
+ * segment belongs to a row of the matrix and a row may receive several
+ * segments. Entries in the same row and column are summed. Columns are local
+ * ids into a set of column global ids that must be unique on each process.
+ *
+ * The segments are gathered by row and each row is sorted and merged in
+ * parallel. The matrix is then constructed with a static graph in the column
+ * map, so no rows are inserted one at a time and no storage beyond the
+ * entries is allocated. The range map of the matrix is its row map.
+ */
+//---------------------------------------------------------------------------//
+template<class Scalar,class GO>
+class CrsMatrixAssembler
+{
+  public:
+
+    //@{
+    //! Type aliases.
+    typedef Tpetra::Map<int,GO> Map;
+    typedef Tpetra::CrsMatrix<Scalar,int,GO> Matrix;
+    //@}
+
+    // Build a matrix from a compressed row buffer.
+    static Teuchos::RCP<Matrix> assemble(
+	const Teuchos::RCP<const Map>& row_map,
+	const Teuchos::RCP<const Map>& domain_map,
+	const Teuchos::ArrayView<const GO>& column_gids,
+	const Teuchos::ArrayView<const GO>& segment_rows,
+	const Teuchos::ArrayView<const std::size_t>& segment_offsets,
+	const Teuchos::ArrayView<const int>& segment_columns,
+	const Teuchos::ArrayView<const Scalar>& segment_values );
+
+  private:
+
+    // Order row entries by column.
+    static bool columnLess( const std::pair<int,Scalar>& a,
+			    const std::pair<int,Scalar>& b )
+    { return a.first < b.first; }
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+// Template includes.
+//---------------------------------------------------------------------------//
+
+#include "DTK_CrsMatrixAssembler_impl.hpp"
+
+//---------------------------------------------------------------------------//
+
+#endif // end DTK_CRSMATRIXASSEMBLER_HPP
+
+//---------------------------------------------------------------------------//
+// end DTK_CrsMatrixAssembler.hpp
+//---------------------------------------------------------------------------//
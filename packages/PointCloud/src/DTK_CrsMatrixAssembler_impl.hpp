@@ -0,0 +1,233 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_CrsMatrixAssembler_impl.hpp
+ * \author Stuart R. Slattery
+ * \brief  Single pass construction of matrices from compressed row buffers.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef DTK_CRSMATRIXASSEMBLER_IMPL_HPP
+#define DTK_CRSMATRIXASSEMBLER_IMPL_HPP
+
+#include <algorithm>
+#include <vector>
+
+#include "DTK_DBC.hpp"
+
+#include <Teuchos_as.hpp>
+#include <Teuchos_Array.hpp>
+#include <Teuchos_ArrayRCP.hpp>
+#include <Teuchos_OrdinalTraits.hpp>
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Build a matrix from a compressed row buffer.
+ *
+ * \param row_map The row map of the matrix. It is also the range map.
+ *
+ * \param domain_map The domain map of the matrix.
+ *
+ * \param column_gids The global ids of the local columns. They must be
+ * unique on this process.
+ *
+ * \param segment_rows The global row id of each segment. Each must be in the
+ * row map.
+ *
+ * \param segment_offsets The offset of each segment into the columns and
+ * values. Its size is the number of segments plus one.
+ *
+ * \param segment_columns The local column id of each entry.
+ *
+ * \param segment_values The value of each entry.
+ *
+ * \return The fill complete matrix.
+ */
+template<class Scalar,class GO>
+Teuchos::RCP<typename CrsMatrixAssembler<Scalar,GO>::Matrix>
+CrsMatrixAssembler<Scalar,GO>::assemble(
+    const Teuchos::RCP<const Map>& row_map,
+    const Teuchos::RCP<const Map>& domain_map,
+    const Teuchos::ArrayView<const GO>& column_gids,
+    const Teuchos::ArrayView<const GO>& segment_rows,
+    const Teuchos::ArrayView<const std::size_t>& segment_offsets,
+    const Teuchos::ArrayView<const int>& segment_columns,
+    const Teuchos::ArrayView<const Scalar>& segment_values )
+{
+    DTK_REQUIRE( segment_rows.size() + 1 == segment_offsets.size() );
+    DTK_REQUIRE( segment_columns.size() == segment_values.size() );
+    DTK_REQUIRE( Teuchos::as<std::size_t>(segment_columns.size()) ==
+		 segment_offsets.back() );
+
+    // Build the column map.
+    Teuchos::RCP<const Map> col_map =
+	Tpetra::createNonContigMap<int,GO>( column_gids, row_map->getComm() );
+
+    // Count the entries of each row.
+    int num_rows = row_map->getNodeNumElements();
+    int num_segments = segment_rows.size();
+    Teuchos::Array<int> segment_lids( num_segments );
+    Teuchos::ArrayRCP<std::size_t> row_offsets( num_rows + 1, 0 );
+    for ( int s = 0; s < num_segments; ++s )
+    {
+	segment_lids[s] = row_map->getLocalElement( segment_rows[s] );
+	DTK_CHECK( Teuchos::OrdinalTraits<int>::invalid() != 
+		   segment_lids[s] );
+	row_offsets[ segment_lids[s] + 1 ] += 
+	    segment_offsets[s+1] - segment_offsets[s];
+    }
+    for ( int r = 0; r < num_rows; ++r )
+    {
+	row_offsets[r+1] += row_offsets[r];
+    }
+
+    // Find where each segment goes in its row.
+    Teuchos::Array<std::size_t> segment_dest( num_segments );
+    Teuchos::Array<std::size_t> row_fill( row_offsets.begin(), 
+					  row_offsets.end() - 1 );
+    for ( int s = 0; s < num_segments; ++s )
+    {
+	segment_dest[s] = row_fill[ segment_lids[s] ];
+	row_fill[ segment_lids[s] ] += 
+	    segment_offsets[s+1] - segment_offsets[s];
+    }
+
+    // Gather the segments by row.
+    std::size_t num_entries = row_offsets[num_rows];
+    Teuchos::ArrayRCP<int> columns( num_entries );
+    Teuchos::ArrayRCP<Scalar> values( num_entries );
+    const std::size_t* src_offsets_ptr = segment_offsets.getRawPtr();
+    const std::size_t* dest_ptr = segment_dest.getRawPtr();
+    const int* src_columns_ptr = segment_columns.getRawPtr();
+    const Scalar* src_values_ptr = segment_values.getRawPtr();
+    int* columns_ptr = columns.getRawPtr();
+    Scalar* values_ptr = values.getRawPtr();
+#if HAVE_DTK_OPENMP
+#pragma omp parallel for schedule(dynamic,64)
+#endif
+    for ( int s = 0; s < num_segments; ++s )
+    {
+	std::size_t src = src_offsets_ptr[s];
+	std::size_t n = src_offsets_ptr[s+1] - src;
+	std::copy( src_columns_ptr + src, src_columns_ptr + src + n,
+		   columns_ptr + dest_ptr[s] );
+	std::copy( src_values_ptr + src, src_values_ptr + src + n,
+		   values_ptr + dest_ptr[s] );
+    }
+
+    // Sort each row by column and sum the entries with the same column.
+    Teuchos::Array<std::size_t> row_sizes( num_rows );
+    const std::size_t* row_offsets_ptr = row_offsets.getRawPtr();
+    std::size_t* row_sizes_ptr = row_sizes.getRawPtr();
+#if HAVE_DTK_OPENMP
+#pragma omp parallel for schedule(dynamic,64)
+#endif
+    for ( int r = 0; r < num_rows; ++r )
+    {
+	std::size_t begin = row_offsets_ptr[r];
+	int n = row_offsets_ptr[r+1] - begin;
+	std::vector<std::pair<int,Scalar> > entries( n );
+	for ( int j = 0; j < n; ++j )
+	{
+	    entries[j] = std::make_pair( columns_ptr[begin+j], 
+					 values_ptr[begin+j] );
+	}
+	std::sort( entries.begin(), entries.end(), columnLess );
+	int m = 0;
+	for ( int j = 0; j < n; ++j )
+	{
+	    if ( 0 < m && columns_ptr[begin+m-1] == entries[j].first )
+	    {
+		values_ptr[begin+m-1] += entries[j].second;
+	    }
+	    else
+	    {
+		columns_ptr[begin+m] = entries[j].first;
+		values_ptr[begin+m] = entries[j].second;
+		++m;
+	    }
+	}
+	row_sizes_ptr[r] = m;
+    }
+
+    // Remove the space of the merged entries.
+    Teuchos::ArrayRCP<std::size_t> merged_offsets( num_rows + 1, 0 );
+    for ( int r = 0; r < num_rows; ++r )
+    {
+	merged_offsets[r+1] = merged_offsets[r] + row_sizes[r];
+    }
+    if ( merged_offsets[num_rows] < num_entries )
+    {
+	Teuchos::ArrayRCP<int> merged_columns( merged_offsets[num_rows] );
+	Teuchos::ArrayRCP<Scalar> merged_values( merged_offsets[num_rows] );
+	const std::size_t* merged_offsets_ptr = merged_offsets.getRawPtr();
+	int* merged_columns_ptr = merged_columns.getRawPtr();
+	Scalar* merged_values_ptr = merged_values.getRawPtr();
+#if HAVE_DTK_OPENMP
+#pragma omp parallel for schedule(dynamic,64)
+#endif
+	for ( int r = 0; r < num_rows; ++r )
+	{
+	    std::size_t src = row_offsets_ptr[r];
+	    std::size_t n = row_sizes_ptr[r];
+	    std::copy( columns_ptr + src, columns_ptr + src + n,
+		       merged_columns_ptr + merged_offsets_ptr[r] );
+	    std::copy( values_ptr + src, values_ptr + src + n,
+		       merged_values_ptr + merged_offsets_ptr[r] );
+	}
+	columns = merged_columns;
+	values = merged_values;
+    }
+
+    // Construct the matrix from the rows.
+    Teuchos::RCP<Matrix> matrix = Teuchos::rcp( 
+	new Matrix(row_map, col_map, merged_offsets, columns, values) );
+    matrix->expertStaticFillComplete( domain_map, row_map );
+    DTK_ENSURE( matrix->isFillComplete() );
+    return matrix;
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+
+#endif // end DTK_CRSMATRIXASSEMBLER_IMPL_HPP
+
+//---------------------------------------------------------------------------//
+// end DTK_CrsMatrixAssembler_impl.hpp
+//---------------------------------------------------------------------------//
@@ -42,6 +42,7 @@
 #define DTK_LOCALMLSPROBLEM_HPP
 
 #include "DTK_RadialBasisPolicy.hpp"
+#include "DTK_PolynomialBasis.hpp"
 
 #include <Teuchos_ArrayView.hpp>
 #include <Teuchos_Array.hpp>
@@ -51,11 +52,14 @@ namespace DataTransferKit
 //---------------------------------------------------------------------------//
 /*!
  * \class LocalMLSProblem
- * \brief Local moving least square problem about a single target center using
- * quadratic polynomials.
+ * \brief Local moving least square problem about a single target center.
+ *
+ * The polynomial basis is a compile-time policy (ConstantPolynomialBasis,
+ * LinearPolynomialBasis, or QuadraticPolynomialBasis) such that the size of
+ * the local normal equations is fixed at compile time.
  */
 //---------------------------------------------------------------------------//
-template<class Basis,int DIM>
+template<class Basis,int DIM,class Polynomial = QuadraticPolynomialBasis<DIM> >
 class LocalMLSProblem
 {
   public:
@@ -65,6 +69,12 @@ class LocalMLSProblem
     typedef RadialBasisPolicy<Basis> BP;
     //@}
 
+    static_assert( DIM == Polynomial::dim,
+		   "The polynomial basis must have the problem dimension" );
+
+    //! Size of the polynomial basis.
+    static const int poly_size = Polynomial::size;
+
     // Default constructor.
     LocalMLSProblem()
     { /* ... */ }
@@ -75,6 +85,14 @@ class LocalMLSProblem
 		     const Teuchos::ArrayView<const double>& source_centers,
 		     const Basis& basis );
 
+    // Raw pointer constructor. Does not create any views of the given data
+    // so it may be used from several threads at once.
+    LocalMLSProblem( const double* target_center,
+		     const unsigned* source_lids,
+		     const int num_sources,
+		     const double* source_centers,
+		     const Basis& basis );
+
     //! Destructor.
     ~LocalMLSProblem()
     { /* ... */ }
@@ -83,6 +101,14 @@ class LocalMLSProblem
     Teuchos::ArrayView<const double> shapeFunction() const
     { return d_shape_function(); }
 
+  private:
+
+    // Compute the shape function.
+    void computeShapeFunction( const double* target_center,
+			       const unsigned* source_lids,
+			       const double* source_centers,
+			       const Basis& basis );
+
   private:
 
     // Moving least square shape function.
@@ -42,13 +42,13 @@
 #define DTK_LOCALMLSPROBLEM_IMPL_HPP
 
 #include <limits>
+#include <algorithm>
+#include <numeric>
 
+#include "DTK_DBC.hpp"
 #include "DTK_RadialBasisPolicy.hpp"
 #include "DTK_EuclideanDistance.hpp"
 
-#include <Teuchos_SerialDenseMatrix.hpp>
-#include <Teuchos_SerialDenseVector.hpp>
-#include <Teuchos_SerialDenseSolver.hpp>
 #include <Teuchos_LAPACK.hpp>
 
 namespace DataTransferKit
@@ -57,8 +57,8 @@ namespace DataTransferKit
 /*!
  * \brief Constructor.
  */
-template<class Basis,int DIM>
-LocalMLSProblem<Basis,DIM>::LocalMLSProblem( 
+template<class Basis,int DIM,class Polynomial>
+LocalMLSProblem<Basis,DIM,Polynomial>::LocalMLSProblem( 
     const Teuchos::ArrayView<const double>& target_center,
     const Teuchos::ArrayView<const unsigned>& source_lids,
     const Teuchos::ArrayView<const double>& source_centers,
@@ -68,131 +68,117 @@ LocalMLSProblem<Basis,DIM>::LocalMLSProblem(
     DTK_REQUIRE( 0 == source_centers.size() % DIM );
     DTK_REQUIRE( 0 == target_center.size() % DIM );
 
+    computeShapeFunction( target_center.getRawPtr(), source_lids.getRawPtr(),
+			  source_centers.getRawPtr(), basis );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Raw pointer constructor.
+ */
+template<class Basis,int DIM,class Polynomial>
+LocalMLSProblem<Basis,DIM,Polynomial>::LocalMLSProblem( 
+    const double* target_center,
+    const unsigned* source_lids,
+    const int num_sources,
+    const double* source_centers,
+    const Basis& basis )
+    : d_shape_function( num_sources )
+{
+    computeShapeFunction( target_center, source_lids, source_centers, basis );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Compute the shape function.
+ *
+ * The basis weights form a diagonal matrix W so the moment matrix A = P^T W P
+ * is accumulated directly from the weighted rows of P. A is only poly_size x
+ * poly_size and symmetric so the shape function phi = t^T A^+ P^T W is
+ * computed by first solving A c = t for the target polynomial t and then
+ * evaluating phi_i = w_i p_i^T c for each source.
+ */
+template<class Basis,int DIM,class Polynomial>
+void LocalMLSProblem<Basis,DIM,Polynomial>::computeShapeFunction(
+    const double* target_center,
+    const unsigned* source_lids,
+    const double* source_centers,
+    const Basis& basis )
+{
     // Number of source centers supporting this target center.
-    int num_sources = source_lids.size();
-
-    // Build the matrix of basis evaluations and the P matrix.
-    int poly_size = 0;
-    if ( 1 == DIM ) poly_size = 3;
-    else if ( 2 == DIM ) poly_size = 6;
-    else if ( 3 == DIM ) poly_size = 10;
-    Teuchos::SerialDenseMatrix<int,double> P( num_sources, poly_size );
-    Teuchos::SerialDenseMatrix<int,double> phi( num_sources, num_sources );
-    Teuchos::ArrayView<const double> source_center_view;
-    double dist = 0.0;
+    int num_sources = d_shape_function.size();
+
+    // Build the moment matrix. The basis values are stored in the shape
+    // function until the final evaluation. Only the upper triangle of A is
+    // accumulated here. A is stored in column-major order.
+    double A[poly_size*poly_size];
+    std::fill( A, A + poly_size*poly_size, 0.0 );
+    double p[poly_size];
+    const double* source_center = 0;
+    double w = 0.0;
     for ( int i = 0; i < num_sources; ++i )
     {
-	source_center_view = source_centers(DIM*source_lids[i],DIM);
-	dist = EuclideanDistance<DIM>::distance(
-	    target_center.getRawPtr(), source_center_view.getRawPtr() );
-
-	// Basis values.
-	phi(i,i) = BP::evaluateValue( basis, dist );
-
-	// Polynomial matrix.
-	if ( 1 == DIM )
-	{
-	    P(i,0) = source_center_view[0]*source_center_view[0];
-	    P(i,1) = source_center_view[0];
-	    P(i,2) = 1.0;
-	}
-	else if ( 2 == DIM )
-	{
-	    P(i,0) = source_center_view[0]*source_center_view[0];
-	    P(i,1) = source_center_view[0]*source_center_view[1];
-	    P(i,2) = source_center_view[1]*source_center_view[1];
-	    P(i,3) = source_center_view[0];
-	    P(i,4) = source_center_view[1];
-	    P(i,5) = 1.0;
-	}
-	else if ( 3 == DIM )
+	source_center = source_centers + DIM*source_lids[i];
+	w = BP::evaluateValue( 
+	    basis, EuclideanDistance<DIM>::distance(
+		target_center, source_center) );
+	d_shape_function[i] = w;
+
+	// Sources on the edge of the support do not contribute.
+	if ( 0.0 != w )
 	{
-	    P(i,0) = source_center_view[0]*source_center_view[0];
-	    P(i,1) = source_center_view[0]*source_center_view[1];
-	    P(i,2) = source_center_view[0]*source_center_view[2];
-	    P(i,3) = source_center_view[1]*source_center_view[2];
-	    P(i,4) = source_center_view[1]*source_center_view[1];
-	    P(i,5) = source_center_view[2]*source_center_view[2];
-	    P(i,6) = source_center_view[0];
-	    P(i,7) = source_center_view[1];
-	    P(i,8) = source_center_view[2];
-	    P(i,9) = 1.0;
+	    Polynomial::evaluate( source_center, p );
+	    for ( int k = 0; k < poly_size; ++k )
+	    {
+		for ( int j = 0; j <= k; ++j )
+		{
+		    A[k*poly_size + j] += w * p[j] * p[k];
+		}
+	    }
 	}
     }
 
-    // Build the target polynomial.
-    Teuchos::SerialDenseVector<int,double> target_poly( poly_size );
-    if ( 1 == DIM )
-    {
-	target_poly(0) = target_center[0]*target_center[0];
-	target_poly(1) = target_center[0];
-	target_poly(2) = 1.0;
-    }
-    else if ( 2 == DIM )
-    {
-	target_poly(0) = target_center[0]*target_center[0];
-	target_poly(1) = target_center[0]*target_center[1];
-	target_poly(2) = target_center[1]*target_center[1];
-	target_poly(3) = target_center[0];
-	target_poly(4) = target_center[1];
-	target_poly(5) = 1.0;
-    }
-    else if ( 3 == DIM )
+    // Fill the lower triangle of A.
+    for ( int k = 0; k < poly_size; ++k )
     {
-	target_poly(0) = target_center[0]*target_center[0];
-	target_poly(1) = target_center[0]*target_center[1];
-	target_poly(2) = target_center[0]*target_center[2];
-	target_poly(3) = target_center[1]*target_center[2];
-	target_poly(4) = target_center[1]*target_center[1];
-	target_poly(5) = target_center[2]*target_center[2];
-	target_poly(6) = target_center[0];
-	target_poly(7) = target_center[1];
-	target_poly(8) = target_center[2];
-	target_poly(9) = 1.0;
+	for ( int j = k + 1; j < poly_size; ++j )
+	{
+	    A[k*poly_size + j] = A[j*poly_size + k];
+	}
     }
 
-    // Construct b.
-    Teuchos::SerialDenseMatrix<int,double> b( poly_size, num_sources );
-    b.multiply( Teuchos::TRANS, Teuchos::NO_TRANS, 1.0, P, phi, 0.0 );
-
-    // Construct the A matrix.
-    Teuchos::SerialDenseMatrix<int,double> A( poly_size, poly_size );
-    {
-	// Build A.
-	Teuchos::SerialDenseMatrix<int,double> work( num_sources, poly_size );
-	work.multiply( Teuchos::NO_TRANS, Teuchos::NO_TRANS, 1.0, phi, P, 0.0 );
-	A.multiply( Teuchos::TRANS, Teuchos::NO_TRANS, 1.0, P, work, 0.0 );
-    }
+    // Build the target polynomial.
+    double c[poly_size];
+    Polynomial::evaluate( target_center, c );
 
-    // Apply the inverse of the A matrix to b.
+    // Apply the inverse of A to the target polynomial. A may be possibly
+    // rank-deficient so solve the linear least-squares problem. The minimum
+    // workspace for a single right-hand side depends only on the polynomial
+    // size so no workspace query is needed.
     {
-	// A may be possibly rank-deficient so solve the linear least-squares
-	// problem. First get the optimal work size.
 	Teuchos::LAPACK<int,double> lapack;
 	double A_rcond = std::numeric_limits<double>::epsilon();
-	Teuchos::Array<double> work( 4 * A.numRows() );
-	Teuchos::SerialDenseVector<int,double> s( poly_size );
+	const int work_size = 5*poly_size;
+	double work[work_size];
+	double s[poly_size];
 	int rank = 0;
 	int info = 0;
-	lapack.GELSS( A.numRows(), A.numCols(), num_sources, A.values(), A.numRows(),
-		      b.values(), b.numRows(), s.values(),
-		      A_rcond, &rank, work.getRawPtr(), -1, &info );
-	DTK_CHECK( 0 == info );
-
-	// Apply the inverse of A to b.
-	work.resize( work[0] );
-	lapack.GELSS( A.numRows(), A.numCols(), num_sources, A.values(), A.numRows(),
-		      b.values(), b.numRows(), s.values(),
-		      A_rcond, &rank, work.getRawPtr(), work.size(), &info );
+	lapack.GELSS( poly_size, poly_size, 1, A, poly_size,
+		      c, poly_size, s,
+		      A_rcond, &rank, work, work_size, &info );
 	DTK_CHECK( 0 == info );
     }
 
     // Construct the basis.
-    Teuchos::SerialDenseMatrix<int,double> shape_matrix(
-	Teuchos::View, d_shape_function.getRawPtr(), 
-	1, 1, d_shape_function.size() );
-    shape_matrix.multiply( Teuchos::TRANS, Teuchos::NO_TRANS, 
-			   1.0, target_poly, b, 0.0 );
+    for ( int i = 0; i < num_sources; ++i )
+    {
+	if ( 0.0 != d_shape_function[i] )
+	{
+	    Polynomial::evaluate( source_centers + DIM*source_lids[i], p );
+	    d_shape_function[i] *= 
+		std::inner_product( p, p + poly_size, c, 0.0 );
+	}
+    }
 }
 
 //---------------------------------------------------------------------------//
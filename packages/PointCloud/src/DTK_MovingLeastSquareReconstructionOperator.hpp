@@ -43,6 +43,8 @@
 
 #include "DTK_MapOperator.hpp"
 #include "DTK_RadialBasisPolicy.hpp"
+#include "DTK_PolynomialBasis.hpp"
+#include "DTK_SplineNeighborhoodCache.hpp"
 
 #include <Teuchos_RCP.hpp>
 #include <Teuchos_Comm.hpp>
@@ -56,9 +58,24 @@ namespace DataTransferKit
  * \class MovingLeastSquareReconstructionOperator
  * \brief Parallel moving least square interpolator MapOperator
  * implementation.
+ *
+ * The polynomial basis of the local least square problems is selected at
+ * compile time. The default quadratic basis may be replaced with
+ * LinearPolynomialBasis or ConstantPolynomialBasis when quadratic accuracy is
+ * not needed.
+ *
+ * By default all source centers within the radius support a target
+ * center. Setting "Type of Search" to "Nearest Neighbor" in the setup
+ * parameters instead selects the "Num Neighbors" nearest source centers
+ * within the radius and adapts the basis radius to their distance.
+ *
+ * The source/target neighborhood may be shared with other operators over
+ * the same clouds and radius by giving each operator the same
+ * SplineNeighborhoodCache.
  */
 //---------------------------------------------------------------------------//
-template<class Scalar,class Basis,int DIM>
+template<class Scalar,class Basis,int DIM,
+	 class Polynomial = QuadraticPolynomialBasis<DIM> >
 class MovingLeastSquareReconstructionOperator : public MapOperator<Scalar>
 {
   public:
@@ -99,10 +116,20 @@ class MovingLeastSquareReconstructionOperator : public MapOperator<Scalar>
 		const Teuchos::RCP<FunctionSpace>& range_space,
 		const Teuchos::RCP<Teuchos::ParameterList>& parameters );
 
+    // Share the source/target neighborhood with other operators through a
+    // cache. Must be called before setup.
+    void setNeighborhoodCache(
+	const Teuchos::RCP<SplineNeighborhoodCache<DIM> >& cache )
+    { d_neighborhood_cache = cache; }
+
   private:
 
     // Support radius.
     double d_radius;
+
+    // Neighborhood cache shared with other operators. Null if the
+    // neighborhood is not shared.
+    Teuchos::RCP<SplineNeighborhoodCache<DIM> > d_neighborhood_cache;
 };
 
 //---------------------------------------------------------------------------//
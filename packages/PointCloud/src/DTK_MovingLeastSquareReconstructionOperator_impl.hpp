@@ -41,10 +41,12 @@
 #ifndef DTK_MOVINGLEASTSQUARERECONSTRUCTIONOPERATOR_IMPL_HPP
 #define DTK_MOVINGLEASTSQUARERECONSTRUCTIONOPERATOR_IMPL_HPP
 
+#include <algorithm>
+
 #include "DTK_DBC.hpp"
 #include "DTK_LocalMLSProblem.hpp"
-#include "DTK_CenterDistributor.hpp"
-#include "DTK_SplineInterpolationPairing.hpp"
+#include "DTK_SplineNeighborhood.hpp"
+#include "DTK_CrsMatrixAssembler.hpp"
 
 #include <Teuchos_CommHelpers.hpp>
 #include <Teuchos_Ptr.hpp>
@@ -58,21 +60,21 @@ namespace DataTransferKit
 {
 //---------------------------------------------------------------------------//
 // Constructor.
-template<class Scalar,class Basis,int DIM>
-MovingLeastSquareReconstructionOperator<Scalar,Basis,DIM>::MovingLeastSquareReconstructionOperator( const double radius )
+template<class Scalar,class Basis,int DIM,class Polynomial>
+MovingLeastSquareReconstructionOperator<Scalar,Basis,DIM,Polynomial>::MovingLeastSquareReconstructionOperator( const double radius )
     : d_radius( radius )
 { /* ... */ }
 
 //---------------------------------------------------------------------------//
 // Destructor.
-template<class Scalar,class Basis,int DIM>
-MovingLeastSquareReconstructionOperator<Scalar,Basis,DIM>::~MovingLeastSquareReconstructionOperator()
+template<class Scalar,class Basis,int DIM,class Polynomial>
+MovingLeastSquareReconstructionOperator<Scalar,Basis,DIM,Polynomial>::~MovingLeastSquareReconstructionOperator()
 { /* ... */ }
 
 //---------------------------------------------------------------------------//
 // Setup the map operator.
-template<class Scalar,class Basis,int DIM>
-void MovingLeastSquareReconstructionOperator<Scalar,Basis,DIM>::setup(
+template<class Scalar,class Basis,int DIM,class Polynomial>
+void MovingLeastSquareReconstructionOperator<Scalar,Basis,DIM,Polynomial>::setup(
     const Teuchos::RCP<const typename Base::TpetraMap>& domain_map,
     const Teuchos::RCP<FunctionSpace>& domain_space,
     const Teuchos::RCP<const typename Base::TpetraMap>& range_map,
@@ -148,68 +150,125 @@ void MovingLeastSquareReconstructionOperator<Scalar,Basis,DIM>::setup(
 	    *range_entity, target_centers(DIM*entity_counter,DIM) );
     }
 
-    // Build the basis.
-    Teuchos::RCP<Basis> basis = BP::create( d_radius );
+    // Determine the type of support. By default all source centers within
+    // the radius of a target support it. If a nearest neighbor search is
+    // used, only the k nearest source centers within the radius support a
+    // target and the basis radius is adapted to their distance.
+    bool use_knn = false;
+    unsigned num_neighbors = 0;
+    if ( parameters->isParameter("Type of Search") )
+    {
+	if ( "Nearest Neighbor" == 
+	     parameters->get<std::string>("Type of Search") )
+	{
+	    use_knn = true;
+	}
+	else
+	{
+	    DTK_INSIST( "Radius" == 
+			parameters->get<std::string>("Type of Search") );
+	}
+    }
+    if ( use_knn )
+    {
+	DTK_INSIST( parameters->isParameter("Num Neighbors") );
+	int num_neighbors_param = parameters->get<int>("Num Neighbors");
+	DTK_INSIST( 0 < num_neighbors_param );
+	num_neighbors = num_neighbors_param;
+    }
 
-    // Gather the source centers that are within a radius of the target
-    // centers on this proc.
-    Teuchos::Array<double> dist_sources;
-    CenterDistributor<DIM> distributor( 
-	comm, source_centers(), target_centers(), d_radius, dist_sources );
+    // Determine how the neighbor processes are found.
+    bool rendezvous = 
+	CenterDistributor<DIM>::rendezvousDiscovery( *parameters );
 
-    // Gather the global ids of the source centers that are within a radius of
-    // the target centers on this proc.
-    Teuchos::Array<GO> dist_source_gids( distributor.getNumImports() );
-    Teuchos::ArrayView<const GO> source_gids_view = source_gids();
-    distributor.distribute( source_gids_view, dist_source_gids() );
+    // Build the basis.
+    Teuchos::RCP<Basis> basis = BP::create( d_radius );
 
-    // Build the source/target pairings.
-    SplineInterpolationPairing<DIM> pairings( 
-	dist_sources, target_centers(), d_radius );
+    // Get the source centers that are within a radius of the target
+    // centers on this proc, their global ids and their pairings.
+    Teuchos::RCP<const SplineNeighborhood<DIM> > neighborhood;
+    if ( Teuchos::nonnull(d_neighborhood_cache) )
+    {
+	neighborhood = d_neighborhood_cache->getNeighborhood(
+	    comm, source_centers(), source_gids(), target_centers(),
+	    use_knn, num_neighbors, d_radius, rendezvous );
+    }
+    else
+    {
+	neighborhood = Teuchos::rcp( 
+	    new SplineNeighborhood<DIM>(
+		comm, source_centers(), source_gids(), target_centers(),
+		use_knn, num_neighbors, d_radius, rendezvous) );
+    }
+    const SplineInterpolationPairing<DIM>& pairings = 
+	neighborhood->pairings();
 
-    // Build the interpolation matrix.
+    // Compute the row offsets of the interpolation matrix from the number of
+    // source centers supporting each target center.
     Teuchos::ArrayRCP<std::size_t> children_per_parent =
 	pairings.childrenPerParent();
-    std::size_t max_entries_per_row = *std::max_element( 
-	children_per_parent.begin(), children_per_parent.end() );
-    Teuchos::RCP<Tpetra::CrsMatrix<Scalar,int,GO> > H = 
-	Teuchos::rcp( new Tpetra::CrsMatrix<Scalar,int,GO>( 
-			  this->b_range_map,
-			  max_entries_per_row) );
-    Teuchos::ArrayView<const Scalar> target_view;
-    Teuchos::Array<GO> indices( max_entries_per_row );
-    Teuchos::ArrayView<const Scalar> values;
-    Teuchos::ArrayView<const unsigned> pair_gids;
-    int nn = 0;
+    Teuchos::Array<std::size_t> row_offsets( local_num_tgt + 1, 0 );
+    for ( int i = 0; i < local_num_tgt; ++i )
+    {
+	row_offsets[i+1] = row_offsets[i] + children_per_parent[i];
+    }
+
+    // Build the interpolation matrix rows. The rows of each target center
+    // are independent and are written directly into their slot of the CSR
+    // buffer so they may be computed in parallel. The columns are the local
+    // ids of the distributed source centers.
+    Teuchos::Array<int> H_indices( row_offsets.back() );
+    Teuchos::Array<Scalar> H_values( row_offsets.back() );
+    const double* target_ptr = target_centers.getRawPtr();
+    const double* dist_sources_ptr = 
+	neighborhood->distributedSourceCenters().getRawPtr();
+    const unsigned* child_ids_ptr = pairings.rawChildCenterIds();
+    const std::size_t* child_offsets_ptr = pairings.rawChildCenterOffsets();
+    const std::size_t* row_offsets_ptr = row_offsets.getRawPtr();
+    int* indices_ptr = H_indices.getRawPtr();
+    Scalar* values_ptr = H_values.getRawPtr();
+#if HAVE_DTK_OPENMP
+#pragma omp parallel for schedule(dynamic,64)
+#endif
     for ( int i = 0; i < local_num_tgt; ++i )
     {
 	// If there is no support for this target center then do not build a
 	// local basis.
-	if ( 0 < pairings.childCenterIds(i).size() )
+	int num_pairs = child_offsets_ptr[i+1] - child_offsets_ptr[i];
+	if ( 0 < num_pairs )
 	{
-	    // Get a view of this target center.
-	    target_view = target_centers(i*DIM,DIM);
-
 	    // Build the local interpolation problem. 
-	    LocalMLSProblem<Basis,DIM> local_problem(
-		target_view, pairings.childCenterIds(i),
-		dist_sources, *basis );
-
-	    // Get MLS shape function values for this target point.
-	    values = local_problem.shapeFunction();
-	    nn = values.size();
-
-	    // Populate the interpolation matrix row.
-	    pair_gids = pairings.childCenterIds(i);
+	    const unsigned* pair_gids = child_ids_ptr + child_offsets_ptr[i];
+	    Teuchos::RCP<Basis> adapted_basis;
+	    if ( use_knn )
+	    {
+		adapted_basis = BP::create( pairings.parentSupportRadius(i) );
+	    }
+	    const Basis& local_basis = use_knn ? *adapted_basis : *basis;
+	    LocalMLSProblem<Basis,DIM,Polynomial> local_problem(
+		target_ptr + i*DIM, pair_gids, num_pairs, dist_sources_ptr,
+		local_basis );
+
+	    // Get MLS shape function values for this target point and
+	    // populate the interpolation matrix row.
+	    Teuchos::ArrayView<const double> values = 
+		local_problem.shapeFunction();
+	    int nn = values.size();
+	    std::size_t offset = row_offsets_ptr[i];
 	    for ( int j = 0; j < nn; ++j )
 	    {
-		indices[j] = dist_source_gids[ pair_gids[j] ];
+		indices_ptr[offset+j] = pair_gids[j];
+		values_ptr[offset+j] = values[j];
 	    }
-	    H->insertGlobalValues( target_gids[i], indices(0,nn), values );
 	}
     }
-    H->fillComplete( this->b_domain_map, this->b_range_map );
-    DTK_ENSURE( H->isFillComplete() );
+
+    // Build the interpolation matrix from the CSR buffer.
+    Teuchos::RCP<Tpetra::CrsMatrix<Scalar,int,GO> > H = 
+	CrsMatrixAssembler<Scalar,GO>::assemble( 
+	    this->b_range_map, this->b_domain_map,
+	    neighborhood->distributedSourceGids(), target_gids(),
+	    row_offsets(), H_indices(), H_values() );
     
     // Wrap the interpolation matrix in a Thyra wrapper.
     Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > thyra_range_vector_space =
@@ -0,0 +1,152 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_MultilevelCorrectionOperator.hpp
+ * \author Stuart R. Slattery
+ * \brief  Multilevel residual correction operator.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef DTK_MULTILEVELCORRECTIONOPERATOR_HPP
+#define DTK_MULTILEVELCORRECTIONOPERATOR_HPP
+
+#include <Teuchos_RCP.hpp>
+#include <Teuchos_Array.hpp>
+
+#include <Thyra_LinearOpDefaultBase.hpp>
+#include <Thyra_MultiVectorBase.hpp>
+#include <Thyra_VectorSpaceBase.hpp>
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \class MultilevelCorrectionOperator
+ * \brief Interpolation by successive correction of the residual over a
+ * sequence of levels.
+ *
+ * Each level l is defined by a coefficient operator A_l computing the
+ * interpolant coefficients of a level from the residual at the source
+ * centers, a source evaluation operator E_l evaluating the level interpolant
+ * at the source centers, and a target evaluation operator T_l evaluating it
+ * at the target centers. With r_0 = x the operator computes
+ *
+ *   y = sum_l T_l A_l r_l,  r_{l+1} = r_l - E_l A_l r_l
+ *
+ * applying each level operator once. The source evaluation operator of the
+ * last level is not needed.
+ */
+//---------------------------------------------------------------------------//
+template<class Scalar>
+class MultilevelCorrectionOperator : public Thyra::LinearOpDefaultBase<Scalar>
+{
+  public:
+
+    // Constructor.
+    MultilevelCorrectionOperator( 
+	const Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> >& range,
+	const Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> >& domain );
+
+    //! Destructor.
+    ~MultilevelCorrectionOperator()
+    { /* ... */ }
+
+    // Add the next finer level.
+    void addLevel( 
+	const Teuchos::RCP<const Thyra::LinearOpBase<Scalar> >& coefficients,
+	const Teuchos::RCP<const Thyra::LinearOpBase<Scalar> >& source_eval,
+	const Teuchos::RCP<const Thyra::LinearOpBase<Scalar> >& target_eval );
+
+    //! Get the number of levels.
+    int numLevels() const
+    { return d_coefficients.size(); }
+
+    //! Range of the operator.
+    Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > range() const
+    { return d_range; }
+
+    //! Domain of the operator.
+    Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > domain() const
+    { return d_domain; }
+
+  protected:
+
+    // Check if an operation is supported.
+    bool opSupportedImpl( Thyra::EOpTransp M_trans ) const;
+
+    // Apply the operator.
+    void applyImpl( const Thyra::EOpTransp M_trans,
+		    const Thyra::MultiVectorBase<Scalar>& X,
+		    const Teuchos::Ptr<Thyra::MultiVectorBase<Scalar> >& Y,
+		    const Scalar alpha,
+		    const Scalar beta ) const;
+
+  private:
+
+    // Range space.
+    Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > d_range;
+
+    // Domain space.
+    Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > d_domain;
+
+    // Level coefficient operators.
+    Teuchos::Array<Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > > 
+    d_coefficients;
+
+    // Level source evaluation operators.
+    Teuchos::Array<Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > > 
+    d_source_evals;
+
+    // Level target evaluation operators.
+    Teuchos::Array<Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > > 
+    d_target_evals;
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+// Template includes.
+//---------------------------------------------------------------------------//
+
+#include "DTK_MultilevelCorrectionOperator_impl.hpp"
+
+//---------------------------------------------------------------------------//
+
+#endif // end DTK_MULTILEVELCORRECTIONOPERATOR_HPP
+
+//---------------------------------------------------------------------------//
+// end DTK_MultilevelCorrectionOperator.hpp
+//---------------------------------------------------------------------------//
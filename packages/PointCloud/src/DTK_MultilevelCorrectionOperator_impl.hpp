@@ -0,0 +1,166 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_MultilevelCorrectionOperator_impl.hpp
+ * \author Stuart R. Slattery
+ * \brief  Multilevel residual correction operator.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef DTK_MULTILEVELCORRECTIONOPERATOR_IMPL_HPP
+#define DTK_MULTILEVELCORRECTIONOPERATOR_IMPL_HPP
+
+#include "DTK_DBC.hpp"
+
+#include <Thyra_MultiVectorStdOps.hpp>
+#include <Thyra_LinearOpBase.hpp>
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Constructor.
+ */
+template<class Scalar>
+MultilevelCorrectionOperator<Scalar>::MultilevelCorrectionOperator(
+    const Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> >& range,
+    const Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> >& domain )
+    : d_range( range )
+    , d_domain( domain )
+{
+    DTK_REQUIRE( Teuchos::nonnull(d_range) );
+    DTK_REQUIRE( Teuchos::nonnull(d_domain) );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Add the next finer level. The source evaluation operator may be
+ * null for the last level.
+ */
+template<class Scalar>
+void MultilevelCorrectionOperator<Scalar>::addLevel(
+    const Teuchos::RCP<const Thyra::LinearOpBase<Scalar> >& coefficients,
+    const Teuchos::RCP<const Thyra::LinearOpBase<Scalar> >& source_eval,
+    const Teuchos::RCP<const Thyra::LinearOpBase<Scalar> >& target_eval )
+{
+    DTK_REQUIRE( Teuchos::nonnull(coefficients) );
+    DTK_REQUIRE( Teuchos::nonnull(target_eval) );
+    DTK_REQUIRE( coefficients->domain()->isCompatible(*d_domain) );
+    DTK_REQUIRE( target_eval->range()->isCompatible(*d_range) );
+
+    d_coefficients.push_back( coefficients );
+    d_source_evals.push_back( source_eval );
+    d_target_evals.push_back( target_eval );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Check if an operation is supported.
+ */
+template<class Scalar>
+bool MultilevelCorrectionOperator<Scalar>::opSupportedImpl( 
+    Thyra::EOpTransp M_trans ) const
+{
+    return Thyra::NOTRANS == M_trans;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Apply the operator.
+ */
+template<class Scalar>
+void MultilevelCorrectionOperator<Scalar>::applyImpl( 
+    const Thyra::EOpTransp M_trans,
+    const Thyra::MultiVectorBase<Scalar>& X,
+    const Teuchos::Ptr<Thyra::MultiVectorBase<Scalar> >& Y,
+    const Scalar alpha,
+    const Scalar beta ) const
+{
+    DTK_REQUIRE( Thyra::NOTRANS == M_trans );
+    DTK_REQUIRE( X.domain()->dim() == Y->domain()->dim() );
+    DTK_REQUIRE( 0 < d_coefficients.size() );
+
+    // Y = beta*Y
+    if ( Teuchos::ScalarTraits<Scalar>::zero() == beta )
+    {
+	Thyra::assign( Y, Teuchos::ScalarTraits<Scalar>::zero() );
+    }
+    else
+    {
+	Thyra::scale( beta, Y );
+    }
+
+    // Initialize the residual with the source values.
+    int num_vec = X.domain()->dim();
+    Teuchos::RCP<Thyra::MultiVectorBase<Scalar> > residual =
+	Thyra::createMembers( d_domain, num_vec );
+    Thyra::assign( residual.ptr(), X );
+
+    // Accumulate the interpolant of the residual on each level and correct
+    // the residual for the next level.
+    int num_levels = d_coefficients.size();
+    Teuchos::RCP<Thyra::MultiVectorBase<Scalar> > coeffs;
+    for ( int l = 0; l < num_levels; ++l )
+    {
+	coeffs = Thyra::createMembers( d_coefficients[l]->range(), num_vec );
+	Thyra::apply( *d_coefficients[l], Thyra::NOTRANS, 
+		      *residual, coeffs.ptr() );
+
+	// Y += alpha*T_l*c_l
+	Thyra::apply( *d_target_evals[l], Thyra::NOTRANS, *coeffs, Y, 
+		      alpha, Teuchos::ScalarTraits<Scalar>::one() );
+
+	// r_{l+1} = r_l - E_l*c_l
+	if ( l < num_levels - 1 )
+	{
+	    DTK_CHECK( Teuchos::nonnull(d_source_evals[l]) );
+	    Thyra::apply( *d_source_evals[l], Thyra::NOTRANS, *coeffs, 
+			  residual.ptr(), 
+			  -Teuchos::ScalarTraits<Scalar>::one(), 
+			  Teuchos::ScalarTraits<Scalar>::one() );
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+
+#endif // end DTK_MULTILEVELCORRECTIONOPERATOR_IMPL_HPP
+
+//---------------------------------------------------------------------------//
+// end DTK_MultilevelCorrectionOperator_impl.hpp
+//---------------------------------------------------------------------------//
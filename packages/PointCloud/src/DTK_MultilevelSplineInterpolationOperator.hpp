@@ -0,0 +1,167 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_MultilevelSplineInterpolationOperator.hpp
+ * \author Stuart R. Slattery
+ * \brief  Multilevel compactly supported spline interpolation operator.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef DTK_MULTILEVELSPLINEINTERPOLATIONOPERATOR_HPP
+#define DTK_MULTILEVELSPLINEINTERPOLATIONOPERATOR_HPP
+
+#include "DTK_MapOperator.hpp"
+#include "DTK_RadialBasisPolicy.hpp"
+
+#include <Teuchos_RCP.hpp>
+#include <Teuchos_Comm.hpp>
+#include <Teuchos_ArrayView.hpp>
+#include <Teuchos_Array.hpp>
+
+#include <Tpetra_Map.hpp>
+#include <Tpetra_CrsMatrix.hpp>
+
+#include <Thyra_LinearOpBase.hpp>
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \class MultilevelSplineInterpolationOperator
+ * \brief Parallel multilevel compactly supported spline interpolator.
+ *
+ * The source centers are subsampled into a nested sequence of levels. The
+ * field is interpolated on the coarsest level with a large support radius
+ * and the residual at the source centers is then interpolated on each finer
+ * level with a smaller radius. The finest level contains all source centers
+ * and uses the given radius. Each coarser level keeps 1/2^DIM of the centers
+ * of the next finer level and doubles the radius so every level system has
+ * about the same number of entries per row and the setup and application
+ * scale with the number of source centers.
+ *
+ * The number of levels is set with "Number of Levels" in the setup
+ * parameters and defaults to 3. The level systems are symmetric positive
+ * definite and are solved with the solver given by the "Stratimikos"
+ * sublist, by default the Belos "Pseudo Block CG" solver.
+ *
+ * The subsample is selected by hashing the global ids of the source centers
+ * so it is independent of the parallel decomposition and needs no
+ * communication.
+ */
+//---------------------------------------------------------------------------//
+template<class Scalar,class Basis,int DIM>
+class MultilevelSplineInterpolationOperator : public MapOperator<Scalar>
+{
+  public:
+
+    //@{
+    //! Typedefs.
+    typedef MapOperator<Scalar> Base;
+    typedef typename Base::Root Root;
+    typedef typename Root::local_ordinal_type LO;
+    typedef typename Root::global_ordinal_type GO;
+    typedef RadialBasisPolicy<Basis> BP;
+    //@}
+
+    // Constructor.
+    MultilevelSplineInterpolationOperator( const double radius );
+
+    //! Destructor.
+    ~MultilevelSplineInterpolationOperator();
+
+    /*
+     * \brief Setup the map operator from a domain entity set and a range
+     * entity set.
+     * \param domain_map Parallel map for domain vectors this map should be
+     * compatible with.
+     * \param domain_function The function that contains the data that will be
+     * sent to the range. Must always be nonnull but the pointers it contains
+     * may be null of no entities are on-process.
+     * \param range_map Parallel map for range vectors this map should be
+     * compatible with.
+     * \param range_space The function that will receive the data from the
+     * domain. Must always be nonnull but the pointers it contains to entity
+     * data may be null of no entities are on-process.
+     * \param parameters Parameters for the setup.
+     */
+    void setup( const Teuchos::RCP<const typename Base::TpetraMap>& domain_map,
+		const Teuchos::RCP<FunctionSpace>& domain_space,
+		const Teuchos::RCP<const typename Base::TpetraMap>& range_map,
+		const Teuchos::RCP<FunctionSpace>& range_space,
+		const Teuchos::RCP<Teuchos::ParameterList>& parameters );
+
+    // Get the coarsest level a source center with the given global id is
+    // on.
+    static int sourceLevel( const GO gid, const int num_levels );
+
+  private:
+
+    // Build the basis matrix of a level evaluated at a set of row centers.
+    Teuchos::RCP<Tpetra::CrsMatrix<Scalar,int,GO> > buildBasisMatrix(
+	const Teuchos::RCP<const Tpetra::Map<int,GO> >& level_map,
+	const Teuchos::ArrayView<const double>& level_centers,
+	const Teuchos::ArrayView<const GO>& level_gids,
+	const Teuchos::RCP<const Tpetra::Map<int,GO> >& row_map,
+	const Teuchos::ArrayView<const double>& row_centers,
+	const Teuchos::ArrayView<const GO>& row_gids,
+	const double radius,
+	const bool rendezvous ) const;
+
+    // Wrap a Tpetra operator in a Thyra operator.
+    Teuchos::RCP<const Thyra::LinearOpBase<Scalar> >
+    createThyraOperator( const Teuchos::RCP<const Root>& op ) const;
+
+  private:
+
+    // Support radius of the finest level.
+    double d_radius;
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+// Template includes.
+//---------------------------------------------------------------------------//
+
+#include "DTK_MultilevelSplineInterpolationOperator_impl.hpp"
+
+//---------------------------------------------------------------------------//
+
+#endif // end DTK_MULTILEVELSPLINEINTERPOLATIONOPERATOR_HPP
+
+//---------------------------------------------------------------------------//
+// end DTK_MultilevelSplineInterpolationOperator.hpp
+//---------------------------------------------------------------------------//
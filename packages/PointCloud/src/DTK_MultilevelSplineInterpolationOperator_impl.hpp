@@ -0,0 +1,435 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_MultilevelSplineInterpolationOperator_impl.hpp
+ * \author Stuart R. Slattery
+ * \brief  Multilevel compactly supported spline interpolation operator.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef DTK_MULTILEVELSPLINEINTERPOLATIONOPERATOR_IMPL_HPP
+#define DTK_MULTILEVELSPLINEINTERPOLATIONOPERATOR_IMPL_HPP
+
+#include <algorithm>
+#include <cmath>
+
+#include "DTK_DBC.hpp"
+#include "DTK_CenterDistributor.hpp"
+#include "DTK_SplineInterpolationPairing.hpp"
+#include "DTK_EuclideanDistance.hpp"
+#include "DTK_MultilevelCorrectionOperator.hpp"
+#include "DTK_CrsMatrixAssembler.hpp"
+
+#include <Teuchos_ArrayRCP.hpp>
+#include <Teuchos_ParameterList.hpp>
+
+#include <Thyra_TpetraThyraWrappers.hpp>
+#include <Thyra_DefaultMultipliedLinearOp.hpp>
+#include <Thyra_LinearOpWithSolveFactoryHelpers.hpp>
+
+#include <Stratimikos_DefaultLinearSolverBuilder.hpp>
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+// Constructor.
+template<class Scalar,class Basis,int DIM>
+MultilevelSplineInterpolationOperator<Scalar,Basis,DIM>::MultilevelSplineInterpolationOperator(
+    const double radius )
+    : d_radius( radius )
+{ /* ... */ }
+
+//---------------------------------------------------------------------------//
+// Destructor.
+template<class Scalar,class Basis,int DIM>
+MultilevelSplineInterpolationOperator<Scalar,Basis,DIM>::~MultilevelSplineInterpolationOperator()
+{ /* ... */ }
+
+//---------------------------------------------------------------------------//
+// Setup the map operator.
+template<class Scalar,class Basis,int DIM>
+void MultilevelSplineInterpolationOperator<Scalar,Basis,DIM>::setup(
+    const Teuchos::RCP<const typename Base::TpetraMap>& domain_map,
+    const Teuchos::RCP<FunctionSpace>& domain_space,
+    const Teuchos::RCP<const typename Base::TpetraMap>& range_map,
+    const Teuchos::RCP<FunctionSpace>& range_space,
+    const Teuchos::RCP<Teuchos::ParameterList>& parameters )
+{
+    DTK_REQUIRE( Teuchos::nonnull(domain_map) );
+    DTK_REQUIRE( Teuchos::nonnull(domain_space) );
+    DTK_REQUIRE( Teuchos::nonnull(range_map) );
+    DTK_REQUIRE( Teuchos::nonnull(range_space) );
+    DTK_REQUIRE( Teuchos::nonnull(parameters) );
+
+    // Get the parallel communicator.
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = domain_map->getComm();
+
+    // Determine if we have range and domain data on this process.
+    bool nonnull_domain = Teuchos::nonnull( domain_space->entitySet() );
+    bool nonnull_range = Teuchos::nonnull( range_space->entitySet() );
+
+    // Make sure we are applying the map to nodes.
+    DTK_REQUIRE( domain_space->entitySelector()->entityType() ==
+		 ENTITY_TYPE_NODE );
+    DTK_REQUIRE( range_space->entitySelector()->entityType() ==
+		 ENTITY_TYPE_NODE );
+
+    // Extract the DOF maps.
+    this->b_domain_map = domain_map;
+    this->b_range_map = range_map;
+
+    // Extract the source centers and their ids.
+    EntityIterator domain_iterator;
+    if ( nonnull_domain )
+    {
+	domain_iterator = domain_space->entitySet()->entityIterator( 
+	    domain_space->entitySelector()->entityType(),
+	    domain_space->entitySelector()->selectFunction() );
+    }
+    int local_num_src = domain_iterator.size();
+    Teuchos::ArrayRCP<double> source_centers( DIM*local_num_src);
+    Teuchos::ArrayRCP<GO> source_gids( local_num_src );
+    EntityIterator domain_begin = domain_iterator.begin();
+    EntityIterator domain_end = domain_iterator.end();
+    int entity_counter = 0;
+    for ( EntityIterator domain_entity = domain_begin;
+	  domain_entity != domain_end;
+	  ++domain_entity, ++entity_counter )
+    {
+	source_gids[entity_counter] = domain_entity->id();
+	domain_space->localMap()->centroid(
+	    *domain_entity, source_centers(DIM*entity_counter,DIM) );
+    }
+
+    // Extract the target centers and their ids.
+    EntityIterator range_iterator;
+    if ( nonnull_range )
+    {
+	range_iterator = range_space->entitySet()->entityIterator( 
+	    range_space->entitySelector()->entityType(),
+	    range_space->entitySelector()->selectFunction() );
+    } 
+    int local_num_tgt = range_iterator.size();
+    Teuchos::ArrayRCP<double> target_centers( DIM*local_num_tgt );
+    Teuchos::ArrayRCP<GO> target_gids( local_num_tgt );
+    EntityIterator range_begin = range_iterator.begin();
+    EntityIterator range_end = range_iterator.end();
+    entity_counter = 0;
+    for ( EntityIterator range_entity = range_begin;
+	  range_entity != range_end;
+	  ++range_entity, ++entity_counter )
+    {
+	target_gids[entity_counter] = range_entity->id();
+	range_space->localMap()->centroid(
+	    *range_entity, target_centers(DIM*entity_counter,DIM) );
+    }
+
+    // Get the number of levels.
+    int num_levels = 3;
+    if ( parameters->isParameter("Number of Levels") )
+    {
+	num_levels = parameters->get<int>("Number of Levels");
+    }
+    DTK_REQUIRE( 0 < num_levels );
+
+    // Determine how the neighbor processes are found.
+    bool rendezvous = 
+	CenterDistributor<DIM>::rendezvousDiscovery( *parameters );
+
+    // Assign each source center to the coarsest level it is on. The levels
+    // are nested so a center is also on all finer levels.
+    Teuchos::Array<int> source_levels( local_num_src );
+    for ( int i = 0; i < local_num_src; ++i )
+    {
+	source_levels[i] = sourceLevel( source_gids[i], num_levels );
+    }
+
+    // Build the level solver. The level systems are symmetric positive
+    // definite so conjugate gradient is used unless another solver was
+    // selected.
+    Teuchos::RCP<Teuchos::ParameterList> builder_params;
+    if ( parameters->isSublist("Stratimikos") )
+    {
+	builder_params =  
+	    Teuchos::parameterList( parameters->sublist("Stratimikos") );
+    }
+    else 
+    {
+	builder_params = Teuchos::parameterList();
+	builder_params->setName("Stratimikos");
+    }
+    if ( !builder_params->isParameter("Linear Solver Type") )
+    {
+	builder_params->set<std::string>("Linear Solver Type","Belos");
+    }
+    if ( "Belos" == builder_params->get<std::string>("Linear Solver Type") )
+    {
+	Teuchos::ParameterList& belos_params = 
+	    builder_params->sublist("Linear Solver Types").sublist("Belos");
+	if ( !belos_params.isParameter("Solver Type") )
+	{
+	    belos_params.set<std::string>("Solver Type","Pseudo Block CG");
+	}
+    }
+    Stratimikos::DefaultLinearSolverBuilder builder;
+    builder.setParameterList( builder_params );
+    Teuchos::RCP<Thyra::LinearOpWithSolveFactoryBase<Scalar> > factory = 
+	Thyra::createLinearSolveStrategy( builder );
+
+    // Create the multilevel operator.
+    Teuchos::RCP<MultilevelCorrectionOperator<Scalar> > multilevel_op =
+	Teuchos::rcp( new MultilevelCorrectionOperator<Scalar>(
+			  Thyra::createVectorSpace<Scalar>(this->b_range_map),
+			  Thyra::createVectorSpace<Scalar>(this->b_domain_map)) );
+
+    // Build the levels from coarsest to finest.
+    Teuchos::Array<double> level_centers;
+    Teuchos::Array<GO> level_gids;
+    for ( int l = 0; l < num_levels; ++l )
+    {
+	// Get the support radius of the level.
+	double level_radius = d_radius * std::pow( 2.0, num_levels - 1 - l );
+
+	// Extract the source centers on this level.
+	level_centers.clear();
+	level_gids.clear();
+	for ( int i = 0; i < local_num_src; ++i )
+	{
+	    if ( source_levels[i] <= l )
+	    {
+		level_gids.push_back( source_gids[i] );
+		for ( int d = 0; d < DIM; ++d )
+		{
+		    level_centers.push_back( source_centers[DIM*i + d] );
+		}
+	    }
+	}
+	Teuchos::RCP<const Tpetra::Map<int,GO> > level_map =
+	    Tpetra::createNonContigMap<int,GO>( level_gids(), comm );
+
+	// Build the restriction of the residual to the level centers.
+	Teuchos::RCP<Tpetra::CrsMatrix<Scalar,int,GO> > R = 
+	    Teuchos::rcp( new Tpetra::CrsMatrix<Scalar,int,GO>(level_map, 1) );
+	Teuchos::Array<Scalar> one( 1, Teuchos::ScalarTraits<Scalar>::one() );
+	for ( int i = 0; i < level_gids.size(); ++i )
+	{
+	    R->insertGlobalValues( level_gids[i], level_gids(i,1), one() );
+	}
+	R->fillComplete( this->b_domain_map, level_map );
+
+	// Build the level system and its inverse.
+	Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > thyra_M =
+	    createThyraOperator( 
+		buildBasisMatrix(level_map, level_centers(), level_gids(),
+				 level_map, level_centers(), level_gids(),
+				 level_radius, rendezvous) );
+	Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > thyra_M_inv =
+	    Thyra::inverse<Scalar>( *factory, thyra_M );
+
+	// Create the level coefficient operator A_l = M_l^-1 * R_l.
+	Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > thyra_A =
+	    Thyra::multiply<Scalar>( thyra_M_inv, createThyraOperator(R) );
+
+	// Build the evaluation of the level interpolant at the source
+	// centers. This is not needed on the finest level as there is no
+	// further correction.
+	Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > thyra_E;
+	if ( l < num_levels - 1 )
+	{
+	    thyra_E = createThyraOperator(
+		buildBasisMatrix(level_map, level_centers(), level_gids(),
+				 this->b_domain_map, source_centers(), 
+				 source_gids(), level_radius, rendezvous) );
+	}
+
+	// Build the evaluation of the level interpolant at the target
+	// centers.
+	Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > thyra_T =
+	    createThyraOperator(
+		buildBasisMatrix(level_map, level_centers(), level_gids(),
+				 this->b_range_map, target_centers(), 
+				 target_gids(), level_radius, rendezvous) );
+
+	multilevel_op->addLevel( thyra_A, thyra_E, thyra_T );
+    }
+
+    // Set the coupling matrix with the base class.
+    this->b_coupling_matrix = multilevel_op;
+    DTK_ENSURE( Teuchos::nonnull(this->b_coupling_matrix) );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get the coarsest level a source center with the given global id is
+ * on.
+ *
+ * The global id is hashed to a uniform value u in [0,1). Level l keeps the
+ * centers with u < 2^(-DIM*(L-1-l)) such that the levels are nested and the
+ * finest level keeps all centers.
+ */
+template<class Scalar,class Basis,int DIM>
+int MultilevelSplineInterpolationOperator<Scalar,Basis,DIM>::sourceLevel(
+    const GO gid, const int num_levels )
+{
+    DTK_REQUIRE( 0 < num_levels );
+
+    // Mix the bits of the global id.
+    unsigned long long z = static_cast<unsigned long long>(gid) + 
+			   0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z = z ^ (z >> 31);
+    double u = static_cast<double>(z >> 11) / 9007199254740992.0;
+
+    int level = 0;
+    while ( level < num_levels - 1 &&
+	    u >= std::pow(2.0, -DIM*(num_levels-1-level)) )
+    {
+	++level;
+    }
+    return level;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Build the basis matrix of a level evaluated at a set of row
+ * centers.
+ */
+template<class Scalar,class Basis,int DIM>
+Teuchos::RCP<Tpetra::CrsMatrix<Scalar,int,typename MultilevelSplineInterpolationOperator<Scalar,Basis,DIM>::GO> >
+MultilevelSplineInterpolationOperator<Scalar,Basis,DIM>::buildBasisMatrix(
+    const Teuchos::RCP<const Tpetra::Map<int,GO> >& level_map,
+    const Teuchos::ArrayView<const double>& level_centers,
+    const Teuchos::ArrayView<const GO>& level_gids,
+    const Teuchos::RCP<const Tpetra::Map<int,GO> >& row_map,
+    const Teuchos::ArrayView<const double>& row_centers,
+    const Teuchos::ArrayView<const GO>& row_gids,
+    const double radius,
+    const bool rendezvous ) const
+{
+    // Build the basis.
+    Teuchos::RCP<Basis> basis = BP::create( radius );
+
+    // Gather the level centers that are within a radius of the row centers
+    // on this proc.
+    Teuchos::Array<double> dist_sources;
+    CenterDistributor<DIM> distributor(
+	row_map->getComm(), level_centers, row_centers, radius, dist_sources,
+	rendezvous );
+    Teuchos::Array<GO> dist_source_gids( distributor.getNumImports() );
+    distributor.distribute( level_gids, dist_source_gids() );
+
+    // Build the level/row pairings.
+    SplineInterpolationPairing<DIM> pairings( 
+	dist_sources(), row_centers, radius );
+    Teuchos::ArrayRCP<std::size_t> children_per_parent =
+	pairings.childrenPerParent();
+
+    // Compute the row offsets.
+    int num_rows = row_gids.size();
+    Teuchos::Array<std::size_t> row_offsets( num_rows + 1, 0 );
+    for ( int i = 0; i < num_rows; ++i )
+    {
+	row_offsets[i+1] = row_offsets[i] + children_per_parent[i];
+    }
+
+    // Evaluate the basis. Each row is written directly into its slot of
+    // the CSR buffer so the rows may be computed in parallel. The columns
+    // are the local ids of the distributed level centers.
+    Teuchos::Array<int> indices( row_offsets.back() );
+    Teuchos::Array<Scalar> values( row_offsets.back() );
+    const double* row_ptr = row_centers.getRawPtr();
+    const double* source_ptr = dist_sources.getRawPtr();
+    const unsigned* child_ids_ptr = pairings.rawChildCenterIds();
+    const std::size_t* child_offsets_ptr = pairings.rawChildCenterOffsets();
+    const std::size_t* row_offsets_ptr = row_offsets.getRawPtr();
+    int* indices_ptr = indices.getRawPtr();
+    Scalar* values_ptr = values.getRawPtr();
+#if HAVE_DTK_OPENMP
+#pragma omp parallel for schedule(dynamic,64)
+#endif
+    for ( int i = 0; i < num_rows; ++i )
+    {
+	const unsigned* pair_gids = child_ids_ptr + child_offsets_ptr[i];
+	int nn = child_offsets_ptr[i+1] - child_offsets_ptr[i];
+	std::size_t offset = row_offsets_ptr[i];
+	for ( int j = 0; j < nn; ++j )
+	{
+	    indices_ptr[offset+j] = pair_gids[j];
+	    values_ptr[offset+j] = BP::evaluateValue(
+		*basis, EuclideanDistance<DIM>::distance(
+		    row_ptr + DIM*i, source_ptr + DIM*pair_gids[j]) );
+	}
+    }
+
+    // Build the matrix from the CSR buffer.
+    Teuchos::RCP<Tpetra::CrsMatrix<Scalar,int,GO> > matrix = 
+	CrsMatrixAssembler<Scalar,GO>::assemble( 
+	    row_map, level_map, dist_source_gids(), row_gids, 
+	    row_offsets(), indices(), values() );
+    return matrix;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Wrap a Tpetra operator in a Thyra operator.
+ */
+template<class Scalar,class Basis,int DIM>
+Teuchos::RCP<const Thyra::LinearOpBase<Scalar> >
+MultilevelSplineInterpolationOperator<Scalar,Basis,DIM>::createThyraOperator(
+    const Teuchos::RCP<const Root>& op ) const
+{
+    Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > thyra_range_vector_space =
+    	Thyra::createVectorSpace<Scalar>( op->getRangeMap() );
+    Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > thyra_domain_vector_space =
+    	Thyra::createVectorSpace<Scalar>( op->getDomainMap() );
+    Teuchos::RCP<const Thyra::TpetraLinearOp<Scalar,LO,GO> > thyra_op =
+    	Teuchos::rcp( new Thyra::TpetraLinearOp<Scalar,LO,GO>() );
+    Teuchos::rcp_const_cast<Thyra::TpetraLinearOp<Scalar,LO,GO> >(
+	thyra_op)->constInitialize( 
+	    thyra_range_vector_space, thyra_domain_vector_space, op );
+    return thyra_op;
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+
+#endif // end DTK_MULTILEVELSPLINEINTERPOLATIONOPERATOR_IMPL_HPP
+
+//---------------------------------------------------------------------------//
+// end DTK_MultilevelSplineInterpolationOperator_impl.hpp
+//---------------------------------------------------------------------------//
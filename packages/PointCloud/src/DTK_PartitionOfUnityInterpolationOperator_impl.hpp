@@ -0,0 +1,441 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_PartitionOfUnityInterpolationOperator_impl.hpp
+ * \author Stuart R. Slattery
+ * \brief  Partition of unity radial basis interpolation operator.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef DTK_PARTITIONOFUNITYINTERPOLATIONOPERATOR_IMPL_HPP
+#define DTK_PARTITIONOFUNITYINTERPOLATIONOPERATOR_IMPL_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <map>
+
+#include "DTK_DBC.hpp"
+#include "DTK_CenterDistributor.hpp"
+#include "DTK_SplineInterpolationPairing.hpp"
+#include "DTK_EuclideanDistance.hpp"
+#include "DTK_CrsMatrixAssembler.hpp"
+
+#include <Teuchos_ArrayRCP.hpp>
+#include <Teuchos_ParameterList.hpp>
+#include <Teuchos_LAPACK.hpp>
+
+#include <Tpetra_MultiVector.hpp>
+#include <Tpetra_CrsMatrix.hpp>
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+// Constructor.
+template<class Scalar,class Basis,int DIM,class Polynomial>
+PartitionOfUnityInterpolationOperator<Scalar,Basis,DIM,Polynomial>::PartitionOfUnityInterpolationOperator( const double radius )
+    : d_radius( radius )
+{ /* ... */ }
+
+//---------------------------------------------------------------------------//
+// Destructor.
+template<class Scalar,class Basis,int DIM,class Polynomial>
+PartitionOfUnityInterpolationOperator<Scalar,Basis,DIM,Polynomial>::~PartitionOfUnityInterpolationOperator()
+{ /* ... */ }
+
+//---------------------------------------------------------------------------//
+// Setup the map operator.
+template<class Scalar,class Basis,int DIM,class Polynomial>
+void PartitionOfUnityInterpolationOperator<Scalar,Basis,DIM,Polynomial>::setup(
+    const Teuchos::RCP<const typename Base::TpetraMap>& domain_map,
+    const Teuchos::RCP<FunctionSpace>& domain_space,
+    const Teuchos::RCP<const typename Base::TpetraMap>& range_map,
+    const Teuchos::RCP<FunctionSpace>& range_space,
+    const Teuchos::RCP<Teuchos::ParameterList>& parameters )
+{
+    DTK_REQUIRE( Teuchos::nonnull(domain_map) );
+    DTK_REQUIRE( Teuchos::nonnull(domain_space) );
+    DTK_REQUIRE( Teuchos::nonnull(range_map) );
+    DTK_REQUIRE( Teuchos::nonnull(range_space) );
+    DTK_REQUIRE( Teuchos::nonnull(parameters) );
+
+    // Get the parallel communicator.
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = domain_map->getComm();
+
+    // Determine if we have range and domain data on this process.
+    bool nonnull_domain = Teuchos::nonnull( domain_space->entitySet() );
+    bool nonnull_range = Teuchos::nonnull( range_space->entitySet() );
+
+    // Make sure we are applying the map to nodes.
+    DTK_REQUIRE( domain_space->entitySelector()->entityType() ==
+		 ENTITY_TYPE_NODE );
+    DTK_REQUIRE( range_space->entitySelector()->entityType() ==
+		 ENTITY_TYPE_NODE );
+
+    // Extract the DOF maps.
+    this->b_domain_map = domain_map;
+    this->b_range_map = range_map;
+
+    // Extract the source centers and their ids.
+    EntityIterator domain_iterator;
+    if ( nonnull_domain )
+    {
+	domain_iterator = domain_space->entitySet()->entityIterator( 
+	    domain_space->entitySelector()->entityType(),
+	    domain_space->entitySelector()->selectFunction() );
+    }
+    int local_num_src = domain_iterator.size();
+    Teuchos::ArrayRCP<double> source_centers( DIM*local_num_src);
+    Teuchos::ArrayRCP<GO> source_gids( local_num_src );
+    EntityIterator domain_begin = domain_iterator.begin();
+    EntityIterator domain_end = domain_iterator.end();
+    int entity_counter = 0;
+    for ( EntityIterator domain_entity = domain_begin;
+	  domain_entity != domain_end;
+	  ++domain_entity, ++entity_counter )
+    {
+	source_gids[entity_counter] = domain_entity->id();
+	domain_space->localMap()->centroid(
+	    *domain_entity, source_centers(DIM*entity_counter,DIM) );
+    }
+
+    // Extract the target centers and their ids.
+    EntityIterator range_iterator;
+    if ( nonnull_range )
+    {
+	range_iterator = range_space->entitySet()->entityIterator( 
+	    range_space->entitySelector()->entityType(),
+	    range_space->entitySelector()->selectFunction() );
+    } 
+    int local_num_tgt = range_iterator.size();
+    Teuchos::ArrayRCP<double> target_centers( DIM*local_num_tgt );
+    Teuchos::ArrayRCP<GO> target_gids( local_num_tgt );
+    EntityIterator range_begin = range_iterator.begin();
+    EntityIterator range_end = range_iterator.end();
+    entity_counter = 0;
+    for ( EntityIterator range_entity = range_begin;
+	  range_entity != range_end;
+	  ++range_entity, ++entity_counter )
+    {
+	target_gids[entity_counter] = range_entity->id();
+	range_space->localMap()->centroid(
+	    *range_entity, target_centers(DIM*entity_counter,DIM) );
+    }
+
+    // Build the patches covering the target centers on this proc.
+    Teuchos::Array<double> patch_centers;
+    buildPatches( target_centers(), d_radius, patch_centers );
+    int num_patches = patch_centers.size() / DIM;
+
+    // Build the basis. The same basis is used for the patch interpolants and
+    // for the partition of unity weights.
+    Teuchos::RCP<Basis> basis = BP::create( d_radius );
+
+    // Gather the source centers that are within a radius of the patch
+    // centers on this proc. This is the only communication in the setup.
+    Teuchos::Array<double> dist_sources;
+    CenterDistributor<DIM> distributor(
+	comm, source_centers(), patch_centers(), d_radius, dist_sources,
+	CenterDistributor<DIM>::rendezvousDiscovery(*parameters) );
+
+    // Gather the global ids of the source centers that are within a radius of
+    // the patch centers on this proc.
+    Teuchos::Array<GO> dist_source_gids( distributor.getNumImports() );
+    Teuchos::ArrayView<const GO> source_gids_view = source_gids();
+    distributor.distribute( source_gids_view, dist_source_gids() );
+
+    // Build the patch/source and target/patch pairings.
+    SplineInterpolationPairing<DIM> patch_sources( 
+	dist_sources(), patch_centers(), d_radius );
+    SplineInterpolationPairing<DIM> target_patches(
+	patch_centers(), target_centers(), d_radius );
+    Teuchos::ArrayRCP<std::size_t> sources_per_patch = 
+	patch_sources.childrenPerParent();
+    Teuchos::ArrayRCP<std::size_t> patches_per_target =
+	target_patches.childrenPerParent();
+
+    // Compute the Shepard weights of the patches covering each target center
+    // and invert the target/patch pairing such that each patch has a list of
+    // the target centers it covers. Patches without source centers do not
+    // contribute to the partition of unity.
+    Teuchos::Array<int> patch_offsets( num_patches + 1, 0 );
+    for ( int i = 0; i < local_num_tgt; ++i )
+    {
+	Teuchos::ArrayView<const unsigned> patches = 
+	    target_patches.childCenterIds(i);
+	for ( int p = 0; p < patches.size(); ++p )
+	{
+	    ++patch_offsets[ patches[p] + 1 ];
+	}
+    }
+    for ( int p = 0; p < num_patches; ++p )
+    {
+	patch_offsets[p+1] += patch_offsets[p];
+    }
+    Teuchos::Array<int> patch_targets( patch_offsets.back() );
+    Teuchos::Array<double> patch_weights( patch_offsets.back() );
+    Teuchos::Array<int> patch_fill( patch_offsets.begin(), 
+				    patch_offsets.end() - 1 );
+    Teuchos::Array<double> target_weights;
+    double weight_sum = 0.0;
+    int slot = 0;
+    for ( int i = 0; i < local_num_tgt; ++i )
+    {
+	Teuchos::ArrayView<const unsigned> patches = 
+	    target_patches.childCenterIds(i);
+	target_weights.resize( patches.size() );
+	weight_sum = 0.0;
+	for ( int p = 0; p < patches.size(); ++p )
+	{
+	    target_weights[p] = ( 0 < sources_per_patch[patches[p]] )
+				? BP::evaluateValue( 
+				    *basis, EuclideanDistance<DIM>::distance(
+					&target_centers[DIM*i],
+					&patch_centers[DIM*patches[p]]) )
+				: 0.0;
+	    weight_sum += target_weights[p];
+	}
+	for ( int p = 0; p < patches.size(); ++p )
+	{
+	    slot = patch_fill[ patches[p] ]++;
+	    patch_targets[slot] = i;
+	    patch_weights[slot] = ( 0.0 < weight_sum ) 
+				  ? target_weights[p] / weight_sum : 0.0;
+	}
+    }
+
+    // Compute the offsets of the blended cardinal function values of each
+    // patch. Each patch writes a dense block of values for each of its
+    // source centers at each of the targets it covers.
+    Teuchos::Array<std::size_t> value_offsets( num_patches + 1, 0 );
+    for ( int p = 0; p < num_patches; ++p )
+    {
+	value_offsets[p+1] = value_offsets[p] + sources_per_patch[p] *
+			     (patch_offsets[p+1] - patch_offsets[p]);
+    }
+
+    // Solve the local interpolation problem in each patch. The patch system
+    // [Phi P; P^T 0] is symmetric so the cardinal functions of the patch
+    // sources at a target center x are the solution of the system with the
+    // right-hand side [phi(x); p(x)]. All targets covered by a patch are
+    // solved together as multiple right-hand sides. The patch system may be
+    // rank-deficient if the patch contains few source centers so the least
+    // squares problem is solved. Patches are independent and write directly
+    // into their slot of the value buffer so they may be solved in parallel.
+    // The columns are the local ids of the distributed source centers.
+    Teuchos::Array<int> H_indices( value_offsets.back() );
+    Teuchos::Array<Scalar> H_values( value_offsets.back() );
+    const double* source_ptr = dist_sources.getRawPtr();
+    const double* target_ptr = target_centers.getRawPtr();
+    const int* patch_offsets_ptr = patch_offsets.getRawPtr();
+    const int* patch_targets_ptr = patch_targets.getRawPtr();
+    const double* patch_weights_ptr = patch_weights.getRawPtr();
+    const std::size_t* value_offsets_ptr = value_offsets.getRawPtr();
+    const unsigned* child_ids_ptr = patch_sources.rawChildCenterIds();
+    const std::size_t* child_offsets_ptr = 
+	patch_sources.rawChildCenterOffsets();
+    int* indices_ptr = H_indices.getRawPtr();
+    Scalar* values_ptr = H_values.getRawPtr();
+    Teuchos::Array<int> patch_info( num_patches, 0 );
+    int* info_ptr = patch_info.getRawPtr();
+#if HAVE_DTK_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for ( int p = 0; p < num_patches; ++p )
+    {
+	int n = child_offsets_ptr[p+1] - child_offsets_ptr[p];
+	int m = patch_offsets_ptr[p+1] - patch_offsets_ptr[p];
+	if ( 0 < n && 0 < m )
+	{
+	    const unsigned* sources = child_ids_ptr + child_offsets_ptr[p];
+	    int N = n + poly_size;
+	    double poly[poly_size];
+
+	    // Build the patch system in column-major order.
+	    Teuchos::Array<double> A( N*N, 0.0 );
+	    for ( int j = 0; j < n; ++j )
+	    {
+		const double* xj = source_ptr + DIM*sources[j];
+		for ( int i = 0; i < n; ++i )
+		{
+		    A[j*N + i] = BP::evaluateValue(
+			*basis, EuclideanDistance<DIM>::distance(
+			    source_ptr + DIM*sources[i], xj) );
+		}
+		Polynomial::evaluate( xj, poly );
+		for ( int k = 0; k < poly_size; ++k )
+		{
+		    A[(n+k)*N + j] = poly[k];
+		    A[j*N + n + k] = poly[k];
+		}
+	    }
+
+	    // Build the right-hand sides.
+	    Teuchos::Array<double> B( N*m );
+	    const int* targets = patch_targets_ptr + patch_offsets_ptr[p];
+	    for ( int t = 0; t < m; ++t )
+	    {
+		const double* xt = target_ptr + DIM*targets[t];
+		for ( int j = 0; j < n; ++j )
+		{
+		    B[t*N + j] = BP::evaluateValue(
+			*basis, EuclideanDistance<DIM>::distance(
+			    source_ptr + DIM*sources[j], xt) );
+		}
+		Polynomial::evaluate( xt, &B[t*N + n] );
+	    }
+
+	    // Solve the patch problem.
+	    Teuchos::LAPACK<int,double> lapack;
+	    double rcond = std::numeric_limits<double>::epsilon();
+	    int work_size = 3*N + std::max( 2*N, m );
+	    Teuchos::Array<double> work( work_size );
+	    Teuchos::Array<double> s( N );
+	    int rank = 0;
+	    lapack.GELSS( N, N, m, A.getRawPtr(), N, B.getRawPtr(), N,
+			  s.getRawPtr(), rcond, &rank, 
+			  work.getRawPtr(), work_size, info_ptr + p );
+
+	    // Blend the cardinal functions with the partition of unity
+	    // weights.
+	    int* patch_indices = indices_ptr + value_offsets_ptr[p];
+	    Scalar* patch_values = values_ptr + value_offsets_ptr[p];
+	    const double* weights = patch_weights_ptr + patch_offsets_ptr[p];
+	    for ( int t = 0; t < m; ++t )
+	    {
+		for ( int j = 0; j < n; ++j )
+		{
+		    patch_indices[t*n + j] = sources[j];
+		    patch_values[t*n + j] = weights[t] * B[t*N + j];
+		}
+	    }
+	}
+    }
+
+    // Check the patch solves outside of the threaded loop.
+    for ( int p = 0; p < num_patches; ++p )
+    {
+	DTK_INSIST( 0 == patch_info[p] );
+    }
+
+    // Build the interpolation matrix. A target center receives a row
+    // segment from each patch covering it and duplicate source entries from
+    // overlapping patches are summed.
+    Teuchos::Array<GO> segment_rows( patch_offsets.back() );
+    Teuchos::Array<std::size_t> segment_offsets( patch_offsets.back() + 1 );
+    for ( int p = 0; p < num_patches; ++p )
+    {
+	for ( int t = patch_offsets[p]; t < patch_offsets[p+1]; ++t )
+	{
+	    segment_rows[t] = target_gids[ patch_targets[t] ];
+	    segment_offsets[t] = value_offsets[p] + 
+				 sources_per_patch[p] * (t - patch_offsets[p]);
+	}
+    }
+    segment_offsets.back() = value_offsets.back();
+    Teuchos::RCP<Tpetra::CrsMatrix<Scalar,int,GO> > H = 
+	CrsMatrixAssembler<Scalar,GO>::assemble( 
+	    this->b_range_map, this->b_domain_map, dist_source_gids(), 
+	    segment_rows(), segment_offsets(), H_indices(), H_values() );
+    
+    // Wrap the interpolation matrix in a Thyra wrapper.
+    Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > thyra_range_vector_space =
+    	Thyra::createVectorSpace<Scalar>( H->getRangeMap() );
+    Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > thyra_domain_vector_space =
+    	Thyra::createVectorSpace<Scalar>( H->getDomainMap() );
+    Teuchos::RCP<Thyra::TpetraLinearOp<Scalar,LO,GO> > thyra_H =
+    	Teuchos::rcp( new Thyra::TpetraLinearOp<Scalar,LO,GO>() );
+    thyra_H->initialize( thyra_range_vector_space, thyra_domain_vector_space, H );
+
+    // Set the coupling matrix with the base class.
+    this->b_coupling_matrix = thyra_H;
+    DTK_ENSURE( Teuchos::nonnull(this->b_coupling_matrix) );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Build the patches covering a set of target centers.
+ *
+ * Space is binned into a uniform grid of cells and a patch is centered in
+ * each cell that contains a target center. The cells are sized such that the
+ * center of the cell containing a target center is within 3/4 of the radius
+ * of that target and the patches of neighboring cells overlap.
+ */
+template<class Scalar,class Basis,int DIM,class Polynomial>
+void PartitionOfUnityInterpolationOperator<Scalar,Basis,DIM,Polynomial>::buildPatches(
+    const Teuchos::ArrayView<const double>& target_centers,
+    const double radius,
+    Teuchos::Array<double>& patch_centers )
+{
+    DTK_REQUIRE( 0 == target_centers.size() % DIM );
+    DTK_REQUIRE( 0.0 < radius );
+
+    double cell_size = 1.5 * radius / std::sqrt( static_cast<double>(DIM) );
+    int num_targets = target_centers.size() / DIM;
+    std::map<std::array<int,DIM>,int> cells;
+    std::array<int,DIM> cell;
+    for ( int i = 0; i < num_targets; ++i )
+    {
+	for ( int d = 0; d < DIM; ++d )
+	{
+	    cell[d] = static_cast<int>( 
+		std::floor(target_centers[DIM*i + d] / cell_size) );
+	}
+	cells.insert( std::make_pair(cell,0) );
+    }
+
+    patch_centers.resize( DIM*cells.size() );
+    int p = 0;
+    typename std::map<std::array<int,DIM>,int>::const_iterator cell_it;
+    for ( cell_it = cells.begin(); cell_it != cells.end(); ++cell_it, ++p )
+    {
+	for ( int d = 0; d < DIM; ++d )
+	{
+	    patch_centers[DIM*p + d] = (cell_it->first[d] + 0.5) * cell_size;
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+
+#endif // end DTK_PARTITIONOFUNITYINTERPOLATIONOPERATOR_IMPL_HPP
+
+//---------------------------------------------------------------------------//
+// end DTK_PartitionOfUnityInterpolationOperator_impl.hpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,143 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+ * \file   DTK_PolynomialBasis.hpp
+ * \author Stuart R. Slattery
+ * \brief  Polynomial bases for moving least square reconstruction.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef DTK_POLYNOMIALBASIS_HPP
+#define DTK_POLYNOMIALBASIS_HPP
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \class ConstantPolynomialBasis
+ * \brief Constant polynomial basis. Moving least square reconstruction with
+ * this basis reduces to Shepard interpolation.
+ */
+//---------------------------------------------------------------------------//
+template<int DIM>
+class ConstantPolynomialBasis
+{
+  public:
+
+    //! Spatial dimension.
+    static const int dim = DIM;
+
+    //! Number of terms in the basis.
+    static const int size = 1;
+
+    //! Evaluate the basis at a point.
+    static inline void evaluate( const double*, double* poly )
+    { poly[0] = 1.0; }
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * \class LinearPolynomialBasis
+ * \brief Linear polynomial basis.
+ */
+//---------------------------------------------------------------------------//
+template<int DIM>
+class LinearPolynomialBasis
+{
+  public:
+
+    //! Spatial dimension.
+    static const int dim = DIM;
+
+    //! Number of terms in the basis.
+    static const int size = DIM + 1;
+
+    //! Evaluate the basis at a point.
+    static inline void evaluate( const double* x, double* poly )
+    {
+	for ( int d = 0; d < DIM; ++d )
+	{
+	    poly[d] = x[d];
+	}
+	poly[DIM] = 1.0;
+    }
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * \class QuadraticPolynomialBasis
+ * \brief Full quadratic polynomial basis.
+ */
+//---------------------------------------------------------------------------//
+template<int DIM>
+class QuadraticPolynomialBasis
+{
+  public:
+
+    //! Spatial dimension.
+    static const int dim = DIM;
+
+    //! Number of terms in the basis.
+    static const int size = (DIM+1)*(DIM+2) / 2;
+
+    //! Evaluate the basis at a point. The quadratic terms are ordered first
+    //! followed by the linear terms and the constant.
+    static inline void evaluate( const double* x, double* poly )
+    {
+	int n = 0;
+	for ( int i = 0; i < DIM; ++i )
+	{
+	    for ( int j = i; j < DIM; ++j, ++n )
+	    {
+		poly[n] = x[i]*x[j];
+	    }
+	}
+	for ( int d = 0; d < DIM; ++d, ++n )
+	{
+	    poly[n] = x[d];
+	}
+	poly[n] = 1.0;
+    }
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+
+#endif // end DTK_POLYNOMIALBASIS_HPP
+
+//---------------------------------------------------------------------------//
+// end DTK_PolynomialBasis.hpp
+//---------------------------------------------------------------------------//
@@ -43,6 +43,8 @@
 
 #include <Teuchos_RCP.hpp>
 #include <Teuchos_Comm.hpp>
+#include <Teuchos_Array.hpp>
+#include <Teuchos_ArrayView.hpp>
 
 #include <Tpetra_Map.hpp>
 #include <Tpetra_MultiVector.hpp>
@@ -55,6 +57,11 @@ namespace DataTransferKit
 /*!
  * \class PolynomialMatrix
  * \brief Vector apply implementation for polynomial matrices.
+ *
+ * The polynomial matrix couples every row of the range to a small number of
+ * polynomial coefficients in the domain. The coefficients may be owned by
+ * any process. They are replicated on all processes with a single reduction
+ * of the coefficient values in each apply so no process acts as a root.
  */
 //---------------------------------------------------------------------------//
 template<class GO>
@@ -62,12 +69,21 @@ class PolynomialMatrix : public Tpetra::Operator<double,int,GO>
 {
   public:
 
-    // Constructor.
+    // Constructor. The polynomial coefficients are the first entries of the
+    // domain map on the root process.
     PolynomialMatrix(
 	const Teuchos::RCP<const Tpetra::MultiVector<double,int,GO> >& polynomial,
 	const Teuchos::RCP<const Tpetra::Map<int,GO> >& domain_map,
 	const Teuchos::RCP<const Tpetra::Map<int,GO> >& range_map );
 
+    // Constructor with the global ids of the polynomial coefficients in the
+    // domain map.
+    PolynomialMatrix(
+	const Teuchos::RCP<const Tpetra::MultiVector<double,int,GO> >& polynomial,
+	const Teuchos::RCP<const Tpetra::Map<int,GO> >& domain_map,
+	const Teuchos::RCP<const Tpetra::Map<int,GO> >& range_map,
+	const Teuchos::ArrayView<const GO>& poly_gids );
+
     //! Destructor.
     ~PolynomialMatrix()
     { /* ... */ }
@@ -102,6 +118,11 @@ class PolynomialMatrix : public Tpetra::Operator<double,int,GO>
     bool hasTransposeApply() const
     { return true; }
 
+  private:
+
+    // Get the local ids of the polynomial coefficients in the domain map.
+    void setPolynomialIds( const Teuchos::ArrayView<const GO>& poly_gids );
+
   private:
 
     // Parallel communicator.
@@ -115,6 +136,10 @@ class PolynomialMatrix : public Tpetra::Operator<double,int,GO>
 
     // Range map.
     Teuchos::RCP<const Tpetra::Map<int,GO> > d_range_map;
+
+    // Local ids of the polynomial coefficients in the domain map. Invalid if
+    // not owned by this process.
+    Teuchos::Array<int> d_poly_lids;
 };
 
 //---------------------------------------------------------------------------//
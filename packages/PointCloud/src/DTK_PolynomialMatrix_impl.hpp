@@ -45,12 +45,8 @@
 
 #include <Teuchos_ArrayRCP.hpp>
 #include <Teuchos_CommHelpers.hpp>
-#include <Teuchos_OpaqueWrapper.hpp>
-
-#ifdef HAVE_MPI
-#include <Teuchos_DefaultMpiComm.hpp>
-#include <mpi.h>
-#endif
+#include <Teuchos_OrdinalTraits.hpp>
+#include <Teuchos_as.hpp>
 
 #include <Tpetra_Export.hpp>
 
@@ -58,7 +54,8 @@ namespace DataTransferKit
 {
 //---------------------------------------------------------------------------//
 /*!
- * \brief Constructor.
+ * \brief Constructor. The polynomial coefficients are the first entries of
+ * the domain map on the root process.
  */
 template<class GO>
 PolynomialMatrix<GO>::PolynomialMatrix(
@@ -69,7 +66,41 @@ PolynomialMatrix<GO>::PolynomialMatrix(
     , d_polynomial( polynomial )
     , d_domain_map( domain_map )
     , d_range_map( range_map )
-{ /* ... */ }
+{
+    // Get the global ids of the coefficients from the root process.
+    int poly_size = d_polynomial->getNumVectors();
+    Teuchos::Array<GO> poly_gids( poly_size );
+    if ( 0 == d_comm->getRank() )
+    {
+	Teuchos::ArrayView<const GO> domain_elements =
+	    d_domain_map->getNodeElementList();
+	DTK_REQUIRE( poly_size <= domain_elements.size() );
+	poly_gids().assign( domain_elements(0,poly_size) );
+    }
+    Teuchos::broadcast( *d_comm, 0, poly_gids() );
+    setPolynomialIds( poly_gids() );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Constructor with the global ids of the polynomial coefficients in
+ * the domain map.
+ */
+template<class GO>
+PolynomialMatrix<GO>::PolynomialMatrix(
+    const Teuchos::RCP<const Tpetra::MultiVector<double,int,GO> >& polynomial,
+    const Teuchos::RCP<const Tpetra::Map<int,GO> >& domain_map,
+    const Teuchos::RCP<const Tpetra::Map<int,GO> >& range_map,
+    const Teuchos::ArrayView<const GO>& poly_gids )
+    : d_comm( polynomial->getMap()->getComm() )
+    , d_polynomial( polynomial )
+    , d_domain_map( domain_map )
+    , d_range_map( range_map )
+{
+    DTK_REQUIRE( Teuchos::as<std::size_t>(poly_gids.size()) ==
+		 d_polynomial->getNumVectors() );
+    setPolynomialIds( poly_gids );
+}
 
 //---------------------------------------------------------------------------//
 // Apply operation. 
@@ -81,10 +112,6 @@ void PolynomialMatrix<GO>::apply(
     double alpha,
     double beta ) const
 {
-    DTK_REQUIRE( d_domain_map->isSameAs(*(X.getMap())) );
-    DTK_REQUIRE( d_range_map->isSameAs(*(Y.getMap())) );
-    DTK_REQUIRE( X.getNumVectors() == Y.getNumVectors() );
-
     // Get the size of the problem and view of the local vectors.
     int poly_size = d_polynomial->getNumVectors();
     int num_vec = X.getNumVectors();
@@ -94,25 +121,34 @@ void PolynomialMatrix<GO>::apply(
     Teuchos::ArrayRCP<Teuchos::ArrayRCP<double> > y_view =
 	Y.get2dViewNonConst();
 
-    // Scale Y.
-    Y.scale( beta );
-
     // No transpose.
     if ( Teuchos::NO_TRANS == mode )
     {
-	// Broadcast the polynomial components of X from the root rank.
-	Teuchos::Array<double> x_poly( poly_size * num_vec, 0.0 );
-	if ( 0 == d_comm()->getRank() )
+	DTK_REQUIRE( d_domain_map->isSameAs(*(X.getMap())) );
+	DTK_REQUIRE( d_range_map->isSameAs(*(Y.getMap())) );
+	DTK_REQUIRE( X.getNumVectors() == Y.getNumVectors() );
+
+	// Replicate the polynomial components of X on all processes. Each
+	// component is owned by a single process and zero elsewhere.
+	Teuchos::ArrayRCP<Teuchos::ArrayRCP<const double> > x_view =
+	    X.get2dView();
+	Teuchos::Array<double> local_x_poly( poly_size * num_vec, 0.0 );
+	for ( int p = 0; p < poly_size; ++p )
 	{
-	    Teuchos::ArrayRCP<Teuchos::ArrayRCP<const double> > x_view =
-		X.get2dView();
-	    for ( int n = 0; n < num_vec; ++n )
+	    if ( Teuchos::OrdinalTraits<int>::invalid() != d_poly_lids[p] )
 	    {
-		std::copy( &x_view[n][0], &x_view[n][0] + poly_size,
-			   &x_poly[n*poly_size] );
+		for ( int n = 0; n < num_vec; ++n )
+		{
+		    local_x_poly[n*poly_size + p] = x_view[n][ d_poly_lids[p] ];
+		}
 	    }
 	}
-	Teuchos::broadcast( *d_comm, 0, x_poly() );
+	Teuchos::Array<double> x_poly( poly_size * num_vec, 0.0 );
+	Teuchos::reduceAll( *d_comm, Teuchos::REDUCE_SUM, poly_size * num_vec,
+			    local_x_poly.getRawPtr(), x_poly.getRawPtr() );
+
+	// Scale Y.
+	Y.scale( beta );
 
 	// Do the local mat-vec.
 	int stride = 0;
@@ -133,16 +169,27 @@ void PolynomialMatrix<GO>::apply(
     // Transpose.
     else if ( Teuchos::TRANS == mode )
     {
-	// Make a work vector.
-	Tpetra::MultiVector<double,int,GO> work( Y );
+	DTK_REQUIRE( d_range_map->isSameAs(*(X.getMap())) );
+	DTK_REQUIRE( d_domain_map->isSameAs(*(Y.getMap())) );
+	DTK_REQUIRE( X.getNumVectors() == Y.getNumVectors() );
 
-	// Export X to the polynomial decomposition.
-	Tpetra::Export<int,GO> exporter( X.getMap(), Y.getMap() );
-	work.doExport( X, exporter, Tpetra::INSERT );
+	// Get X in the polynomial decomposition. This is only a view unless
+	// the polynomial has a different decomposition than the range.
+	Teuchos::RCP<const Tpetra::MultiVector<double,int,GO> > x_poly_dist =
+	    Teuchos::rcpFromRef( X );
+	if ( !d_polynomial->getMap()->isSameAs(*(X.getMap())) )
+	{
+	    Teuchos::RCP<Tpetra::MultiVector<double,int,GO> > work =
+		Tpetra::createMultiVector<double,int,GO>( 
+		    d_polynomial->getMap(), num_vec );
+	    Tpetra::Export<int,GO> exporter( X.getMap(), work->getMap() );
+	    work->doExport( X, exporter, Tpetra::INSERT );
+	    x_poly_dist = work;
+	}
 
 	// Do the local mat-vec.
-	Teuchos::ArrayRCP<Teuchos::ArrayRCP<double> > work_view =
-	    work.get2dViewNonConst();
+	Teuchos::ArrayRCP<Teuchos::ArrayRCP<const double> > x_view =
+	    x_poly_dist->get2dView();
 	Teuchos::Array<double> products( poly_size * num_vec, 0.0 );
 	int stride = 0;
 	for ( int n = 0; n < num_vec; ++n )
@@ -152,38 +199,26 @@ void PolynomialMatrix<GO>::apply(
 	    {
 		for ( int i = 0; i < local_length; ++i )
 		{
-		    products[stride + p] += poly_view[p][i] * work_view[n][i];
+		    products[stride + p] += poly_view[p][i] * x_view[n][i];
 		}
 	    }
 	}
 
-	// Reduce the results back to the root rank.
+	// Sum the results on all processes.
 	Teuchos::Array<double> product_sums( poly_size * num_vec, 0.0 );
-#ifdef HAVE_MPI
-	Teuchos::RCP< const Teuchos::MpiComm<int> > mpi_comm = 
-	    Teuchos::rcp_dynamic_cast< const Teuchos::MpiComm<int> >( d_comm );
-	Teuchos::RCP< const Teuchos::OpaqueWrapper<MPI_Comm> > opaque_comm = 
-	    mpi_comm->getRawMpiComm();
-	MPI_Comm raw_comm = (*opaque_comm)();
-	MPI_Reduce( products.getRawPtr(), 
-		    product_sums.getRawPtr(), 
-		    poly_size * num_vec, 
-		    MPI_DOUBLE, 
-		    MPI_SUM, 
-		    0, 
-		    raw_comm );
-#else
-	product_sums = products;
-#endif
-	
-	// Assign the values to Y on the root rank.
-	if ( 0 == d_comm->getRank() )
+	Teuchos::reduceAll( *d_comm, Teuchos::REDUCE_SUM, poly_size * num_vec,
+			    products.getRawPtr(), product_sums.getRawPtr() );
+
+	// Assign the values to Y on the processes that own the coefficients.
+	Y.scale( beta );
+	for ( int p = 0; p < poly_size; ++p )
 	{
-	    for ( int n = 0; n < num_vec; ++n )
+	    if ( Teuchos::OrdinalTraits<int>::invalid() != d_poly_lids[p] )
 	    {
-		for ( int p = 0; p < poly_size; ++p )
+		for ( int n = 0; n < num_vec; ++n )
 		{
-		    y_view[n][p] += alpha * product_sums[n*poly_size+p];
+		    y_view[n][ d_poly_lids[p] ] += 
+			alpha * product_sums[n*poly_size+p];
 		}
 	    }
 	}
@@ -195,6 +230,22 @@ void PolynomialMatrix<GO>::apply(
     }
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get the local ids of the polynomial coefficients in the domain map.
+ */
+template<class GO>
+void PolynomialMatrix<GO>::setPolynomialIds(
+    const Teuchos::ArrayView<const GO>& poly_gids )
+{
+    int poly_size = poly_gids.size();
+    d_poly_lids.resize( poly_size );
+    for ( int p = 0; p < poly_size; ++p )
+    {
+	d_poly_lids[p] = d_domain_map->getLocalElement( poly_gids[p] );
+    }
+}
+
 //---------------------------------------------------------------------------//
 
 } // end namespace DataTransferKit
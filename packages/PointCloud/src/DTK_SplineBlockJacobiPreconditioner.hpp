@@ -0,0 +1,203 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_SplineBlockJacobiPreconditioner.hpp
+ * \author Stuart R. Slattery
+ * \brief  Block Jacobi preconditioner for the spline coefficient matrix.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef DTK_SPLINEBLOCKJACOBIPRECONDITIONER_HPP
+#define DTK_SPLINEBLOCKJACOBIPRECONDITIONER_HPP
+
+#include "DTK_RadialBasisPolicy.hpp"
+
+#include <Teuchos_RCP.hpp>
+#include <Teuchos_Comm.hpp>
+#include <Teuchos_Array.hpp>
+#include <Teuchos_ArrayView.hpp>
+#include <Teuchos_ScalarTraits.hpp>
+
+#include <Tpetra_Map.hpp>
+#include <Tpetra_MultiVector.hpp>
+#include <Tpetra_Operator.hpp>
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \class SplineBlockJacobiPreconditioner
+ * \brief Block Jacobi preconditioner for the spline coefficient matrix
+ * C = P + M + P^T.
+ *
+ * The local source centers on each process are ordered along a Hilbert curve
+ * and split into contiguous, non-overlapping blocks of at most a given size so
+ * that each block holds nearby centers. The basis matrix of each block is
+ * factored with a dense Cholesky decomposition. A block that is numerically
+ * singular, as from duplicate or nearly coincident centers, is regularized
+ * with a small diagonal shift and, if that still fails, replaced by its
+ * diagonal. The resulting block diagonal approximation Mb of M is used in a
+ * block factorization of C with a replicated coarse solve for the polynomial
+ * coefficients:
+ *
+ * \f[ b = (P^T M_b^{-1} P)^{-1} (P^T M_b^{-1} f - g), \quad
+ *     a = M_b^{-1} (f - P b) \f]
+ *
+ * Each application requires a single reduction of size DIM+1 per vector.
+ */
+//---------------------------------------------------------------------------//
+template<class Basis,int DIM>
+class SplineBlockJacobiPreconditioner 
+    : public Tpetra::Operator<double,int,std::size_t>
+{
+  public:
+
+    //@{
+    //! Typedefs.
+    typedef RadialBasisPolicy<Basis> BP;
+    //@}
+
+    //! Size of the polynomial.
+    static const int poly_size = DIM + 1;
+
+    // Constructor.
+    SplineBlockJacobiPreconditioner(
+	const Teuchos::RCP<const Tpetra::Map<int,std::size_t> >& operator_map,
+	const Teuchos::ArrayView<const double>& source_centers,
+	const Teuchos::ArrayView<const std::size_t>& source_center_gids,
+	const Basis& basis,
+	const int max_block_size );
+
+    //! Destructor.
+    ~SplineBlockJacobiPreconditioner()
+    { /* ... */ }
+
+    //! The Map associated with the domain of this operator, which must be
+    //! compatible with X.getMap().
+    Teuchos::RCP<const Tpetra::Map<int,std::size_t> > getDomainMap() const
+    { return d_map; }
+
+    //! The Map associated with the range of this operator, which must be
+    //! compatible with Y.getMap().
+    Teuchos::RCP<const Tpetra::Map<int,std::size_t> > getRangeMap() const
+    { return d_map; }
+
+    //! \brief Computes the operator-multivector application.
+    /*! Loosely, performs \f$Y = \alpha \cdot A^{\textrm{mode}} \cdot X +
+        \beta \cdot Y\f$. However, the details of operation vary according to
+        the values of \c alpha and \c beta. Specifically - if <tt>beta ==
+        0</tt>, apply() <b>must</b> overwrite \c Y, so that any values in \c Y
+        (including NaNs) are ignored.  - if <tt>alpha == 0</tt>, apply()
+        <b>may</b> short-circuit the operator, so that any values in \c X
+        (including NaNs) are ignored.
+     */
+    void apply (const Tpetra::MultiVector<double,int,std::size_t> &X,
+		Tpetra::MultiVector<double,int,std::size_t> &Y,
+		Teuchos::ETransp mode = Teuchos::NO_TRANS,
+		double alpha = Teuchos::ScalarTraits<double>::one(),
+		double beta = Teuchos::ScalarTraits<double>::zero()) const;
+
+    /// \brief Whether this operator supports applying the transpose or
+    /// conjugate transpose.
+    bool hasTransposeApply() const
+    { return false; }
+
+  private:
+
+    // Assemble the lower triangle of the basis matrix of a block with a
+    // diagonal shift and factor it. Return the LAPACK info.
+    static int factorBlock( const Basis& basis,
+			    const double* centers,
+			    const int block_size,
+			    const double shift,
+			    double* A );
+
+    // Apply the inverse of the block basis matrix in place to a set of
+    // column-major local source vectors.
+    void solveBlocks( double* vectors, const int num_vec ) const;
+
+  private:
+
+    // Operator map.
+    Teuchos::RCP<const Tpetra::Map<int,std::size_t> > d_map;
+
+    // Parallel communicator.
+    Teuchos::RCP<const Teuchos::Comm<int> > d_comm;
+
+    // Number of local source centers.
+    int d_num_sources;
+
+    // Local ids of the source centers in the operator map in curve order.
+    Teuchos::Array<int> d_source_lids;
+
+    // Local ids of the polynomial coefficients in the operator map. Invalid
+    // if not owned by this process.
+    Teuchos::Array<int> d_poly_lids;
+
+    // Offsets of the blocks into the sorted local source centers.
+    Teuchos::Array<int> d_block_offsets;
+
+    // Offsets of the block factors into the factor storage.
+    Teuchos::Array<int> d_factor_offsets;
+
+    // Cholesky factors of the block basis matrices.
+    Teuchos::Array<double> d_factors;
+
+    // Column-major polynomial matrix of the local source centers.
+    Teuchos::Array<double> d_polynomial;
+
+    // Column-major block basis inverse applied to the polynomial matrix.
+    Teuchos::Array<double> d_W;
+
+    // Column-major (pseudo-)inverse of the coarse polynomial matrix.
+    Teuchos::Array<double> d_S_inv;
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+// Template includes.
+//---------------------------------------------------------------------------//
+
+#include "DTK_SplineBlockJacobiPreconditioner_impl.hpp"
+
+//---------------------------------------------------------------------------//
+
+#endif // end DTK_SPLINEBLOCKJACOBIPRECONDITIONER_HPP
+
+//---------------------------------------------------------------------------//
+// end DTK_SplineBlockJacobiPreconditioner.hpp
+//---------------------------------------------------------------------------//
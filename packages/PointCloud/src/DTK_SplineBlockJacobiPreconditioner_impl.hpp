@@ -0,0 +1,382 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_SplineBlockJacobiPreconditioner_impl.hpp
+ * \author Stuart R. Slattery
+ * \brief  Block Jacobi preconditioner for the spline coefficient matrix.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef DTK_SPLINEBLOCKJACOBIPRECONDITIONER_IMPL_HPP
+#define DTK_SPLINEBLOCKJACOBIPRECONDITIONER_IMPL_HPP
+
+#include <limits>
+#include <cmath>
+#include <algorithm>
+
+#include "DTK_DBC.hpp"
+#include "DTK_EuclideanDistance.hpp"
+#include "DTK_SpaceFillingCurve.hpp"
+
+#include <Teuchos_ArrayRCP.hpp>
+#include <Teuchos_CommHelpers.hpp>
+#include <Teuchos_OrdinalTraits.hpp>
+#include <Teuchos_LAPACK.hpp>
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Constructor.
+ */
+template<class Basis,int DIM>
+SplineBlockJacobiPreconditioner<Basis,DIM>::SplineBlockJacobiPreconditioner(
+    const Teuchos::RCP<const Tpetra::Map<int,std::size_t> >& operator_map,
+    const Teuchos::ArrayView<const double>& source_centers,
+    const Teuchos::ArrayView<const std::size_t>& source_center_gids,
+    const Basis& basis,
+    const int max_block_size )
+    : d_map( operator_map )
+    , d_comm( operator_map->getComm() )
+    , d_num_sources( source_center_gids.size() )
+{
+    DTK_REQUIRE( 0 == source_centers.size() % DIM );
+    DTK_REQUIRE( source_centers.size() / DIM == 
+		 source_center_gids.size() );
+    DTK_REQUIRE( 0 < max_block_size );
+
+    // Order the local source centers along a space filling curve so that
+    // the contiguous blocks are spatially compact and capture the largest
+    // entries of the basis matrix regardless of the input order.
+    Teuchos::Array<unsigned> permutation;
+    SpaceFillingCurve::sortPermutation( 
+	DIM, source_centers, SpaceFillingCurve::HILBERT, permutation );
+    Teuchos::Array<double> sorted_centers;
+    SpaceFillingCurve::permutePoints( 
+	DIM, source_centers, permutation(), sorted_centers );
+
+    // Get the local ids of the source centers in sorted order.
+    d_source_lids.resize( d_num_sources );
+    for ( int i = 0; i < d_num_sources; ++i )
+    {
+	d_source_lids[i] = 
+	    d_map->getLocalElement( source_center_gids[permutation[i]] );
+	DTK_CHECK( Teuchos::OrdinalTraits<int>::invalid() != 
+		   d_source_lids[i] );
+    }
+
+    // The polynomial coefficients are the last DIM+1 global ids of the
+    // operator map. Only the owning process gets valid local ids.
+    std::size_t poly_gid_begin = d_map->getMaxAllGlobalIndex() - DIM;
+    d_poly_lids.resize( poly_size );
+    for ( int p = 0; p < poly_size; ++p )
+    {
+	d_poly_lids[p] = d_map->getLocalElement( poly_gid_begin + p );
+    }
+
+    // Split the local source centers into blocks of at most the maximum
+    // block size and allocate their factors.
+    int num_blocks = (d_num_sources + max_block_size - 1) / max_block_size;
+    d_block_offsets.resize( num_blocks + 1 );
+    d_factor_offsets.resize( num_blocks + 1 );
+    d_block_offsets[0] = 0;
+    d_factor_offsets[0] = 0;
+    for ( int b = 1; b < num_blocks + 1; ++b )
+    {
+	d_block_offsets[b] = (b * d_num_sources) / num_blocks;
+    }
+    for ( int b = 0; b < num_blocks; ++b )
+    {
+	int block_size = d_block_offsets[b+1] - d_block_offsets[b];
+	d_factor_offsets[b+1] = d_factor_offsets[b] + block_size*block_size;
+    }
+    d_factors.resize( d_factor_offsets[num_blocks] );
+
+    // Assemble and factor the basis matrix of each block. The blocks are
+    // independent so they may be factored in parallel. Duplicate or nearly
+    // coincident centers make a block numerically singular. Such a block is
+    // regularized and if that also fails only its diagonal is kept so the
+    // preconditioner is always defined.
+    const double* centers = sorted_centers.getRawPtr();
+    const int* block_offsets = d_block_offsets.getRawPtr();
+    const int* factor_offsets = d_factor_offsets.getRawPtr();
+    double* factors = d_factors.getRawPtr();
+    const double diagonal = BP::evaluateValue( basis, 0.0 );
+    const double regularization = 1.0e-8;
+#if HAVE_DTK_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for ( int b = 0; b < num_blocks; ++b )
+    {
+	int begin = block_offsets[b];
+	int block_size = block_offsets[b+1] - begin;
+	double* A = factors + factor_offsets[b];
+	const double* block_centers = centers + DIM*begin;
+	if ( 0 != factorBlock(basis, block_centers, block_size, 0.0, A) &&
+	     0 != factorBlock(basis, block_centers, block_size, 
+			      regularization*diagonal, A) )
+	{
+	    std::fill( A, A + block_size*block_size, 0.0 );
+	    for ( int i = 0; i < block_size; ++i )
+	    {
+		A[i*block_size + i] = std::sqrt( diagonal );
+	    }
+	}
+    }
+
+    // Build the local polynomial matrix and apply the block inverse to it.
+    d_polynomial.resize( poly_size * d_num_sources );
+    for ( int i = 0; i < d_num_sources; ++i )
+    {
+	d_polynomial[i] = 1.0;
+	for ( int d = 0; d < DIM; ++d )
+	{
+	    d_polynomial[(d+1)*d_num_sources + i] = centers[DIM*i + d];
+	}
+    }
+    d_W = d_polynomial;
+    solveBlocks( d_W.getRawPtr(), poly_size );
+
+    // Build the coarse polynomial matrix S = P^T Mb^-1 P. It is replicated on
+    // all processes.
+    Teuchos::Array<double> local_S( poly_size*poly_size, 0.0 );
+    for ( int q = 0; q < poly_size; ++q )
+    {
+	for ( int p = 0; p < poly_size; ++p )
+	{
+	    for ( int i = 0; i < d_num_sources; ++i )
+	    {
+		local_S[q*poly_size + p] += 
+		    d_polynomial[p*d_num_sources + i] * 
+		    d_W[q*d_num_sources + i];
+	    }
+	}
+    }
+    Teuchos::Array<double> S( poly_size*poly_size, 0.0 );
+    Teuchos::reduceAll( *d_comm, Teuchos::REDUCE_SUM, poly_size*poly_size,
+			local_S.getRawPtr(), S.getRawPtr() );
+
+    // Invert the coarse matrix. A least squares solve is used so that a
+    // (pseudo-)inverse is available even if the source centers do not span
+    // the space.
+    d_S_inv.assign( poly_size*poly_size, 0.0 );
+    for ( int p = 0; p < poly_size; ++p )
+    {
+	d_S_inv[p*poly_size + p] = 1.0;
+    }
+    Teuchos::LAPACK<int,double> lapack;
+    double S_rcond = std::numeric_limits<double>::epsilon();
+    const int work_size = 5*poly_size;
+    double work[work_size];
+    double s[poly_size];
+    int rank = 0;
+    int S_info = 0;
+    lapack.GELSS( poly_size, poly_size, poly_size, S.getRawPtr(), poly_size,
+		  d_S_inv.getRawPtr(), poly_size, s,
+		  S_rcond, &rank, work, work_size, &S_info );
+    DTK_CHECK( 0 == S_info );
+}
+
+//---------------------------------------------------------------------------//
+// Apply operation. 
+template<class Basis,int DIM>
+void SplineBlockJacobiPreconditioner<Basis,DIM>::apply(
+    const Tpetra::MultiVector<double,int,std::size_t> &X,
+    Tpetra::MultiVector<double,int,std::size_t> &Y,
+    Teuchos::ETransp mode,
+    double alpha,
+    double beta ) const
+{
+    DTK_REQUIRE( d_map->isSameAs(*(X.getMap())) );
+    DTK_REQUIRE( d_map->isSameAs(*(Y.getMap())) );
+    DTK_REQUIRE( X.getNumVectors() == Y.getNumVectors() );
+    DTK_REQUIRE( Teuchos::NO_TRANS == mode );
+
+    int num_vec = X.getNumVectors();
+    Teuchos::ArrayRCP<Teuchos::ArrayRCP<const double> > x_view = 
+	X.get2dView();
+
+    // Gather the source components of X and apply the block inverse.
+    Teuchos::Array<double> a( d_num_sources * num_vec );
+    for ( int n = 0; n < num_vec; ++n )
+    {
+	for ( int i = 0; i < d_num_sources; ++i )
+	{
+	    a[n*d_num_sources + i] = x_view[n][ d_source_lids[i] ];
+	}
+    }
+    solveBlocks( a.getRawPtr(), num_vec );
+
+    // Compute the coarse residual P^T Mb^-1 f - g summed over all processes.
+    Teuchos::Array<double> local_r( poly_size * num_vec, 0.0 );
+    for ( int n = 0; n < num_vec; ++n )
+    {
+	for ( int p = 0; p < poly_size; ++p )
+	{
+	    for ( int i = 0; i < d_num_sources; ++i )
+	    {
+		local_r[n*poly_size + p] += 
+		    d_polynomial[p*d_num_sources + i] * 
+		    a[n*d_num_sources + i];
+	    }
+	    if ( Teuchos::OrdinalTraits<int>::invalid() != d_poly_lids[p] )
+	    {
+		local_r[n*poly_size + p] -= x_view[n][ d_poly_lids[p] ];
+	    }
+	}
+    }
+    Teuchos::Array<double> r( poly_size * num_vec, 0.0 );
+    Teuchos::reduceAll( *d_comm, Teuchos::REDUCE_SUM, poly_size * num_vec,
+			local_r.getRawPtr(), r.getRawPtr() );
+
+    // Solve the coarse problem for the polynomial coefficients.
+    Teuchos::Array<double> c( poly_size * num_vec, 0.0 );
+    for ( int n = 0; n < num_vec; ++n )
+    {
+	for ( int q = 0; q < poly_size; ++q )
+	{
+	    for ( int p = 0; p < poly_size; ++p )
+	    {
+		c[n*poly_size + p] += 
+		    d_S_inv[q*poly_size + p] * r[n*poly_size + q];
+	    }
+	}
+    }
+
+    // Correct the basis coefficients with the polynomial coefficients.
+    for ( int n = 0; n < num_vec; ++n )
+    {
+	for ( int p = 0; p < poly_size; ++p )
+	{
+	    for ( int i = 0; i < d_num_sources; ++i )
+	    {
+		a[n*d_num_sources + i] -= 
+		    d_W[p*d_num_sources + i] * c[n*poly_size + p];
+	    }
+	}
+    }
+
+    // Write the result.
+    Y.scale( beta );
+    Teuchos::ArrayRCP<Teuchos::ArrayRCP<double> > y_view = 
+	Y.get2dViewNonConst();
+    for ( int n = 0; n < num_vec; ++n )
+    {
+	for ( int i = 0; i < d_num_sources; ++i )
+	{
+	    y_view[n][ d_source_lids[i] ] += alpha * a[n*d_num_sources + i];
+	}
+	for ( int p = 0; p < poly_size; ++p )
+	{
+	    if ( Teuchos::OrdinalTraits<int>::invalid() != d_poly_lids[p] )
+	    {
+		y_view[n][ d_poly_lids[p] ] += alpha * c[n*poly_size + p];
+	    }
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Assemble the lower triangle of the basis matrix of a block with a
+ * diagonal shift and factor it. Return the LAPACK info.
+ */
+template<class Basis,int DIM>
+int SplineBlockJacobiPreconditioner<Basis,DIM>::factorBlock(
+    const Basis& basis,
+    const double* centers,
+    const int block_size,
+    const double shift,
+    double* A )
+{
+    for ( int j = 0; j < block_size; ++j )
+    {
+	for ( int i = j; i < block_size; ++i )
+	{
+	    A[j*block_size + i] = BP::evaluateValue( 
+		basis, EuclideanDistance<DIM>::distance(
+		    centers + DIM*i, centers + DIM*j) );
+	}
+	A[j*block_size + j] += shift;
+    }
+    Teuchos::LAPACK<int,double> lapack;
+    int info = 0;
+    lapack.POTRF( 'L', block_size, A, block_size, &info );
+    return info;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Apply the inverse of the block basis matrix in place to a set of
+ * column-major local source vectors.
+ */
+template<class Basis,int DIM>
+void SplineBlockJacobiPreconditioner<Basis,DIM>::solveBlocks( 
+    double* vectors, const int num_vec ) const
+{
+    int num_blocks = d_block_offsets.size() - 1;
+    const int* block_offsets = d_block_offsets.getRawPtr();
+    const int* factor_offsets = d_factor_offsets.getRawPtr();
+    const double* factors = d_factors.getRawPtr();
+    const int num_sources = d_num_sources;
+    Teuchos::Array<int> block_info( num_blocks, 0 );
+    int* info = block_info.getRawPtr();
+#if HAVE_DTK_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for ( int b = 0; b < num_blocks; ++b )
+    {
+	int begin = block_offsets[b];
+	int block_size = block_offsets[b+1] - begin;
+	Teuchos::LAPACK<int,double> lapack;
+	lapack.POTRS( 'L', block_size, num_vec, factors + factor_offsets[b],
+		      block_size, vectors + begin, num_sources, info + b );
+    }
+    for ( int b = 0; b < num_blocks; ++b )
+    {
+	DTK_CHECK( 0 == block_info[b] );
+    }
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+
+#endif // end DTK_SPLINEBLOCKJACOBIPRECONDITIONER_IMPL_HPP
+
+//---------------------------------------------------------------------------//
+// end DTK_SplineBlockJacobiPreconditioner_impl.hpp
+//---------------------------------------------------------------------------//
@@ -60,6 +60,12 @@ namespace DataTransferKit
 /*!
  * \class SplineCoefficientMatrix
  * \brief Sparse spline coefficient matrix.
+ *
+ * The coefficient matrix is C = P + M + P^T. By default P is kept as an
+ * implicit polynomial operator and M as a sparse matrix. If the matrix is
+ * assembled then all of C, including the dense polynomial rows and columns,
+ * is stored in a single sparse matrix available through getC() and the
+ * components are not built.
  */
 //---------------------------------------------------------------------------//
 template<class Basis,int DIM>
@@ -80,7 +86,8 @@ class SplineCoefficientMatrix
 	const Teuchos::ArrayView<const double>& dist_source_centers,
 	const Teuchos::ArrayView<const std::size_t>& dist_source_center_gids,
 	const SplineInterpolationPairing<DIM>& source_pairings,
-	const Basis& basis );
+	const Basis& basis,
+	const bool assemble = false );
 
     //! Destructor.
     ~SplineCoefficientMatrix()
@@ -94,6 +101,24 @@ class SplineCoefficientMatrix
     Teuchos::RCP<Tpetra::Operator<double,int,std::size_t> > getP()
     { return d_P; }
 
+    // Get the assembled coefficient matrix.
+    Teuchos::RCP<Tpetra::Operator<double,int,std::size_t> > getC()
+    { return d_C; }
+
+  private:
+
+    // Build the polynomial component.
+    void buildP(
+	const Teuchos::RCP<const Tpetra::Map<int,std::size_t> >& operator_map,
+	const Teuchos::ArrayView<const double>& source_centers,
+	const Teuchos::ArrayView<const std::size_t>& source_center_gids );
+
+    // Insert the polynomial rows and columns into the assembled matrix.
+    void assembleP(
+	const Teuchos::RCP<const Tpetra::Map<int,std::size_t> >& operator_map,
+	const Teuchos::ArrayView<const double>& source_centers,
+	const Teuchos::ArrayView<const std::size_t>& source_center_gids );
+
   private:
 
     // The M matrix.
@@ -102,6 +127,9 @@ class SplineCoefficientMatrix
     // The P matrix.
     Teuchos::RCP<PolynomialMatrix<std::size_t> > d_P;
 
+    // The assembled C matrix.
+    Teuchos::RCP<Tpetra::CrsMatrix<double,int,std::size_t> > d_C;
+
 };
 
 //---------------------------------------------------------------------------//
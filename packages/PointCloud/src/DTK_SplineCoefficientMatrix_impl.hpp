@@ -46,6 +46,8 @@
 
 #include <Teuchos_Array.hpp>
 
+#include <algorithm>
+
 namespace DataTransferKit
 {
 //---------------------------------------------------------------------------//
@@ -60,7 +62,8 @@ SplineCoefficientMatrix<Basis,DIM>::SplineCoefficientMatrix(
     const Teuchos::ArrayView<const double>& dist_source_centers,
     const Teuchos::ArrayView<const std::size_t>& dist_source_center_gids,
     const SplineInterpolationPairing<DIM>& source_pairings,
-    const Basis& basis )
+    const Basis& basis,
+    const bool assemble )
 {
     DTK_CHECK( 0 == source_centers.size() % DIM );
     DTK_CHECK( source_centers.size() / DIM == 
@@ -72,33 +75,47 @@ SplineCoefficientMatrix<Basis,DIM>::SplineCoefficientMatrix(
     // Get the number of source centers.
     unsigned num_source_centers = source_center_gids.size();
 
-    // Create the P matrix.
-    int offset = DIM + 1;
-    Teuchos::RCP<Tpetra::MultiVector<double,int,std::size_t> > P_vec = 
-	Tpetra::createMultiVector<double,int,std::size_t>( operator_map, offset );
-    int di = 0; 
-    for ( unsigned i = 0; i < num_source_centers; ++i )
+    // Create the P matrix if it is not assembled.
+    if ( !assemble )
     {
-	P_vec->replaceGlobalValue( source_center_gids[i], 0, 1.0 );
-	di = DIM*i;
-	for ( int d = 0; d < DIM; ++d )
-	{
-	    P_vec->replaceGlobalValue( 
-		source_center_gids[i], d+1, source_centers[di+d] );
-	}
+	buildP( operator_map, source_centers, source_center_gids );
     }
-    d_P =Teuchos::rcp(
-	new PolynomialMatrix<std::size_t>(P_vec,operator_map,operator_map) );
 
-    // Create the M matrix.
+    // Create the M matrix. The row sizes are known exactly from the
+    // pairings. If the coefficient matrix is assembled then each source row
+    // also has an entry in each of the polynomial columns and the dense
+    // polynomial rows are inserted from every process so the matrix must be
+    // able to grow.
     Teuchos::ArrayRCP<std::size_t> children_per_parent =
 	source_pairings.childrenPerParent();
-    std::size_t max_entries_per_row = *std::max_element( 
-	children_per_parent.begin(), children_per_parent.end() );
-    d_M = Teuchos::rcp( new Tpetra::CrsMatrix<double,int,std::size_t>(
-			    operator_map, max_entries_per_row) );
+    std::size_t max_entries_per_row = children_per_parent.size() ?
+	*std::max_element( children_per_parent.begin(), 
+			   children_per_parent.end() ) : 0;
+    Teuchos::RCP<Tpetra::CrsMatrix<double,int,std::size_t> > matrix;
+    if ( assemble )
+    {
+	matrix = Teuchos::rcp( new Tpetra::CrsMatrix<double,int,std::size_t>(
+				   operator_map, 
+				   max_entries_per_row + DIM + 1,
+				   Tpetra::DynamicProfile) );
+    }
+    else
+    {
+	Teuchos::ArrayRCP<std::size_t> entries_per_row( 
+	    operator_map->getNodeNumElements(), 0 );
+	for ( unsigned i = 0; i < num_source_centers; ++i )
+	{
+	    entries_per_row[ 
+		operator_map->getLocalElement(source_center_gids[i]) ] =
+		children_per_parent[i];
+	}
+	matrix = Teuchos::rcp( new Tpetra::CrsMatrix<double,int,std::size_t>(
+				   operator_map, entries_per_row,
+				   Tpetra::StaticProfile) );
+    }
     Teuchos::Array<std::size_t> M_indices( max_entries_per_row );
     Teuchos::Array<double> values( max_entries_per_row );
+    int di = 0; 
     int dj = 0;
     Teuchos::ArrayView<const unsigned> source_neighbors;
     double dist = 0.0;
@@ -122,12 +139,122 @@ SplineCoefficientMatrix<Basis,DIM>::SplineCoefficientMatrix(
 
     	    values[j] = BP::evaluateValue( basis, dist );
     	}
-	d_M->insertGlobalValues( 
+	matrix->insertGlobalValues( 
 	    source_center_gids[i], M_indices(0,nsn), values(0,nsn) );
     }
-    d_M->fillComplete();
 
-    DTK_ENSURE( d_M->isFillComplete() );
+    // Add the polynomial components if assembled.
+    if ( assemble )
+    {
+	d_C = matrix;
+	assembleP( operator_map, source_centers, source_center_gids );
+    }
+    else
+    {
+	d_M = matrix;
+    }
+    matrix->fillComplete();
+
+    DTK_ENSURE( matrix->isFillComplete() );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Build the polynomial component.
+ */
+template<class Basis,int DIM>
+void SplineCoefficientMatrix<Basis,DIM>::buildP(
+    const Teuchos::RCP<const Tpetra::Map<int,std::size_t> >& operator_map,
+    const Teuchos::ArrayView<const double>& source_centers,
+    const Teuchos::ArrayView<const std::size_t>& source_center_gids )
+{
+    unsigned num_source_centers = source_center_gids.size();
+    int offset = DIM + 1;
+    Teuchos::RCP<Tpetra::MultiVector<double,int,std::size_t> > P_vec = 
+	Tpetra::createMultiVector<double,int,std::size_t>( operator_map, offset );
+    int di = 0; 
+    for ( unsigned i = 0; i < num_source_centers; ++i )
+    {
+	P_vec->replaceGlobalValue( source_center_gids[i], 0, 1.0 );
+	di = DIM*i;
+	for ( int d = 0; d < DIM; ++d )
+	{
+	    P_vec->replaceGlobalValue( 
+		source_center_gids[i], d+1, source_centers[di+d] );
+	}
+    }
+
+    // The polynomial coefficients are the last DIM+1 global ids of the
+    // operator map.
+    Teuchos::Array<std::size_t> poly_gids( offset );
+    std::size_t poly_gid_begin = operator_map->getMaxAllGlobalIndex() - DIM;
+    for ( int p = 0; p < offset; ++p )
+    {
+	poly_gids[p] = poly_gid_begin + p;
+    }
+    d_P =Teuchos::rcp( new PolynomialMatrix<std::size_t>(
+			   P_vec,operator_map,operator_map,poly_gids()) );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Insert the polynomial rows and columns into the assembled matrix.
+ */
+template<class Basis,int DIM>
+void SplineCoefficientMatrix<Basis,DIM>::assembleP(
+    const Teuchos::RCP<const Tpetra::Map<int,std::size_t> >& operator_map,
+    const Teuchos::ArrayView<const double>& source_centers,
+    const Teuchos::ArrayView<const std::size_t>& source_center_gids )
+{
+    DTK_REQUIRE( Teuchos::nonnull(d_C) );
+
+    // The polynomial unknowns are the last DIM+1 global ids of the operator
+    // map as constructed by the prolongation operator.
+    int poly_size = DIM + 1;
+    std::size_t poly_gid_begin = operator_map->getMaxAllGlobalIndex() - DIM;
+    Teuchos::Array<std::size_t> poly_gids( poly_size );
+    for ( int p = 0; p < poly_size; ++p )
+    {
+	poly_gids[p] = poly_gid_begin + p;
+    }
+
+    // Nothing to add if there are no local source centers.
+    unsigned num_source_centers = source_center_gids.size();
+    if ( 0 == num_source_centers )
+    {
+	return;
+    }
+
+    // Add the P columns to each source row.
+    Teuchos::Array<double> poly_values( poly_size );
+    poly_values[0] = 1.0;
+    int di = 0;
+    for ( unsigned i = 0; i < num_source_centers; ++i )
+    {
+	di = DIM*i;
+	for ( int d = 0; d < DIM; ++d )
+	{
+	    poly_values[d+1] = source_centers[di+d];
+	}
+	d_C->insertGlobalValues( 
+	    source_center_gids[i], poly_gids(), poly_values() );
+    }
+
+    // Add the local source center columns to the P^T rows. The polynomial
+    // rows are not owned by every process and the off-process entries are
+    // communicated and summed when the matrix is filled.
+    Teuchos::Array<double> row_values( num_source_centers );
+    std::fill( row_values.begin(), row_values.end(), 1.0 );
+    d_C->insertGlobalValues( poly_gids[0], source_center_gids, row_values() );
+    for ( int d = 0; d < DIM; ++d )
+    {
+	for ( unsigned i = 0; i < num_source_centers; ++i )
+	{
+	    row_values[i] = source_centers[DIM*i+d];
+	}
+	d_C->insertGlobalValues( 
+	    poly_gids[d+1], source_center_gids, row_values() );
+    }
 }
 
 //---------------------------------------------------------------------------//
@@ -88,8 +88,17 @@ SplineEvaluationMatrix<Basis,DIM>::SplineEvaluationMatrix(
 		target_center_gids[i], d+1, target_centers[di+d] );
 	}
     }
-    d_Q = Teuchos::rcp( 
-	new PolynomialMatrix<std::size_t>(Q_vec,domain_map,range_map) );
+
+    // The polynomial coefficients are the last DIM+1 global ids of the
+    // domain map.
+    Teuchos::Array<std::size_t> poly_gids( offset );
+    std::size_t poly_gid_begin = domain_map->getMaxAllGlobalIndex() - DIM;
+    for ( int p = 0; p < offset; ++p )
+    {
+	poly_gids[p] = poly_gid_begin + p;
+    }
+    d_Q = Teuchos::rcp( new PolynomialMatrix<std::size_t>(
+			    Q_vec,domain_map,range_map,poly_gids()) );
 
     // Create the N matrix.
     Teuchos::ArrayRCP<std::size_t> children_per_parent =
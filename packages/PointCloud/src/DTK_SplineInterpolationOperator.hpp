@@ -43,6 +43,9 @@
 
 #include "DTK_MapOperator.hpp"
 #include "DTK_RadialBasisPolicy.hpp"
+#include "DTK_CenterDistributor.hpp"
+#include "DTK_SplineNeighborhood.hpp"
+#include "DTK_SplineNeighborhoodCache.hpp"
 
 #include <Teuchos_RCP.hpp>
 #include <Teuchos_Comm.hpp>
@@ -61,6 +64,48 @@ namespace DataTransferKit
  *
  * The SplineInterpolationOperator is the top-level driver for parallel interpolation
  * problems.
+ *
+ * All source centers within the radius of a center are coupled to it. The
+ * "Nearest Neighbor" type of search of the moving least square operator is
+ * not supported as a truncated stencil would not give a symmetric positive
+ * definite coefficient matrix.
+ *
+ * The coefficient matrix C = P + M + P^T is applied as a composite of its
+ * components by default. Setting "Assemble Coefficient Matrix" to true
+ * instead assembles C, including the dense polynomial rows and columns, into
+ * a single sparse matrix so each solver iteration is one matrix-vector
+ * product and algebraic preconditioners may be configured through the
+ * "Stratimikos" sublist.
+ *
+ * A built-in non-overlapping block Jacobi preconditioner with a coarse
+ * polynomial correction is available for the coefficient matrix by setting
+ * the "Preconditioner Type" in the "Stratimikos" sublist to "Spline Block
+ * Jacobi". Its "Max Block Size" parameter bounds the size of the local
+ * dense block solves.
+ *
+ * The solver and any preconditioner are built once in setup and reused by
+ * every application, so a recycling Krylov solver such as the Belos
+ * "GCRODR" solver keeps its subspace between applications. Setting "Reuse
+ * Solution" to true additionally starts each solve from the solution of the
+ * previous application which is effective when the source field changes
+ * slowly between transfers.
+ *
+ * All fields in a multivector are solved for together. If no Belos solver
+ * type is given, a "Number of Fields" greater than one selects a Block GMRES
+ * solver with that block size so the fields share one Krylov space.
+ *
+ * The DIM+1 polynomial coefficients of the spline are placed on the root
+ * process by default. Setting "Polynomial Placement" to "Balanced" spreads
+ * them over the processes so the dense polynomial rows of the coefficient
+ * matrix do not all land on one process.
+ *
+ * Setting "Neighbor Discovery" to "Rendezvous" finds the neighbor processes
+ * of the source centers without gathering the domains of all processes.
+ *
+ * The source/source and source/target neighborhoods, including their
+ * searches and halo exchanges, may be shared with other spline and moving
+ * least square operators over the same clouds and radius by giving each
+ * operator the same SplineNeighborhoodCache.
  */
 //---------------------------------------------------------------------------//
 template<class Scalar,class Basis,int DIM>
@@ -103,6 +148,12 @@ class SplineInterpolationOperator : public MapOperator<Scalar>
 		const Teuchos::RCP<const typename Base::TpetraMap>& range_map,
 		const Teuchos::RCP<FunctionSpace>& range_space,
 		const Teuchos::RCP<Teuchos::ParameterList>& parameters );
+
+    // Share the source/source and source/target neighborhoods with other
+    // operators through a cache. Must be called before setup.
+    void setNeighborhoodCache(
+	const Teuchos::RCP<SplineNeighborhoodCache<DIM> >& cache )
+    { d_neighborhood_cache = cache; }
     
   private:
 
@@ -112,15 +163,29 @@ class SplineInterpolationOperator : public MapOperator<Scalar>
 	const Teuchos::RCP<FunctionSpace>& range_space,
 	const Teuchos::RCP<Teuchos::ParameterList>& parameters,
 	Teuchos::RCP<const Root>& S,
+	Teuchos::RCP<const Root>& C,
 	Teuchos::RCP<const Root>& P,
 	Teuchos::RCP<const Root>& M,
 	Teuchos::RCP<const Root>& Q,
-	Teuchos::RCP<const Root>& N ) const;
+	Teuchos::RCP<const Root>& N,
+	Teuchos::RCP<const Root>& C_prec ) const;
+
+    // Get the radius neighborhood of the given centers.
+    Teuchos::RCP<const SplineNeighborhood<DIM> > createNeighborhood(
+	const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+	const Teuchos::ArrayView<const double>& source_centers,
+	const Teuchos::ArrayView<const GO>& source_gids,
+	const Teuchos::ArrayView<const double>& target_centers,
+	const bool rendezvous ) const;
 
   private:
 
     // Support radius.
     double d_radius;
+
+    // Neighborhood cache shared with other operators. Null if the
+    // neighborhoods are not shared.
+    Teuchos::RCP<SplineNeighborhoodCache<DIM> > d_neighborhood_cache;
 };
 
 //---------------------------------------------------------------------------//
@@ -43,10 +43,13 @@
 
 #include "DTK_DBC.hpp"
 #include "DTK_CenterDistributor.hpp"
-#include "DTK_SplineInterpolationPairing.hpp"
+#include "DTK_SplineNeighborhood.hpp"
 #include "DTK_SplineCoefficientMatrix.hpp"
 #include "DTK_SplineEvaluationMatrix.hpp"
 #include "DTK_SplineProlongationOperator.hpp"
+#include "DTK_SplineBlockJacobiPreconditioner.hpp"
+#include "DTK_SplinePreconditionerFactory.hpp"
+#include "DTK_SplineInverseOperator.hpp"
 
 #include <Teuchos_CommHelpers.hpp>
 #include <Teuchos_Ptr.hpp>
@@ -108,6 +111,9 @@ void SplineInterpolationOperator<Scalar,Basis,DIM>::setup(
     // Prolongation operator.
     Teuchos::RCP<const Root> S;
 
+    // Assembled coefficient matrix.
+    Teuchos::RCP<const Root> C;
+
     // Coefficient matrix polynomial component.
     Teuchos::RCP<const Root> P;
 
@@ -120,8 +126,12 @@ void SplineInterpolationOperator<Scalar,Basis,DIM>::setup(
     // Evaluation matrix basis component.
     Teuchos::RCP<const Root> N;
 
+    // Coefficient matrix preconditioner.
+    Teuchos::RCP<const Root> C_prec;
+
     // Build the concrete operators.
-    buildConcreteOperators( domain_space, range_space, parameters, S, P, M, Q, N );
+    buildConcreteOperators( 
+	domain_space, range_space, parameters, S, C, P, M, Q, N, C_prec );
 
     // Create an abstract wrapper for S.
     Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > thyra_range_vector_space_S =
@@ -134,28 +144,6 @@ void SplineInterpolationOperator<Scalar,Basis,DIM>::setup(
 	thyra_S)->constInitialize( 
 	    thyra_range_vector_space_S, thyra_domain_vector_space_S, S );
 
-    // Create an abstract wrapper for P.
-    Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > thyra_range_vector_space_P =
-    	Thyra::createVectorSpace<Scalar>( P->getRangeMap() );
-    Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > thyra_domain_vector_space_P =
-    	Thyra::createVectorSpace<Scalar>( P->getDomainMap() );
-    Teuchos::RCP<const Thyra::TpetraLinearOp<Scalar,LO,GO> > thyra_P =
-    	Teuchos::rcp( new Thyra::TpetraLinearOp<Scalar,LO,GO>() );
-    Teuchos::rcp_const_cast<Thyra::TpetraLinearOp<Scalar,LO,GO> >(
-	thyra_P)->constInitialize( 
-	    thyra_range_vector_space_P, thyra_domain_vector_space_P, P );
-
-    // Create an abstract wrapper for M.
-    Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > thyra_range_vector_space_M =
-    	Thyra::createVectorSpace<Scalar>( M->getRangeMap() );
-    Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > thyra_domain_vector_space_M =
-    	Thyra::createVectorSpace<Scalar>( M->getDomainMap() );
-    Teuchos::RCP<const Thyra::TpetraLinearOp<Scalar,LO,GO> > thyra_M =
-    	Teuchos::rcp( new Thyra::TpetraLinearOp<Scalar,LO,GO>() );
-    Teuchos::rcp_const_cast<Thyra::TpetraLinearOp<Scalar,LO,GO> >(
-	thyra_M)->constInitialize( 
-	    thyra_range_vector_space_M, thyra_domain_vector_space_M, M );
-
     // Create an abstract wrapper for Q.
     Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > thyra_range_vector_space_Q =
     	Thyra::createVectorSpace<Scalar>( Q->getRangeMap() );
@@ -179,15 +167,57 @@ void SplineInterpolationOperator<Scalar,Basis,DIM>::setup(
 		thyra_range_vector_space_N, thyra_domain_vector_space_N, N );
 
     // COUPLING MATRIX ASSEMBLY: A = (Q + N)*[(P + M + P^T)^-1]*S
-    // Create a transpose of P.
-    Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > thyra_P_T =
-	Thyra::transpose<Scalar>( thyra_P );
+    Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > thyra_C;
 
-    // Create a composite operator C = (P + M + P^T)
-    Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > thyra_PpM =
-	Thyra::add<Scalar>( thyra_P, thyra_M );
-    Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > thyra_C =
-	Thyra::add<Scalar>( thyra_PpM, thyra_P_T );
+    // Create an abstract wrapper for the assembled C.
+    if ( Teuchos::nonnull(C) )
+    {
+	Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > thyra_range_vector_space_C =
+	    Thyra::createVectorSpace<Scalar>( C->getRangeMap() );
+	Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > thyra_domain_vector_space_C =
+	    Thyra::createVectorSpace<Scalar>( C->getDomainMap() );
+	Teuchos::RCP<const Thyra::TpetraLinearOp<Scalar,LO,GO> > thyra_C_assembled =
+	    Teuchos::rcp( new Thyra::TpetraLinearOp<Scalar,LO,GO>() );
+	Teuchos::rcp_const_cast<Thyra::TpetraLinearOp<Scalar,LO,GO> >(
+	    thyra_C_assembled)->constInitialize( 
+		thyra_range_vector_space_C, thyra_domain_vector_space_C, C );
+	thyra_C = thyra_C_assembled;
+    }
+
+    // Otherwise build C from its components.
+    else
+    {
+	// Create an abstract wrapper for P.
+	Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > thyra_range_vector_space_P =
+	    Thyra::createVectorSpace<Scalar>( P->getRangeMap() );
+	Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > thyra_domain_vector_space_P =
+	    Thyra::createVectorSpace<Scalar>( P->getDomainMap() );
+	Teuchos::RCP<const Thyra::TpetraLinearOp<Scalar,LO,GO> > thyra_P =
+	    Teuchos::rcp( new Thyra::TpetraLinearOp<Scalar,LO,GO>() );
+	Teuchos::rcp_const_cast<Thyra::TpetraLinearOp<Scalar,LO,GO> >(
+	    thyra_P)->constInitialize( 
+		thyra_range_vector_space_P, thyra_domain_vector_space_P, P );
+
+	// Create an abstract wrapper for M.
+	Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > thyra_range_vector_space_M =
+	    Thyra::createVectorSpace<Scalar>( M->getRangeMap() );
+	Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > thyra_domain_vector_space_M =
+	    Thyra::createVectorSpace<Scalar>( M->getDomainMap() );
+	Teuchos::RCP<const Thyra::TpetraLinearOp<Scalar,LO,GO> > thyra_M =
+	    Teuchos::rcp( new Thyra::TpetraLinearOp<Scalar,LO,GO>() );
+	Teuchos::rcp_const_cast<Thyra::TpetraLinearOp<Scalar,LO,GO> >(
+	    thyra_M)->constInitialize( 
+		thyra_range_vector_space_M, thyra_domain_vector_space_M, M );
+
+	// Create a transpose of P.
+	Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > thyra_P_T =
+	    Thyra::transpose<Scalar>( thyra_P );
+
+	// Create a composite operator C = (P + M + P^T)
+	Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > thyra_PpM =
+	    Thyra::add<Scalar>( thyra_P, thyra_M );
+	thyra_C = Thyra::add<Scalar>( thyra_PpM, thyra_P_T );
+    }
 
     // Create the inverse of the composite operator C.
     Teuchos::RCP<Teuchos::ParameterList> builder_params;
@@ -205,12 +235,78 @@ void SplineInterpolationOperator<Scalar,Basis,DIM>::setup(
     {
 	builder_params->set<std::string>("Linear Solver Type","Belos");
     }
+
+    // If no Belos solver was selected and several fields are transferred
+    // together then solve for them with a block solver sharing one Krylov
+    // space.
+    if ( "Belos" == builder_params->get<std::string>("Linear Solver Type") )
+    {
+	Teuchos::ParameterList& belos_params = 
+	    builder_params->sublist("Linear Solver Types").sublist("Belos");
+	if ( !belos_params.isParameter("Solver Type") )
+	{
+	    int num_fields = 1;
+	    if ( parameters->isParameter("Number of Fields") )
+	    {
+		num_fields = parameters->get<int>("Number of Fields");
+	    }
+	    if ( 1 < num_fields )
+	    {
+		belos_params.set<std::string>("Solver Type","Block GMRES");
+		Teuchos::ParameterList& block_params =
+		    belos_params.sublist("Solver Types").sublist("Block GMRES");
+		if ( !block_params.isParameter("Block Size") )
+		{
+		    block_params.set<int>("Block Size",num_fields);
+		}
+	    }
+	}
+    }
+
     Stratimikos::DefaultLinearSolverBuilder builder;
+
+    // If the built-in preconditioner was built then register it as a
+    // preconditioning strategy.
+    if ( Teuchos::nonnull(C_prec) )
+    {
+	Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > thyra_range_vector_space_C_prec =
+	    Thyra::createVectorSpace<Scalar>( C_prec->getRangeMap() );
+	Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > thyra_domain_vector_space_C_prec =
+	    Thyra::createVectorSpace<Scalar>( C_prec->getDomainMap() );
+	Teuchos::RCP<const Thyra::TpetraLinearOp<Scalar,LO,GO> > thyra_C_prec =
+	    Teuchos::rcp( new Thyra::TpetraLinearOp<Scalar,LO,GO>() );
+	Teuchos::rcp_const_cast<Thyra::TpetraLinearOp<Scalar,LO,GO> >(
+	    thyra_C_prec)->constInitialize( 
+		thyra_range_vector_space_C_prec, 
+		thyra_domain_vector_space_C_prec, 
+		C_prec );
+	builder.setPreconditioningStrategyFactory(
+	    Teuchos::rcp( new SplinePreconditionerStrategy<Scalar>(thyra_C_prec) ),
+	    "Spline Block Jacobi" );
+    }
+
     builder.setParameterList( builder_params );
     Teuchos::RCP<Thyra::LinearOpWithSolveFactoryBase<Scalar> > factory = 
 	Thyra::createLinearSolveStrategy( builder );
-    Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > thyra_C_inv =
-    	Thyra::inverse<Scalar>( *factory, thyra_C );
+    Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > thyra_C_inv;
+
+    // If the solution is reused between applications then start each solve
+    // from the previous solution. Otherwise start from zero.
+    bool reuse_solution = false;
+    if ( parameters->isParameter("Reuse Solution") )
+    {
+	reuse_solution = parameters->get<bool>("Reuse Solution");
+    }
+    if ( reuse_solution )
+    {
+	thyra_C_inv = Teuchos::rcp( 
+	    new SplineInverseOperator<Scalar>(
+		Thyra::linearOpWithSolve<Scalar>(*factory, thyra_C)) );
+    }
+    else
+    {
+	thyra_C_inv = Thyra::inverse<Scalar>( *factory, thyra_C );
+    }
 
     // Create the composite operator B = (Q + N);
     Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > thyra_B =
@@ -232,10 +328,12 @@ void SplineInterpolationOperator<Scalar,Basis,DIM>::buildConcreteOperators(
 	const Teuchos::RCP<FunctionSpace>& range_space,
 	const Teuchos::RCP<Teuchos::ParameterList>& parameters,
 	Teuchos::RCP<const Root>& S,
+	Teuchos::RCP<const Root>& C,
 	Teuchos::RCP<const Root>& P,
 	Teuchos::RCP<const Root>& M,
 	Teuchos::RCP<const Root>& Q,
-	Teuchos::RCP<const Root>& N ) const
+	Teuchos::RCP<const Root>& N,
+	Teuchos::RCP<const Root>& C_prec ) const
 {
     // Determine if we have range and domain data on this process.
     bool nonnull_domain = Teuchos::nonnull( domain_space->entitySet() );
@@ -290,28 +388,69 @@ void SplineInterpolationOperator<Scalar,Basis,DIM>::buildConcreteOperators(
 	    *range_entity, target_centers(DIM*entity_counter,DIM) );
     }
 
+    // Only radius supports are allowed. A k nearest neighbor stencil is not
+    // symmetric (j in kNN(i) does not imply i in kNN(j)) so the truncated
+    // coefficient matrix would be neither symmetric nor positive definite
+    // and the spline would lose its interpolation property.
+    if ( parameters->isParameter("Type of Search") )
+    {
+	DTK_INSIST( "Radius" == 
+		    parameters->get<std::string>("Type of Search") );
+    }
+
+    // Determine how the neighbor processes are found.
+    bool rendezvous = 
+	CenterDistributor<DIM>::rendezvousDiscovery( *parameters );
+
+    // Determine if the coefficient matrix should be assembled.
+    bool assemble_C = false;
+    if ( parameters->isParameter("Assemble Coefficient Matrix") )
+    {
+	assemble_C = parameters->get<bool>("Assemble Coefficient Matrix");
+    }
+
+    // Determine the placement of the polynomial coefficients. By default
+    // they are all placed on the root process. A balanced placement spreads
+    // them over the processes so that with at least DIM+1 processes none
+    // owns more than one.
+    bool balance_poly = false;
+    if ( parameters->isParameter("Polynomial Placement") )
+    {
+	if ( "Balanced" == 
+	     parameters->get<std::string>("Polynomial Placement") )
+	{
+	    balance_poly = true;
+	}
+	else
+	{
+	    DTK_INSIST( "Root" == 
+			parameters->get<std::string>("Polynomial Placement") );
+	}
+    }
+
     // PROLONGATION OPERATOR.
-    GO offset = comm->getRank() ? 0 : DIM + 1;
+    int poly_size = DIM + 1;
+    GO offset = comm->getRank() ? 0 : poly_size;
+    if ( balance_poly )
+    {
+	offset = 0;
+	for ( int p = 0; p < poly_size; ++p )
+	{
+	    if ( comm->getRank() == (p * comm->getSize()) / poly_size )
+	    {
+		++offset;
+	    }
+	}
+    }
     S =	Teuchos::rcp( 
 	new SplineProlongationOperator<Scalar,GO>(offset,this->b_domain_map) );
 
     // COEFFICIENT OPERATORS.
-    // Gather the source centers that are within a radius of the source
-    // centers on this proc.
-    Teuchos::Array<double> dist_sources;
-    CenterDistributor<DIM> source_distributor( 
-	comm, source_centers(), source_centers(), d_radius, dist_sources );
-    
-    // Distribute the global source ids.
-    Teuchos::Array<GO> dist_source_gids( 
-	source_distributor.getNumImports() );
-    Teuchos::ArrayView<const GO> source_gids_view = source_gids();
-    Teuchos::ArrayView<GO> dist_gids_view = dist_source_gids();
-    source_distributor.distribute( source_gids_view, dist_gids_view );
-
-    // Build the source/source pairings.
-    SplineInterpolationPairing<DIM> source_pairings( 
-	dist_sources(), source_centers(), d_radius );
+    // Get the source centers that are within a radius of the source
+    // centers on this proc and their pairings.
+    Teuchos::RCP<const SplineNeighborhood<DIM> > source_neighborhood =
+	createNeighborhood( comm, source_centers(), source_gids(),
+			    source_centers(), rendezvous );
 
     // Build the basis.
     Teuchos::RCP<Basis> basis = BP::create( d_radius );
@@ -320,50 +459,99 @@ void SplineInterpolationOperator<Scalar,Basis,DIM>::buildConcreteOperators(
     Teuchos::RCP<const Tpetra::Map<int,GO> > prolongated_map = S->getRangeMap();
 
     // Build the coefficient operators.
-    SplineCoefficientMatrix<Basis,DIM> C( 
+    SplineCoefficientMatrix<Basis,DIM> coeff_mtx( 
 	prolongated_map,
 	source_centers(), source_gids(),
-	dist_sources(), dist_source_gids(),
-	source_pairings, *basis );
-    P = C.getP();
-    M = C.getM();
+	source_neighborhood->distributedSourceCenters(),
+	source_neighborhood->distributedSourceGids(),
+	source_neighborhood->pairings(), *basis, assemble_C );
+    C = coeff_mtx.getC();
+    P = coeff_mtx.getP();
+    M = coeff_mtx.getM();
+
+    // Build the block Jacobi preconditioner if it was selected in the solver
+    // parameters.
+    if ( parameters->isSublist("Stratimikos") )
+    {
+	Teuchos::ParameterList& solver_params = 
+	    parameters->sublist("Stratimikos");
+	if ( solver_params.isParameter("Preconditioner Type") &&
+	     "Spline Block Jacobi" == 
+	     solver_params.get<std::string>("Preconditioner Type") )
+	{
+	    int max_block_size = 1000;
+	    Teuchos::ParameterList& block_params =
+		solver_params.sublist("Preconditioner Types").sublist(
+		    "Spline Block Jacobi" );
+	    if ( block_params.isParameter("Max Block Size") )
+	    {
+		max_block_size = block_params.get<int>("Max Block Size");
+	    }
+	    C_prec = Teuchos::rcp( 
+		new SplineBlockJacobiPreconditioner<Basis,DIM>(
+		    prolongated_map, source_centers(), source_gids(),
+		    *basis, max_block_size) );
+	}
+    }
 
-    // Cleanup.
-    dist_source_gids.clear();
+    // Cleanup. A cached neighborhood is still held by the cache.
+    source_neighborhood = Teuchos::null;
     
     // EVALUATION OPERATORS. 
-    // Gather the source centers that are within a radius of the target
-    // centers on this proc.
-    CenterDistributor<DIM> target_distributor( 
-	comm, source_centers(), target_centers(), d_radius, dist_sources  );
-
-    // Distribute the global source ids.
-    dist_source_gids.resize( 
-	target_distributor.getNumImports() );
-    source_gids_view = source_gids();
-    dist_gids_view = dist_source_gids();
-    target_distributor.distribute( source_gids_view, dist_gids_view );
-
-    // Build the source/target pairings.
-    SplineInterpolationPairing<DIM> target_pairings( 
-	dist_sources(), target_centers(), d_radius );
+    // Get the source centers that are within a radius of the target
+    // centers on this proc and their pairings.
+    Teuchos::RCP<const SplineNeighborhood<DIM> > target_neighborhood =
+	createNeighborhood( comm, source_centers(), source_gids(),
+			    target_centers(), rendezvous );
 
     // Build the transformation operators.
     SplineEvaluationMatrix<Basis,DIM> B( 
 	prolongated_map, this->b_range_map, 
 	target_centers(), target_gids(),
-	dist_sources(), dist_source_gids(),
-	target_pairings, *basis );
+	target_neighborhood->distributedSourceCenters(),
+	target_neighborhood->distributedSourceGids(),
+	target_neighborhood->pairings(), *basis );
     N = B.getN();
     Q = B.getQ();
     
     DTK_ENSURE( Teuchos::nonnull(S) );
-    DTK_ENSURE( Teuchos::nonnull(P) );
-    DTK_ENSURE( Teuchos::nonnull(M) );
+    DTK_ENSURE( Teuchos::nonnull(C) || 
+		( Teuchos::nonnull(P) && Teuchos::nonnull(M) ) );
     DTK_ENSURE( Teuchos::nonnull(Q) );
     DTK_ENSURE( Teuchos::nonnull(N) );
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get the radius neighborhood of the given centers. If a
+ * neighborhood cache was given then the neighborhood is taken from it.
+ */
+template<class Scalar,class Basis,int DIM>
+Teuchos::RCP<const SplineNeighborhood<DIM> >
+SplineInterpolationOperator<Scalar,Basis,DIM>::createNeighborhood(
+    const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+    const Teuchos::ArrayView<const double>& source_centers,
+    const Teuchos::ArrayView<const GO>& source_gids,
+    const Teuchos::ArrayView<const double>& target_centers,
+    const bool rendezvous ) const
+{
+    Teuchos::RCP<const SplineNeighborhood<DIM> > neighborhood;
+    if ( Teuchos::nonnull(d_neighborhood_cache) )
+    {
+	neighborhood = d_neighborhood_cache->getNeighborhood(
+	    comm, source_centers, source_gids, target_centers,
+	    false, 0, d_radius, rendezvous );
+    }
+    else
+    {
+	neighborhood = Teuchos::rcp( 
+	    new SplineNeighborhood<DIM>(
+		comm, source_centers, source_gids, target_centers,
+		false, 0, d_radius, rendezvous) );
+    }
+    return neighborhood;
+}
+
 //---------------------------------------------------------------------------//
 
 } // end namespace DataTransferKit
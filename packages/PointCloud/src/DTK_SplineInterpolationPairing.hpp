@@ -43,6 +43,7 @@
 
 #include <Teuchos_ArrayView.hpp>
 #include <Teuchos_Array.hpp>
+#include <Teuchos_ArrayRCP.hpp>
 
 namespace DataTransferKit
 {
@@ -53,6 +54,17 @@ namespace DataTransferKit
  *
  * Build groups of local child centers that are within the given radius of
  * the parent centers. Each parent center will have a list of child centers.
+ *
+ * Alternatively, the k nearest child centers within the given radius may be
+ * selected for each parent center to bound the size of each group. In this
+ * case each parent center also has a support radius adapted to the local
+ * density of the child centers.
+ *
+ * The pairings are stored in compressed row form with one offset per parent
+ * center into a single contiguous array of child ids sorted by distance to
+ * the parent. The child distances may optionally be stored alongside the
+ * ids. The parent centers are searched with the batched, thread-parallel
+ * search tree queries.
  */
 //---------------------------------------------------------------------------//
 template<int DIM>
@@ -64,7 +76,16 @@ class SplineInterpolationPairing
     SplineInterpolationPairing( 
 	const Teuchos::ArrayView<const double>& child_centers,
 	const Teuchos::ArrayView<const double>& parent_centers,
-	const double radius );
+	const double radius,
+	const bool store_distances = false );
+
+    // k-nearest neighbor constructor.
+    SplineInterpolationPairing( 
+	const Teuchos::ArrayView<const double>& child_centers,
+	const Teuchos::ArrayView<const double>& parent_centers,
+	const unsigned num_neighbors,
+	const double radius,
+	const bool store_distances = false );
 
     //! Destructor.
     ~SplineInterpolationPairing()
@@ -75,17 +96,59 @@ class SplineInterpolationPairing
     Teuchos::ArrayView<const unsigned> 
     childCenterIds( const unsigned parent_id ) const;
 
+    // Get the child center ids of all parent centers. The ids of parent i
+    // are [rawChildCenterIds()+rawChildCenterOffsets()[i],
+    // rawChildCenterIds()+rawChildCenterOffsets()[i+1]). Unlike the views,
+    // these pointers may be read from several threads at once.
+    const unsigned* rawChildCenterIds() const
+    { return d_child_ids.getRawPtr(); }
+
+    // Get the offsets of the child centers of each parent center into the
+    // child center ids.
+    const std::size_t* rawChildCenterOffsets() const
+    { return d_offsets.getRawPtr(); }
+
+    // Given a parent center local id get the distances to its child
+    // centers. Only available if the distances were stored.
+    Teuchos::ArrayView<const double> 
+    childCenterDistances( const unsigned parent_id ) const;
+
+    // Determine if the child center distances are stored.
+    bool hasDistances() const
+    { return d_has_distances; }
+
     // Get the number of child centers per parent center.
     Teuchos::ArrayRCP<std::size_t> childrenPerParent() const
     { return d_pair_sizes; }
 
+    // Given a parent center local id get the radius of the support of its
+    // child centers.
+    double parentSupportRadius( const unsigned parent_id ) const;
+
   private:
 
-    // Pairings.
-    Teuchos::Array<Teuchos::Array<unsigned> > d_pairings;
+    // Maximum support radius.
+    double d_radius;
+
+    // True if the child center distances are stored.
+    bool d_has_distances;
+
+    // Offset of the first child center of each parent center.
+    Teuchos::Array<std::size_t> d_offsets;
+
+    // Child center ids of all parent centers.
+    Teuchos::Array<unsigned> d_child_ids;
+
+    // Child center distances of all parent centers. Empty if the distances
+    // are not stored.
+    Teuchos::Array<double> d_child_dists;
 
     // Number of child centers per parent center.
     Teuchos::ArrayRCP<std::size_t> d_pair_sizes;
+
+    // Adapted support radius of each parent center. Empty if the support
+    // radius is the same for all parents.
+    Teuchos::Array<double> d_support_radii;
 };
 
 //---------------------------------------------------------------------------//
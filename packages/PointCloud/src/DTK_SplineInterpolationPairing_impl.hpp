@@ -41,20 +41,32 @@
 #ifndef DTK_SPLINEINTERPOLATIONPAIRING_IMPL_HPP
 #define DTK_SPLINEINTERPOLATIONPAIRING_IMPL_HPP
 
+#include <algorithm>
+#include <cmath>
+
 #include "DTK_DBC.hpp"
 #include "DTK_StaticSearchTree.hpp"
+#include "DTK_EuclideanDistance.hpp"
+
+#include <Teuchos_Ptr.hpp>
 
 namespace DataTransferKit
 {
 //---------------------------------------------------------------------------//
 /*!
  * \brief Constructor.
+ *
+ * \param store_distances If true, store the distance from each parent
+ * center to its child centers.
  */
 template<int DIM>
 SplineInterpolationPairing<DIM>::SplineInterpolationPairing( 
     const Teuchos::ArrayView<const double>& child_centers,
     const Teuchos::ArrayView<const double>& parent_centers,
-    const double radius )
+    const double radius,
+    const bool store_distances )
+    : d_radius( radius )
+    , d_has_distances( store_distances )
 {
     DTK_REQUIRE( 0 == child_centers.size() % DIM );
     DTK_REQUIRE( 0 == parent_centers.size() % DIM );
@@ -62,13 +74,111 @@ SplineInterpolationPairing<DIM>::SplineInterpolationPairing(
     unsigned leaf_size = 30;
     NanoflannTree<DIM> tree( child_centers, leaf_size );
 
-    unsigned num_parents = parent_centers.size() / DIM;
-    d_pairings.resize( num_parents );
+    // Search all parent centers at once.
+    Teuchos::Ptr<Teuchos::Array<double> > child_dists;
+    if ( store_distances )
+    {
+	child_dists = Teuchos::ptrFromRef( d_child_dists );
+    }
+    tree.radiusSearchBatch( 
+	parent_centers, radius, d_offsets, d_child_ids, child_dists );
+
+    int num_parents = parent_centers.size() / DIM;
     d_pair_sizes = Teuchos::ArrayRCP<std::size_t>( num_parents );
-    for ( unsigned i = 0; i < num_parents; ++i )
+    for ( int i = 0; i < num_parents; ++i )
     {
-	d_pairings[i] = tree.radiusSearch( parent_centers(DIM*i,DIM), radius );
-	d_pair_sizes[i] = d_pairings[i].size();
+	d_pair_sizes[i] = d_offsets[i+1] - d_offsets[i];
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief k-nearest neighbor constructor.
+ *
+ * \param num_neighbors The maximum number of child centers to pair with each
+ * parent center.
+ *
+ * \param radius The maximum support radius. Only the nearest child centers
+ * within this radius will be paired with a parent.
+ *
+ * \param store_distances If true, store the distance from each parent
+ * center to its child centers.
+ */
+template<int DIM>
+SplineInterpolationPairing<DIM>::SplineInterpolationPairing( 
+    const Teuchos::ArrayView<const double>& child_centers,
+    const Teuchos::ArrayView<const double>& parent_centers,
+    const unsigned num_neighbors,
+    const double radius,
+    const bool store_distances )
+    : d_radius( radius )
+    , d_has_distances( store_distances )
+{
+    DTK_REQUIRE( 0 == child_centers.size() % DIM );
+    DTK_REQUIRE( 0 == parent_centers.size() % DIM );
+    DTK_REQUIRE( 0 < num_neighbors );
+
+    unsigned leaf_size = 30;
+    NanoflannTree<DIM> tree( child_centers, leaf_size );
+
+    // Pad the adapted radius such that the furthest child center has a
+    // nonzero basis value.
+    double radius_tol = 1.0e-2;
+
+    unsigned num_children = child_centers.size() / DIM;
+    unsigned num_neighbors_found = std::min( num_neighbors, num_children );
+    int num_parents = parent_centers.size() / DIM;
+    d_pair_sizes = Teuchos::ArrayRCP<std::size_t>( num_parents, 0 );
+    d_support_radii.assign( num_parents, radius );
+    if ( 0 == num_neighbors_found )
+    {
+	d_offsets.assign( num_parents + 1, 0 );
+	return;
+    }
+
+    // Search all parent centers at once.
+    Teuchos::Array<std::size_t> knn_offsets;
+    Teuchos::Array<double> knn_dists;
+    tree.nnSearchBatch( parent_centers, num_neighbors_found, knn_offsets,
+			d_child_ids, Teuchos::ptrFromRef(knn_dists) );
+
+    // The neighbors are sorted by distance. Only keep those within the
+    // maximum radius. The pairings are compacted in place.
+    d_offsets.resize( num_parents + 1 );
+    d_offsets[0] = 0;
+    std::size_t num_kept = 0;
+    double dist = 0.0;
+    double max_dist = 0.0;
+    for ( int i = 0; i < num_parents; ++i )
+    {
+	max_dist = 0.0;
+	for ( std::size_t n = knn_offsets[i]; n < knn_offsets[i+1]; ++n )
+	{
+	    dist = knn_dists[n];
+	    if ( dist > radius )
+	    {
+		break;
+	    }
+	    max_dist = dist;
+	    d_child_ids[num_kept] = d_child_ids[n];
+	    knn_dists[num_kept] = dist;
+	    ++num_kept;
+	}
+	d_offsets[i+1] = num_kept;
+	d_pair_sizes[i] = d_offsets[i+1] - d_offsets[i];
+
+	// Adapt the support radius to the furthest child center.
+	if ( 0.0 < max_dist )
+	{
+	    d_support_radii[i] = 
+		std::min( radius, max_dist * (1.0 + radius_tol) );
+	}
+    }
+    d_child_ids.resize( num_kept );
+    if ( store_distances )
+    {
+	knn_dists.resize( num_kept );
+	d_child_dists.swap( knn_dists );
     }
 }
 
@@ -82,9 +192,44 @@ Teuchos::ArrayView<const unsigned>
 SplineInterpolationPairing<DIM>::childCenterIds(
     const unsigned parent_id ) const
 {
-    DTK_REQUIRE( parent_id < d_pairings.size() );
-    Teuchos::ArrayView<const unsigned> id_view = d_pairings[parent_id]();
-    return id_view;
+    DTK_REQUIRE( parent_id < d_pair_sizes.size() );
+    if ( 0 == d_pair_sizes[parent_id] )
+    {
+	return Teuchos::ArrayView<const unsigned>();
+    }
+    return d_child_ids( d_offsets[parent_id], d_pair_sizes[parent_id] );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Given a parent center local id get the distances to its child
+ * centers in the same order as the child center ids.
+ */
+template<int DIM>
+Teuchos::ArrayView<const double> 
+SplineInterpolationPairing<DIM>::childCenterDistances(
+    const unsigned parent_id ) const
+{
+    DTK_REQUIRE( d_has_distances );
+    DTK_REQUIRE( parent_id < d_pair_sizes.size() );
+    if ( 0 == d_pair_sizes[parent_id] )
+    {
+	return Teuchos::ArrayView<const double>();
+    }
+    return d_child_dists( d_offsets[parent_id], d_pair_sizes[parent_id] );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Given a parent center local id get the radius of the support of its
+ * child centers.
+ */
+template<int DIM>
+double SplineInterpolationPairing<DIM>::parentSupportRadius(
+    const unsigned parent_id ) const
+{
+    DTK_REQUIRE( parent_id < d_pair_sizes.size() );
+    return d_support_radii.empty() ? d_radius : d_support_radii[parent_id];
 }
 
 //---------------------------------------------------------------------------//
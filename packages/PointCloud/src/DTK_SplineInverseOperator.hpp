@@ -0,0 +1,128 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_SplineInverseOperator.hpp
+ * \author Stuart R. Slattery
+ * \brief  Spline coefficient matrix inverse with solution reuse.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef DTK_SPLINEINVERSEOPERATOR_HPP
+#define DTK_SPLINEINVERSEOPERATOR_HPP
+
+#include <Teuchos_RCP.hpp>
+
+#include <Thyra_LinearOpDefaultBase.hpp>
+#include <Thyra_LinearOpWithSolveBase.hpp>
+#include <Thyra_MultiVectorBase.hpp>
+#include <Thyra_VectorSpaceBase.hpp>
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \class SplineInverseOperator
+ * \brief Inverse of the spline coefficient matrix that reuses the solution
+ * of the previous application as the initial guess of the next one.
+ *
+ * The solver object is kept for the life of the operator so any state it
+ * carries between solves, such as a recycled Krylov subspace or the factors
+ * of a preconditioner, is also reused. When the source field changes slowly
+ * between applications the previous solution is a good initial guess and
+ * the solver convergence criteria should then be relative to the
+ * right-hand side rather than the initial residual.
+ */
+//---------------------------------------------------------------------------//
+template<class Scalar>
+class SplineInverseOperator : public Thyra::LinearOpDefaultBase<Scalar>
+{
+  public:
+
+    // Constructor.
+    SplineInverseOperator( 
+	const Teuchos::RCP<const Thyra::LinearOpWithSolveBase<Scalar> >& lows );
+
+    //! Destructor.
+    ~SplineInverseOperator()
+    { /* ... */ }
+
+    //! Range of the operator.
+    Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > range() const
+    { return d_lows->domain(); }
+
+    //! Domain of the operator.
+    Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > domain() const
+    { return d_lows->range(); }
+
+    // Discard the stored solution so the next solve starts from zero.
+    void resetInitialGuess();
+
+  protected:
+
+    // Check if an operation is supported.
+    bool opSupportedImpl( Thyra::EOpTransp M_trans ) const;
+
+    // Apply the inverse.
+    void applyImpl( const Thyra::EOpTransp M_trans,
+		    const Thyra::MultiVectorBase<Scalar>& X,
+		    const Teuchos::Ptr<Thyra::MultiVectorBase<Scalar> >& Y,
+		    const Scalar alpha,
+		    const Scalar beta ) const;
+
+  private:
+
+    // Forward operator with solve.
+    Teuchos::RCP<const Thyra::LinearOpWithSolveBase<Scalar> > d_lows;
+
+    // Solution of the previous application.
+    mutable Teuchos::RCP<Thyra::MultiVectorBase<Scalar> > d_solution;
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+// Template includes.
+//---------------------------------------------------------------------------//
+
+#include "DTK_SplineInverseOperator_impl.hpp"
+
+//---------------------------------------------------------------------------//
+
+#endif // end DTK_SPLINEINVERSEOPERATOR_HPP
+
+//---------------------------------------------------------------------------//
+// end DTK_SplineInverseOperator.hpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,141 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_SplineInverseOperator_impl.hpp
+ * \author Stuart R. Slattery
+ * \brief  Spline coefficient matrix inverse with solution reuse.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef DTK_SPLINEINVERSEOPERATOR_IMPL_HPP
+#define DTK_SPLINEINVERSEOPERATOR_IMPL_HPP
+
+#include "DTK_DBC.hpp"
+
+#include <Thyra_MultiVectorStdOps.hpp>
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Constructor.
+ */
+template<class Scalar>
+SplineInverseOperator<Scalar>::SplineInverseOperator(
+    const Teuchos::RCP<const Thyra::LinearOpWithSolveBase<Scalar> >& lows )
+    : d_lows( lows )
+{
+    DTK_REQUIRE( Teuchos::nonnull(d_lows) );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Discard the stored solution so the next solve starts from zero.
+ */
+template<class Scalar>
+void SplineInverseOperator<Scalar>::resetInitialGuess()
+{
+    d_solution = Teuchos::null;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Check if an operation is supported.
+ */
+template<class Scalar>
+bool SplineInverseOperator<Scalar>::opSupportedImpl( 
+    Thyra::EOpTransp M_trans ) const
+{
+    return Thyra::NOTRANS == M_trans;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Apply the inverse.
+ */
+template<class Scalar>
+void SplineInverseOperator<Scalar>::applyImpl( 
+    const Thyra::EOpTransp M_trans,
+    const Thyra::MultiVectorBase<Scalar>& X,
+    const Teuchos::Ptr<Thyra::MultiVectorBase<Scalar> >& Y,
+    const Scalar alpha,
+    const Scalar beta ) const
+{
+    DTK_REQUIRE( Thyra::NOTRANS == M_trans );
+    DTK_REQUIRE( X.domain()->dim() == Y->domain()->dim() );
+
+    // Start from zero if there is no previous solution with the same number
+    // of vectors.
+    int num_vec = X.domain()->dim();
+    if ( Teuchos::is_null(d_solution) || 
+	 num_vec != d_solution->domain()->dim() )
+    {
+	d_solution = Thyra::createMembers( d_lows->domain(), num_vec );
+	Thyra::assign( d_solution.ptr(), Teuchos::ScalarTraits<Scalar>::zero() );
+    }
+
+    // Solve from the previous solution. An unconverged iterate must not be
+    // returned or used as the next initial guess so start over from zero.
+    Thyra::SolveStatus<Scalar> status = 
+	d_lows->solve( Thyra::NOTRANS, X, d_solution.ptr() );
+    if ( Thyra::SOLVE_STATUS_CONVERGED != status.solveStatus )
+    {
+	Thyra::assign( d_solution.ptr(), Teuchos::ScalarTraits<Scalar>::zero() );
+    }
+    DTK_INSIST( Thyra::SOLVE_STATUS_CONVERGED == status.solveStatus );
+
+    // Y = alpha*C^-1*X + beta*Y
+    if ( Teuchos::ScalarTraits<Scalar>::zero() == beta )
+    {
+	Thyra::assign( Y, *d_solution );
+	Thyra::scale( alpha, Y );
+    }
+    else
+    {
+	Thyra::scale( beta, Y );
+	Thyra::update( alpha, *d_solution, Y );
+    }
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+
+#endif // end DTK_SPLINEINVERSEOPERATOR_IMPL_HPP
+
+//---------------------------------------------------------------------------//
+// end DTK_SplineInverseOperator_impl.hpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,134 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_SplineNeighborhood.hpp
+ * \author Stuart R. Slattery
+ * \brief  Spline center neighborhood.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef DTK_SPLINENEIGHBORHOOD_HPP
+#define DTK_SPLINENEIGHBORHOOD_HPP
+
+#include "DTK_CenterDistributor.hpp"
+#include "DTK_SplineInterpolationPairing.hpp"
+
+#include <Teuchos_RCP.hpp>
+#include <Teuchos_Comm.hpp>
+#include <Teuchos_ArrayView.hpp>
+#include <Teuchos_Array.hpp>
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \class SplineNeighborhood
+ * \brief Distributed source center neighborhood of a set of target centers.
+ *
+ * The neighborhood holds everything the point cloud operators build from a
+ * source cloud, a target cloud and a support: the center distributor, the
+ * source centers and global ids distributed to the target decomposition and
+ * the local source/target pairings. A neighborhood may be shared by any
+ * number of operators built over the same clouds and support so the
+ * searches and the halo exchange are only done once.
+ */
+//---------------------------------------------------------------------------//
+template<int DIM>
+class SplineNeighborhood
+{
+  public:
+
+    // Constructor.
+    SplineNeighborhood(
+	const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+	const Teuchos::ArrayView<const double>& source_centers,
+	const Teuchos::ArrayView<const std::size_t>& source_gids,
+	const Teuchos::ArrayView<const double>& target_centers,
+	const bool use_knn,
+	const unsigned num_neighbors,
+	const double radius,
+	const bool rendezvous = false );
+
+    //! Destructor.
+    ~SplineNeighborhood()
+    { /* ... */ }
+
+    // Get the center distributor.
+    Teuchos::RCP<const CenterDistributor<DIM> > distributor() const
+    { return d_distributor; }
+
+    // Get the source centers in the target decomposition.
+    Teuchos::ArrayView<const double> distributedSourceCenters() const
+    { return d_dist_sources(); }
+
+    // Get the source center global ids in the target decomposition.
+    Teuchos::ArrayView<const std::size_t> distributedSourceGids() const
+    { return d_dist_source_gids(); }
+
+    // Get the source/target pairings.
+    const SplineInterpolationPairing<DIM>& pairings() const
+    { return *d_pairings; }
+
+  private:
+
+    // Center distributor.
+    Teuchos::RCP<CenterDistributor<DIM> > d_distributor;
+
+    // Source centers in the target decomposition.
+    Teuchos::Array<double> d_dist_sources;
+
+    // Source center global ids in the target decomposition.
+    Teuchos::Array<std::size_t> d_dist_source_gids;
+
+    // Source/target pairings.
+    Teuchos::RCP<SplineInterpolationPairing<DIM> > d_pairings;
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+// Template includes.
+//---------------------------------------------------------------------------//
+
+#include "DTK_SplineNeighborhood_impl.hpp"
+
+//---------------------------------------------------------------------------//
+
+#endif // end DTK_SPLINENEIGHBORHOOD_HPP
+
+//---------------------------------------------------------------------------//
+// end DTK_SplineNeighborhood.hpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,198 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_SplineNeighborhoodCache.hpp
+ * \author Stuart R. Slattery
+ * \brief  Cache of spline center neighborhoods.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef DTK_SPLINENEIGHBORHOODCACHE_HPP
+#define DTK_SPLINENEIGHBORHOODCACHE_HPP
+
+#include <cstdint>
+
+#include "DTK_SplineNeighborhood.hpp"
+
+#include <Teuchos_RCP.hpp>
+#include <Teuchos_Comm.hpp>
+#include <Teuchos_ArrayView.hpp>
+#include <Teuchos_Array.hpp>
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \class SplineNeighborhoodCache
+ * \brief Cache of spline center neighborhoods shared by point cloud
+ * operators.
+ *
+ * Operators given a cache request their neighborhoods from it instead of
+ * building them. A neighborhood is built on the first request for a set of
+ * clouds and support and is returned to every later request with the same
+ * clouds and support. Several operators over the same source and target
+ * clouds, for example with different bases, then share their searches and
+ * halo exchanges. The key is directional: an operator in the reverse
+ * direction swaps the clouds and builds its own neighborhood.
+ *
+ * Requests are collective. A neighborhood is only reused if it matches the
+ * request on every process. A request is identified by its support, the
+ * sizes of its clouds and 64-bit hashes of the cloud values computed once
+ * per request, so the cache keeps no copies of the clouds.
+ */
+//---------------------------------------------------------------------------//
+template<int DIM>
+class SplineNeighborhoodCache
+{
+  public:
+
+    //! Constructor.
+    SplineNeighborhoodCache()
+	: d_num_hits( 0 )
+    { /* ... */ }
+
+    //! Destructor.
+    ~SplineNeighborhoodCache()
+    { /* ... */ }
+
+    // Get the neighborhood of the given clouds and support, building it if
+    // it is not in the cache.
+    Teuchos::RCP<const SplineNeighborhood<DIM> > getNeighborhood(
+	const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+	const Teuchos::ArrayView<const double>& source_centers,
+	const Teuchos::ArrayView<const std::size_t>& source_gids,
+	const Teuchos::ArrayView<const double>& target_centers,
+	const bool use_knn,
+	const unsigned num_neighbors,
+	const double radius,
+	const bool rendezvous = false );
+
+    //! Get the number of neighborhoods in the cache.
+    int size() const
+    { return d_neighborhoods.size(); }
+
+    //! Get the number of requests served from the cache.
+    int numHits() const
+    { return d_num_hits; }
+
+    //! Remove all neighborhoods from the cache.
+    void clear()
+    { d_keys.clear(); d_neighborhoods.clear(); }
+
+  private:
+
+    // Identity of the clouds and support of a neighborhood request.
+    class Key
+    {
+      public:
+
+	// Constructor.
+	Key( const Teuchos::ArrayView<const double>& source_centers,
+	     const Teuchos::ArrayView<const std::size_t>& source_gids,
+	     const Teuchos::ArrayView<const double>& target_centers,
+	     const bool use_knn,
+	     const unsigned num_neighbors,
+	     const double radius,
+	     const bool rendezvous );
+
+	// Determine if two keys identify the same request.
+	bool operator==( const Key& other ) const;
+
+      private:
+
+	// Continue a hash with the bytes of a set of values.
+	template<class T>
+	static std::uint64_t hashValues( 
+	    const Teuchos::ArrayView<const T>& values, std::uint64_t hash );
+
+	// Mix the bits of a 64-bit word.
+	static std::uint64_t mix( std::uint64_t word );
+
+      private:
+
+	// Hash of the local source centers and global ids.
+	std::uint64_t d_source_hash;
+
+	// Hash of the local target centers.
+	std::uint64_t d_target_hash;
+
+	// Number of local source centers.
+	std::size_t d_num_sources;
+
+	// Number of local target centers.
+	std::size_t d_num_targets;
+
+	// True if a nearest neighbor search is used.
+	bool d_use_knn;
+
+	// Number of nearest neighbors.
+	unsigned d_num_neighbors;
+
+	// Support radius.
+	double d_radius;
+
+	// True if the neighbor processes are found with a rendezvous.
+	bool d_rendezvous;
+    };
+
+  private:
+
+    // Keys of the cached neighborhoods.
+    Teuchos::Array<Key> d_keys;
+
+    // Cached neighborhoods in the order they were built.
+    Teuchos::Array<Teuchos::RCP<const SplineNeighborhood<DIM> > > 
+    d_neighborhoods;
+
+    // Number of requests served from the cache.
+    int d_num_hits;
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+// Template includes.
+//---------------------------------------------------------------------------//
+
+#include "DTK_SplineNeighborhoodCache_impl.hpp"
+
+//---------------------------------------------------------------------------//
+
+#endif // end DTK_SPLINENEIGHBORHOODCACHE_HPP
+
+//---------------------------------------------------------------------------//
+// end DTK_SplineNeighborhoodCache.hpp
+//---------------------------------------------------------------------------//
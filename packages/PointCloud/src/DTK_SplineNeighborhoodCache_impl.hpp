@@ -0,0 +1,209 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_SplineNeighborhoodCache_impl.hpp
+ * \author Stuart R. Slattery
+ * \brief  Cache of spline center neighborhoods.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef DTK_SPLINENEIGHBORHOODCACHE_IMPL_HPP
+#define DTK_SPLINENEIGHBORHOODCACHE_IMPL_HPP
+
+#include <cstring>
+
+#include "DTK_DBC.hpp"
+
+#include <Teuchos_CommHelpers.hpp>
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get the neighborhood of the given clouds and support, building it
+ * if it is not in the cache.
+ *
+ * Every process must make the same sequence of requests. The neighborhoods
+ * are then cached in the same order on every process and a cached
+ * neighborhood is reused only if all processes agree that its key matches
+ * the key of the request.
+ */
+template<int DIM>
+Teuchos::RCP<const SplineNeighborhood<DIM> > 
+SplineNeighborhoodCache<DIM>::getNeighborhood(
+    const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+    const Teuchos::ArrayView<const double>& source_centers,
+    const Teuchos::ArrayView<const std::size_t>& source_gids,
+    const Teuchos::ArrayView<const double>& target_centers,
+    const bool use_knn,
+    const unsigned num_neighbors,
+    const double radius,
+    const bool rendezvous )
+{
+    DTK_REQUIRE( Teuchos::nonnull(comm) );
+
+    // Compare the request key with the keys of all cached neighborhoods
+    // locally and agree on the matches with a single reduction.
+    Key key( source_centers, source_gids, target_centers,
+	     use_knn, num_neighbors, radius, rendezvous );
+    int num_cached = d_neighborhoods.size();
+    if ( 0 < num_cached )
+    {
+	Teuchos::Array<int> local_matches( num_cached );
+	for ( int n = 0; n < num_cached; ++n )
+	{
+	    local_matches[n] = ( key == d_keys[n] ) ? 1 : 0;
+	}
+	Teuchos::Array<int> global_matches( num_cached );
+	Teuchos::reduceAll( *comm, Teuchos::REDUCE_MIN, num_cached,
+			    local_matches.getRawPtr(), 
+			    global_matches.getRawPtr() );
+	for ( int n = 0; n < num_cached; ++n )
+	{
+	    if ( global_matches[n] )
+	    {
+		++d_num_hits;
+		return d_neighborhoods[n];
+	    }
+	}
+    }
+
+    Teuchos::RCP<const SplineNeighborhood<DIM> > neighborhood =
+	Teuchos::rcp( new SplineNeighborhood<DIM>(
+			  comm, source_centers, source_gids, target_centers,
+			  use_knn, num_neighbors, radius, rendezvous) );
+    d_keys.push_back( key );
+    d_neighborhoods.push_back( neighborhood );
+    return neighborhood;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Key constructor.
+ */
+template<int DIM>
+SplineNeighborhoodCache<DIM>::Key::Key(
+    const Teuchos::ArrayView<const double>& source_centers,
+    const Teuchos::ArrayView<const std::size_t>& source_gids,
+    const Teuchos::ArrayView<const double>& target_centers,
+    const bool use_knn,
+    const unsigned num_neighbors,
+    const double radius,
+    const bool rendezvous )
+    : d_source_hash( hashValues(source_gids, 
+				hashValues(source_centers, 0)) )
+    , d_target_hash( hashValues(target_centers, 0) )
+    , d_num_sources( source_gids.size() )
+    , d_num_targets( target_centers.size() / DIM )
+    , d_use_knn( use_knn )
+    , d_num_neighbors( use_knn ? num_neighbors : 0 )
+    , d_radius( radius )
+    , d_rendezvous( rendezvous )
+{ /* ... */ }
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Determine if two keys identify the same request.
+ */
+template<int DIM>
+bool SplineNeighborhoodCache<DIM>::Key::operator==( const Key& other ) const
+{
+    return d_source_hash == other.d_source_hash &&
+	d_target_hash == other.d_target_hash &&
+	d_num_sources == other.d_num_sources &&
+	d_num_targets == other.d_num_targets &&
+	d_use_knn == other.d_use_knn &&
+	d_num_neighbors == other.d_num_neighbors &&
+	d_radius == other.d_radius &&
+	d_rendezvous == other.d_rendezvous;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Continue a hash with the bytes of a set of values.
+ *
+ * The bytes are consumed a 64-bit word at a time and each word is mixed
+ * into the hash. The number of bytes is mixed in last so sets that differ
+ * only by trailing zero bytes have different hashes.
+ */
+template<int DIM>
+template<class T>
+std::uint64_t SplineNeighborhoodCache<DIM>::Key::hashValues( 
+    const Teuchos::ArrayView<const T>& values, std::uint64_t hash )
+{
+    const unsigned char* bytes = 
+	reinterpret_cast<const unsigned char*>( values.getRawPtr() );
+    std::size_t num_bytes = values.size() * sizeof(T);
+    std::size_t num_words = num_bytes / sizeof(std::uint64_t);
+    std::uint64_t word = 0;
+    for ( std::size_t n = 0; n < num_words; ++n )
+    {
+	std::memcpy( &word, bytes + n*sizeof(word), sizeof(word) );
+	hash = mix( hash ^ word );
+    }
+    std::size_t num_tail = num_bytes - num_words*sizeof(word);
+    if ( 0 < num_tail )
+    {
+	word = 0;
+	std::memcpy( &word, bytes + num_words*sizeof(word), num_tail );
+	hash = mix( hash ^ word );
+    }
+    return mix( hash ^ num_bytes );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Mix the bits of a 64-bit word with the splitmix64 finalizer. The
+ * golden ratio offset keeps a zero word from mapping to zero.
+ */
+template<int DIM>
+std::uint64_t SplineNeighborhoodCache<DIM>::Key::mix( std::uint64_t word )
+{
+    word += 0x9E3779B97F4A7C15ULL;
+    word = (word ^ (word >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    word = (word ^ (word >> 27)) * 0x94D049BB133111EBULL;
+    return word ^ (word >> 31);
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+
+#endif // end DTK_SPLINENEIGHBORHOODCACHE_IMPL_HPP
+
+//---------------------------------------------------------------------------//
+// end DTK_SplineNeighborhoodCache_impl.hpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,132 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_SplineNeighborhood_impl.hpp
+ * \author Stuart R. Slattery
+ * \brief  Spline center neighborhood.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef DTK_SPLINENEIGHBORHOOD_IMPL_HPP
+#define DTK_SPLINENEIGHBORHOOD_IMPL_HPP
+
+#include "DTK_DBC.hpp"
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Constructor.
+ *
+ * \param comm The communicator over which the clouds are distributed.
+ *
+ * \param source_centers The local source centers.
+ *
+ * \param source_gids The global ids of the local source centers.
+ *
+ * \param target_centers The local target centers.
+ *
+ * \param use_knn If true, pair each target center with only the
+ * num_neighbors nearest source centers within the radius.
+ *
+ * \param num_neighbors The number of nearest neighbors if use_knn is true.
+ *
+ * \param radius The support radius.
+ *
+ * \param rendezvous If true, find the neighbor processes with a rendezvous.
+ */
+template<int DIM>
+SplineNeighborhood<DIM>::SplineNeighborhood(
+    const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+    const Teuchos::ArrayView<const double>& source_centers,
+    const Teuchos::ArrayView<const std::size_t>& source_gids,
+    const Teuchos::ArrayView<const double>& target_centers,
+    const bool use_knn,
+    const unsigned num_neighbors,
+    const double radius,
+    const bool rendezvous )
+{
+    DTK_REQUIRE( Teuchos::nonnull(comm) );
+    DTK_REQUIRE( source_centers.size() == DIM * source_gids.size() );
+    DTK_REQUIRE( 0 == target_centers.size() % DIM );
+
+    // Gather the source centers that are within a radius of the target
+    // centers on this proc.
+    if ( use_knn )
+    {
+	d_distributor = Teuchos::rcp( 
+	    new CenterDistributor<DIM>(
+		comm, source_centers, target_centers, 
+		num_neighbors, radius, d_dist_sources, rendezvous) );
+    }
+    else
+    {
+	d_distributor = Teuchos::rcp( 
+	    new CenterDistributor<DIM>(
+		comm, source_centers, target_centers, 
+		radius, d_dist_sources, rendezvous) );
+    }
+
+    // Distribute the global source ids.
+    d_dist_source_gids.resize( d_distributor->getNumImports() );
+    d_distributor->distribute( source_gids, d_dist_source_gids() );
+
+    // Build the source/target pairings.
+    if ( use_knn )
+    {
+	d_pairings = Teuchos::rcp( 
+	    new SplineInterpolationPairing<DIM>(
+		d_dist_sources(), target_centers, num_neighbors, radius) );
+    }
+    else
+    {
+	d_pairings = Teuchos::rcp( 
+	    new SplineInterpolationPairing<DIM>(
+		d_dist_sources(), target_centers, radius) );
+    }
+
+    DTK_ENSURE( Teuchos::nonnull(d_pairings) );
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+
+#endif // end DTK_SPLINENEIGHBORHOOD_IMPL_HPP
+
+//---------------------------------------------------------------------------//
+// end DTK_SplineNeighborhood_impl.hpp
+//---------------------------------------------------------------------------//
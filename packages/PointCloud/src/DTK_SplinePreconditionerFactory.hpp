@@ -0,0 +1,170 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_SplinePreconditionerFactory.hpp
+ * \author Stuart R. Slattery
+ * \brief  Stratimikos preconditioner strategy for spline preconditioners.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef DTK_SPLINEPRECONDITIONERFACTORY_HPP
+#define DTK_SPLINEPRECONDITIONERFACTORY_HPP
+
+#include <Teuchos_RCP.hpp>
+#include <Teuchos_ParameterList.hpp>
+#include <Teuchos_AbstractFactory.hpp>
+
+#include <Thyra_LinearOpBase.hpp>
+#include <Thyra_LinearOpSourceBase.hpp>
+#include <Thyra_PreconditionerBase.hpp>
+#include <Thyra_PreconditionerFactoryBase.hpp>
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \class SplinePreconditionerFactory
+ * \brief Thyra preconditioner factory that provides a preconditioner built
+ * by the spline interpolation operator.
+ *
+ * The preconditioner depends on the source center geometry and therefore
+ * cannot be built from the forward operator alone. The spline operator builds
+ * it during setup and this factory hands it to the Stratimikos solver.
+ */
+//---------------------------------------------------------------------------//
+template<class Scalar>
+class SplinePreconditionerFactory 
+    : public Thyra::PreconditionerFactoryBase<Scalar>
+{
+  public:
+
+    // Constructor.
+    SplinePreconditionerFactory(
+	const Teuchos::RCP<const Thyra::LinearOpBase<Scalar> >& prec_op );
+
+    //! Destructor.
+    ~SplinePreconditionerFactory()
+    { /* ... */ }
+
+    // Check that the preconditioner is compatible with a forward operator.
+    bool isCompatible( 
+	const Thyra::LinearOpSourceBase<Scalar>& fwd_op_src ) const;
+
+    // Create an uninitialized preconditioner.
+    Teuchos::RCP<Thyra::PreconditionerBase<Scalar> > createPrec() const;
+
+    // Initialize a preconditioner with the prebuilt preconditioner operator.
+    void initializePrec(
+	const Teuchos::RCP<const Thyra::LinearOpSourceBase<Scalar> >& fwd_op_src,
+	Thyra::PreconditionerBase<Scalar>* prec,
+	const Thyra::ESupportSolveUse support_solve_use ) const;
+
+    // Uninitialize a preconditioner.
+    void uninitializePrec(
+	Thyra::PreconditionerBase<Scalar>* prec,
+	Teuchos::RCP<const Thyra::LinearOpSourceBase<Scalar> >* fwd_op_src,
+	Thyra::ESupportSolveUse* support_solve_use ) const;
+
+    // Set the parameters.
+    void setParameterList( 
+	const Teuchos::RCP<Teuchos::ParameterList>& parameters );
+
+    // Get the parameters.
+    Teuchos::RCP<Teuchos::ParameterList> getNonconstParameterList();
+
+    // Unset the parameters.
+    Teuchos::RCP<Teuchos::ParameterList> unsetParameterList();
+
+    // Get the parameters.
+    Teuchos::RCP<const Teuchos::ParameterList> getParameterList() const;
+
+    // Get the valid parameters.
+    Teuchos::RCP<const Teuchos::ParameterList> getValidParameters() const;
+
+  private:
+
+    // Prebuilt preconditioner operator.
+    Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > d_prec_op;
+
+    // Parameters.
+    Teuchos::RCP<Teuchos::ParameterList> d_parameters;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * \class SplinePreconditionerStrategy
+ * \brief Abstract factory for registering a SplinePreconditionerFactory as a
+ * Stratimikos preconditioning strategy.
+ */
+//---------------------------------------------------------------------------//
+template<class Scalar>
+class SplinePreconditionerStrategy 
+    : public Teuchos::AbstractFactory<Thyra::PreconditionerFactoryBase<Scalar> >
+{
+  public:
+
+    //! Constructor.
+    SplinePreconditionerStrategy(
+	const Teuchos::RCP<const Thyra::LinearOpBase<Scalar> >& prec_op )
+	: d_prec_op( prec_op )
+    { /* ... */ }
+
+    //! Create a preconditioner factory.
+    Teuchos::RCP<Thyra::PreconditionerFactoryBase<Scalar> > create() const
+    { return Teuchos::rcp( 
+	    new SplinePreconditionerFactory<Scalar>(d_prec_op) ); }
+
+  private:
+
+    // Prebuilt preconditioner operator.
+    Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > d_prec_op;
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+// Template includes.
+//---------------------------------------------------------------------------//
+
+#include "DTK_SplinePreconditionerFactory_impl.hpp"
+
+//---------------------------------------------------------------------------//
+
+#endif // end DTK_SPLINEPRECONDITIONERFACTORY_HPP
+
+//---------------------------------------------------------------------------//
+// end DTK_SplinePreconditionerFactory.hpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,209 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_SplinePreconditionerFactory_impl.hpp
+ * \author Stuart R. Slattery
+ * \brief  Stratimikos preconditioner strategy for spline preconditioners.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef DTK_SPLINEPRECONDITIONERFACTORY_IMPL_HPP
+#define DTK_SPLINEPRECONDITIONERFACTORY_IMPL_HPP
+
+#include "DTK_DBC.hpp"
+
+#include <Thyra_DefaultPreconditioner.hpp>
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Constructor.
+ */
+template<class Scalar>
+SplinePreconditionerFactory<Scalar>::SplinePreconditionerFactory(
+    const Teuchos::RCP<const Thyra::LinearOpBase<Scalar> >& prec_op )
+    : d_prec_op( prec_op )
+{
+    DTK_REQUIRE( Teuchos::nonnull(d_prec_op) );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Check that the preconditioner is compatible with a forward operator.
+ */
+template<class Scalar>
+bool SplinePreconditionerFactory<Scalar>::isCompatible(
+    const Thyra::LinearOpSourceBase<Scalar>& fwd_op_src ) const
+{
+    Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > fwd_op = 
+	fwd_op_src.getOp();
+    return fwd_op->range()->isCompatible( *d_prec_op->domain() ) &&
+	fwd_op->domain()->isCompatible( *d_prec_op->range() );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Create an uninitialized preconditioner.
+ */
+template<class Scalar>
+Teuchos::RCP<Thyra::PreconditionerBase<Scalar> > 
+SplinePreconditionerFactory<Scalar>::createPrec() const
+{
+    return Teuchos::rcp( new Thyra::DefaultPreconditioner<Scalar>() );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Initialize a preconditioner with the prebuilt preconditioner
+ * operator. 
+ */
+template<class Scalar>
+void SplinePreconditionerFactory<Scalar>::initializePrec(
+    const Teuchos::RCP<const Thyra::LinearOpSourceBase<Scalar> >& fwd_op_src,
+    Thyra::PreconditionerBase<Scalar>* prec,
+    const Thyra::ESupportSolveUse support_solve_use ) const
+{
+    DTK_REQUIRE( Teuchos::nonnull(fwd_op_src) );
+    DTK_REQUIRE( this->isCompatible(*fwd_op_src) );
+    DTK_REQUIRE( 0 != prec );
+
+    Thyra::DefaultPreconditioner<Scalar>* default_prec =
+	dynamic_cast<Thyra::DefaultPreconditioner<Scalar>*>( prec );
+    DTK_INSIST( 0 != default_prec );
+    default_prec->initializeUnspecified( d_prec_op );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Uninitialize a preconditioner.
+ */
+template<class Scalar>
+void SplinePreconditionerFactory<Scalar>::uninitializePrec(
+    Thyra::PreconditionerBase<Scalar>* prec,
+    Teuchos::RCP<const Thyra::LinearOpSourceBase<Scalar> >* fwd_op_src,
+    Thyra::ESupportSolveUse* support_solve_use ) const
+{
+    DTK_REQUIRE( 0 != prec );
+
+    Thyra::DefaultPreconditioner<Scalar>* default_prec =
+	dynamic_cast<Thyra::DefaultPreconditioner<Scalar>*>( prec );
+    DTK_INSIST( 0 != default_prec );
+    default_prec->uninitialize();
+    if ( 0 != fwd_op_src )
+    {
+	*fwd_op_src = Teuchos::null;
+    }
+    if ( 0 != support_solve_use )
+    {
+	*support_solve_use = Thyra::SUPPORT_SOLVE_UNSPECIFIED;
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Set the parameters.
+ */
+template<class Scalar>
+void SplinePreconditionerFactory<Scalar>::setParameterList(
+    const Teuchos::RCP<Teuchos::ParameterList>& parameters )
+{
+    DTK_REQUIRE( Teuchos::nonnull(parameters) );
+    parameters->validateParametersAndSetDefaults( *getValidParameters() );
+    d_parameters = parameters;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get the parameters.
+ */
+template<class Scalar>
+Teuchos::RCP<Teuchos::ParameterList> 
+SplinePreconditionerFactory<Scalar>::getNonconstParameterList()
+{
+    return d_parameters;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Unset the parameters.
+ */
+template<class Scalar>
+Teuchos::RCP<Teuchos::ParameterList> 
+SplinePreconditionerFactory<Scalar>::unsetParameterList()
+{
+    Teuchos::RCP<Teuchos::ParameterList> parameters = d_parameters;
+    d_parameters = Teuchos::null;
+    return parameters;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get the parameters.
+ */
+template<class Scalar>
+Teuchos::RCP<const Teuchos::ParameterList> 
+SplinePreconditionerFactory<Scalar>::getParameterList() const
+{
+    return d_parameters;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get the valid parameters. The parameters are used by the spline
+ * operator when it builds the preconditioner.
+ */
+template<class Scalar>
+Teuchos::RCP<const Teuchos::ParameterList> 
+SplinePreconditionerFactory<Scalar>::getValidParameters() const
+{
+    Teuchos::RCP<Teuchos::ParameterList> valid_parameters =
+	Teuchos::parameterList();
+    valid_parameters->set<int>( 
+	"Max Block Size", 1000, 
+	"Maximum number of source centers in a local dense block solve." );
+    return valid_parameters;
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+
+#endif // end DTK_SPLINEPRECONDITIONERFACTORY_IMPL_HPP
+
+//---------------------------------------------------------------------------//
+// end DTK_SplinePreconditionerFactory_impl.hpp
+//---------------------------------------------------------------------------//
@@ -55,6 +55,12 @@ namespace DataTransferKit
  * \class SplineProlongationOperator
  * \brief Prolongation operator for projecting a vector into the extended
  * spline space.
+ *
+ * The offset is the number of polynomial coefficients owned by this
+ * process. They are placed before the local domain elements in the range
+ * map and get global ids after the largest domain id in process order. The
+ * coefficients may therefore all be placed on one process or spread over
+ * several.
  */
 //---------------------------------------------------------------------------//
 template<class Scalar,class GO>
@@ -43,7 +43,9 @@
 
 #include "DTK_DBC.hpp"
 
+#include <Teuchos_Array.hpp>
 #include <Teuchos_ArrayRCP.hpp>
+#include <Teuchos_CommHelpers.hpp>
 
 namespace DataTransferKit
 {
@@ -58,28 +60,28 @@ SplineProlongationOperator<Scalar,GO>::SplineProlongationOperator(
     : d_offset( offset )
     , d_domain_map( domain_map )
 {
-    // Create a range map.
+    // Create a range map. Each process places its polynomial coefficients
+    // before its domain elements. The coefficients are numbered in process
+    // order after the largest domain id.
     Teuchos::ArrayView<const GO> domain_elements = 
 	d_domain_map->getNodeElementList();
     d_lda = domain_elements.size();
-    Teuchos::Array<GO> global_ids;
     GO max_id = d_domain_map->getMaxAllGlobalIndex() + 1;
-    if ( d_domain_map->getComm()->getRank() == 0 )
+    int poly_end = 0;
+    Teuchos::scan( *(d_domain_map->getComm()), Teuchos::REDUCE_SUM, 
+		   1, &d_offset, &poly_end );
+    int poly_begin = poly_end - d_offset;
+    Teuchos::Array<GO> global_ids( d_offset + d_lda );
+    for ( int i = 0; i < d_offset; ++i )
     {
-	global_ids.resize( d_offset + domain_elements.size() );
-	global_ids( d_offset, domain_elements.size() ).assign( domain_elements );
-	for ( int i = 0; i < d_offset; ++i )
-	{
-	    global_ids[i] = max_id + i;
-	}
-	domain_elements = global_ids();
+	global_ids[i] = max_id + poly_begin + i;
     }
-    else
+    if ( 0 < d_lda )
     {
-	d_offset = 0;
+	global_ids( d_offset, d_lda ).assign( domain_elements );
     }
     d_range_map = Tpetra::createNonContigMap<int,GO>(
-	domain_elements, d_domain_map->getComm() );
+	global_ids(), d_domain_map->getComm() );
     DTK_ENSURE( Teuchos::nonnull(d_range_map) );
 }
 
@@ -188,6 +188,165 @@ TEUCHOS_UNIT_TEST( CenterDistributor, dim_3_test )
     }
 }
 
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( CenterDistributor, rendezvous_test )
+{
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = getDefaultComm();
+    int rank = comm->getRank();
+    int size = comm->getSize();
+    int inverse_rank = size - rank - 1;
+
+    int dim = 3;
+    int num_src_points = 10;
+    int num_src_coords = dim*num_src_points;
+
+    Teuchos::Array<double> src_coords(num_src_coords);
+    for ( int i = 0; i < num_src_points; ++i )
+    {
+	src_coords[dim*i] = 1.0*i;
+	src_coords[dim*i+1] = 2.0*rank;
+	src_coords[dim*i+2] = 2.0*rank;
+    }
+
+    int num_tgt_points = 2;
+    int num_tgt_coords = dim*num_tgt_points;
+    Teuchos::Array<double> tgt_coords( num_tgt_coords );
+    tgt_coords[0] = 4.9;
+    tgt_coords[1] = 2.0*inverse_rank;
+    tgt_coords[2] = 2.0*inverse_rank;
+    tgt_coords[3] = 11.4;
+    tgt_coords[4] = 2.0*inverse_rank;
+    tgt_coords[5] = 2.0*inverse_rank;
+
+    double radius = 1.5;
+
+    Teuchos::Array<double> tgt_decomp_src;
+
+    DataTransferKit::CenterDistributor<3> distributor( 
+	comm, src_coords(), tgt_coords(), radius, tgt_decomp_src, true );
+
+    int num_import = 6;
+    TEST_EQUALITY( num_import, distributor.getNumImports() ); 
+    TEST_EQUALITY( dim*distributor.getNumImports(), tgt_decomp_src.size() );
+    for ( int i = 0; i < num_import; ++i )
+    {
+	TEST_EQUALITY( tgt_decomp_src[dim*i], 4.0+i );
+	TEST_EQUALITY( tgt_decomp_src[dim*i+1], 2.0*inverse_rank );
+	TEST_EQUALITY( tgt_decomp_src[dim*i+2], 2.0*inverse_rank );
+    }
+
+    Teuchos::Array<double> src_data(num_src_points);
+    for ( int i = 0; i < num_src_points; ++i )
+    {
+	src_data[i] = i*inverse_rank;
+    }
+    Teuchos::Array<double> tgt_data( distributor.getNumImports() );
+    Teuchos::ArrayView<const double> src_view = src_data();
+    distributor.distribute( src_view, tgt_data() );
+    for ( int i = 0; i < num_import; ++i )
+    {
+	TEST_EQUALITY( tgt_data[i], (4.0+i)*rank );
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( CenterDistributor, overlapping_rendezvous_test )
+{
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = getDefaultComm();
+    int rank = comm->getRank();
+
+    // Make overlapping random clouds of sources and targets on every proc.
+    int dim = 2;
+    int num_src_points = 200;
+    Teuchos::Array<double> src_coords( dim*num_src_points );
+    for ( int i = 0; i < dim*num_src_points; ++i )
+    {
+	src_coords[i] = double(std::rand()) / RAND_MAX + 0.1*rank;
+    }
+    int num_tgt_points = 50;
+    Teuchos::Array<double> tgt_coords( dim*num_tgt_points );
+    for ( int i = 0; i < dim*num_tgt_points; ++i )
+    {
+	tgt_coords[i] = 0.5*double(std::rand()) / RAND_MAX + 0.2*rank;
+    }
+    double radius = 0.1;
+
+    // Distribute by gathering all domains.
+    Teuchos::Array<double> gather_src;
+    DataTransferKit::CenterDistributor<2> gather_distributor( 
+	comm, src_coords(), tgt_coords(), radius, gather_src );
+
+    // Distribute with a rendezvous.
+    Teuchos::Array<double> rendezvous_src;
+    DataTransferKit::CenterDistributor<2> rendezvous_distributor( 
+	comm, src_coords(), tgt_coords(), radius, rendezvous_src, true );
+
+    // Both should find the same neighbors and import the same centers in
+    // the same order.
+    TEST_EQUALITY( gather_distributor.getNumImports(),
+		   rendezvous_distributor.getNumImports() );
+    TEST_EQUALITY( gather_distributor.getNumExports(),
+		   rendezvous_distributor.getNumExports() );
+    TEST_COMPARE_ARRAYS( gather_src, rendezvous_src );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( CenterDistributor, knn_test )
+{
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = getDefaultComm();
+    int rank = comm->getRank();
+
+    int dim = 2;
+    int num_src_points = 10;
+    int num_src_coords = dim*num_src_points;
+
+    Teuchos::Array<double> src_coords(num_src_coords);
+    for ( int i = 0; i < num_src_points; ++i )
+    {
+	src_coords[dim*i] = 1.0*i;
+	src_coords[dim*i+1] = 2.0*rank;
+    }
+
+    int num_tgt_points = 1;
+    int num_tgt_coords = dim*num_tgt_points;
+    Teuchos::Array<double> tgt_coords( num_tgt_coords );
+    tgt_coords[0] = 4.9;
+    tgt_coords[1] = 2.0*rank;
+
+    // The radius reaches the sources of the neighboring procs but the 2
+    // nearest sources are local and only 0.9 away so the halo shrinks to
+    // capture only them.
+    unsigned num_neighbors = 2;
+    double radius = 3.0;
+
+    Teuchos::Array<double> tgt_decomp_src;
+
+    DataTransferKit::CenterDistributor<2> distributor( 
+	comm, src_coords(), tgt_coords(), num_neighbors, radius,
+	tgt_decomp_src );
+
+    int num_import = 2;
+    TEST_EQUALITY( num_import, distributor.getNumImports() ); 
+    TEST_EQUALITY( dim*distributor.getNumImports(), tgt_decomp_src.size() ); 
+    for ( int i = 0; i < num_import; ++i )
+    {
+	TEST_EQUALITY( tgt_decomp_src[dim*i], 4.0+i );
+	TEST_EQUALITY( tgt_decomp_src[dim*i+1], 2.0*rank );
+    }
+
+    // With fewer local sources than neighbors the full radius is used.
+    Teuchos::Array<double> radius_src;
+    DataTransferKit::CenterDistributor<2> radius_distributor( 
+	comm, src_coords(), tgt_coords(), radius, radius_src );
+    Teuchos::Array<double> all_src;
+    DataTransferKit::CenterDistributor<2> all_distributor( 
+	comm, src_coords(), tgt_coords(), num_src_points + 1, radius,
+	all_src );
+    TEST_EQUALITY( radius_distributor.getNumImports(),
+		   all_distributor.getNumImports() );
+    TEST_COMPARE_ARRAYS( radius_src, all_src );
+}
+
 //---------------------------------------------------------------------------//
 // end tstCenterDistributor.cpp
 //---------------------------------------------------------------------------//
@@ -46,6 +46,7 @@
 #include <limits>
 
 #include <DTK_MovingLeastSquareReconstructionOperator.hpp>
+#include <DTK_LocalMLSProblem.hpp>
 #include <DTK_WuBasis.hpp>
 #include <DTK_Point.hpp>
 #include <DTK_BasicGeometryManager.hpp>
@@ -148,6 +149,199 @@ TEUCHOS_UNIT_TEST( MovingLeastSquareReconstructionOperator, mls_test )
     }
 }
 
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( LocalMLSProblem, quadratic_reproduction_test )
+{
+    const int space_dim = 2;
+
+    // Make a grid of source centers about the target center.
+    int num_sources = 0;
+    Teuchos::Array<double> source_centers;
+    for ( int i = -3; i < 4; ++i )
+    {
+	for ( int j = -3; j < 4; ++j )
+	{
+	    source_centers.push_back( 0.5 + 0.1*i + 0.01*j*j );
+	    source_centers.push_back( 0.25 + 0.1*j - 0.02*i );
+	    ++num_sources;
+	}
+    }
+    Teuchos::Array<unsigned> source_lids( num_sources );
+    for ( int i = 0; i < num_sources; ++i )
+    {
+	source_lids[i] = i;
+    }
+    Teuchos::Array<double> target_center( space_dim );
+    target_center[0] = 0.52;
+    target_center[1] = 0.27;
+
+    // Build the local problem.
+    double radius = 1.0;
+    DataTransferKit::WuBasis<2> basis( radius );
+    DataTransferKit::LocalMLSProblem<DataTransferKit::WuBasis<2>,space_dim>
+	local_problem( target_center(), source_lids(), source_centers(), basis );
+    Teuchos::ArrayView<const double> shape = local_problem.shapeFunction();
+    TEST_EQUALITY( shape.size(), num_sources );
+
+    // A quadratic basis should exactly reproduce a quadratic field.
+    double x = 0.0;
+    double y = 0.0;
+    double interp = 0.0;
+    for ( int i = 0; i < num_sources; ++i )
+    {
+	x = source_centers[2*i];
+	y = source_centers[2*i+1];
+	interp += shape[i] * ( 1.0 + 2.0*x - 3.0*y + x*x + 0.5*x*y - y*y );
+    }
+    x = target_center[0];
+    y = target_center[1];
+    double test_val = 1.0 + 2.0*x - 3.0*y + x*x + 0.5*x*y - y*y;
+    TEST_FLOATING_EQUALITY( interp, test_val, 1.0e-10 );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( LocalMLSProblem, linear_reproduction_test )
+{
+    const int space_dim = 3;
+
+    // Make a set of source centers about the target center.
+    int num_sources = 0;
+    Teuchos::Array<double> source_centers;
+    for ( int i = -2; i < 3; ++i )
+    {
+	for ( int j = -2; j < 3; ++j )
+	{
+	    for ( int k = -2; k < 3; ++k )
+	    {
+		source_centers.push_back( 0.1*i + 0.01*j );
+		source_centers.push_back( 0.1*j - 0.01*k );
+		source_centers.push_back( 0.1*k + 0.02*i );
+		++num_sources;
+	    }
+	}
+    }
+    Teuchos::Array<unsigned> source_lids( num_sources );
+    for ( int i = 0; i < num_sources; ++i )
+    {
+	source_lids[i] = i;
+    }
+    Teuchos::Array<double> target_center( space_dim );
+    target_center[0] = 0.03;
+    target_center[1] = -0.05;
+    target_center[2] = 0.07;
+
+    // Build the local problem with a linear polynomial basis.
+    double radius = 1.0;
+    DataTransferKit::WuBasis<2> basis( radius );
+    DataTransferKit::LocalMLSProblem<
+	DataTransferKit::WuBasis<2>,space_dim,
+	DataTransferKit::LinearPolynomialBasis<space_dim> >
+	local_problem( target_center(), source_lids(), source_centers(), basis );
+    Teuchos::ArrayView<const double> shape = local_problem.shapeFunction();
+    TEST_EQUALITY( shape.size(), num_sources );
+
+    // A linear basis should exactly reproduce a linear field.
+    double interp = 0.0;
+    for ( int i = 0; i < num_sources; ++i )
+    {
+	interp += shape[i] * ( 1.0 + 2.0*source_centers[3*i] 
+			       - 3.0*source_centers[3*i+1]
+			       + 0.5*source_centers[3*i+2] );
+    }
+    double test_val = 1.0 + 2.0*target_center[0] 
+		      - 3.0*target_center[1] + 0.5*target_center[2];
+    TEST_FLOATING_EQUALITY( interp, test_val, 1.0e-10 );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( MovingLeastSquareReconstructionOperator, knn_test )
+{
+    // Get the communicator.
+    Teuchos::RCP<const Teuchos::Comm<int> > comm =
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_rank = comm->getRank();
+    int comm_size = comm->getSize();
+    int inverse_rank = comm_size - comm_rank - 1;
+    const int space_dim = 3;
+    int field_dim = 1;
+
+    // Make a set of domain points.
+    int num_points = 10;
+    Teuchos::Array<DataTransferKit::Entity> domain_points( num_points );
+    Teuchos::Array<double> coords( space_dim );
+    DataTransferKit::EntityId point_id = 0;
+    Teuchos::ArrayRCP<double> domain_data( field_dim*num_points );
+    for ( int i = 0; i < num_points; ++i )
+    {
+	point_id = num_points*comm_rank + i;
+	coords[0] = point_id;
+	coords[1] = point_id;
+	coords[2] = point_id;
+	domain_points[i] = DataTransferKit::Point( point_id, comm_rank, coords );
+	domain_data[i] = point_id + 1.0;
+    }
+
+    // Make a set of range points.
+    Teuchos::Array<DataTransferKit::Entity> range_points( num_points );
+    Teuchos::ArrayRCP<double> range_data( field_dim*num_points );
+    for ( int i = 0; i < num_points; ++i )
+    {
+	point_id = num_points*inverse_rank + i;
+	coords[0] = point_id;
+	coords[1] = point_id;
+	coords[2] = point_id;
+	range_points[i] = DataTransferKit::Point( point_id, comm_rank, coords );
+	range_data[i] = 0.0;
+    }
+
+    // Make a manager for the domain geometry.
+    DataTransferKit::BasicGeometryManager domain_manager( 
+	comm, space_dim, DataTransferKit::ENTITY_TYPE_NODE, domain_points() );
+					   
+    // Make a manager for the range geometry.
+    DataTransferKit::BasicGeometryManager range_manager( 
+	comm, space_dim, DataTransferKit::ENTITY_TYPE_NODE, range_points() );
+
+    // Make a DOF vector for the domain.
+    Teuchos::RCP<Tpetra::MultiVector<double,int,std::size_t> > domain_vector =
+	DataTransferKit::EntityCenteredDOFVector::createTpetraMultiVectorFromEntitiesAndView(
+	    comm, domain_points(), field_dim, domain_data );
+
+    // Make a DOF vector for the range.
+    Teuchos::RCP<Tpetra::MultiVector<double,int,std::size_t> > range_vector =
+	DataTransferKit::EntityCenteredDOFVector::createTpetraMultiVectorFromEntitiesAndView(
+	    comm, range_points(), field_dim, range_data );
+
+    // Make a moving least square reconstruction operator with a radius that
+    // covers every source. Only the 3 nearest sources, which may live on
+    // another proc, support each target.
+    double radius = 100.0;
+    Teuchos::RCP<DataTransferKit::MapOperator<double> > mls_op =
+	Teuchos::rcp( 
+	    new DataTransferKit::MovingLeastSquareReconstructionOperator<double,DataTransferKit::WuBasis<2>,space_dim>(radius) );
+
+    // Setup the operator.
+    Teuchos::RCP<Teuchos::ParameterList> parameters = Teuchos::parameterList();
+    parameters->set<std::string>( "Type of Search", "Nearest Neighbor" );
+    parameters->set<int>( "Num Neighbors", 3 );
+    mls_op->setup( domain_vector->getMap(),
+		   domain_manager.functionSpace(),
+		   range_vector->getMap(),
+		   range_manager.functionSpace(),
+		   parameters );
+
+    // Apply the operator.
+    mls_op->apply( *domain_vector, *range_vector );
+
+    // Check the apply. The field is linear along the line of centers so it
+    // is reproduced.
+    for ( int i = 0; i < num_points; ++i )
+    {
+	double test_val = num_points*inverse_rank + i + 1.0;
+	TEST_FLOATING_EQUALITY( range_data[i], test_val, 1.0e-8 );
+    }
+}
+
 //---------------------------------------------------------------------------//
 // end tstMovingLeastSquare.cpp
 //---------------------------------------------------------------------------//
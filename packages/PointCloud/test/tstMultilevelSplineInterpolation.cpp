@@ -0,0 +1,204 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   tstMultilevelSplineInterpolation.cpp
+ * \author Stuart R. Slattery
+ * \brief  MultilevelSplineInterpolationOperator tests.
+ */
+//---------------------------------------------------------------------------//
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <limits>
+
+#include <DTK_MultilevelSplineInterpolationOperator.hpp>
+#include <DTK_WendlandBasis.hpp>
+#include <DTK_Point.hpp>
+#include <DTK_BasicGeometryManager.hpp>
+#include <DTK_Entity.hpp>
+#include <DTK_EntityCenteredDOFVector.hpp>
+
+#include "Teuchos_UnitTestHarness.hpp"
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_Ptr.hpp"
+#include "Teuchos_Array.hpp"
+#include "Teuchos_ArrayRCP.hpp"
+#include "Teuchos_DefaultComm.hpp"
+#include "Teuchos_CommHelpers.hpp"
+#include "Teuchos_ParameterList.hpp"
+
+//---------------------------------------------------------------------------//
+// Helper functions.
+//---------------------------------------------------------------------------//
+// Quasi-random point in the unit cube for a given id so that any process
+// can build the point of any id.
+void pointCoords( const DataTransferKit::EntityId id, 
+		  Teuchos::Array<double>& coords )
+{
+    coords[0] = std::fmod( 0.8191725134 * (id+1), 1.0 );
+    coords[1] = std::fmod( 0.6710436067 * (id+1), 1.0 );
+    coords[2] = std::fmod( 0.5497004779 * (id+1), 1.0 );
+}
+
+double field( const Teuchos::Array<double>& x )
+{
+    return std::sin( 2.0*x[0] ) + x[1]*x[2] + 1.0;
+}
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( MultilevelSplineInterpolationOperator, multilevel_test )
+{
+    // Get the communicator.
+    Teuchos::RCP<const Teuchos::Comm<int> > comm =
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_rank = comm->getRank();
+    int comm_size = comm->getSize();
+    int inverse_rank = comm_size - comm_rank - 1;
+    const int space_dim = 3;
+    int field_dim = 1;
+
+    // Make a set of domain points.
+    int num_points = 1000;
+    Teuchos::Array<DataTransferKit::Entity> domain_points( num_points );
+    Teuchos::Array<double> coords( space_dim );
+    DataTransferKit::EntityId point_id = 0;
+    Teuchos::ArrayRCP<double> domain_data( field_dim*num_points );
+    for ( int i = 0; i < num_points; ++i )
+    {
+	point_id = num_points*comm_rank + i;
+	pointCoords( point_id, coords );
+	domain_points[i] = DataTransferKit::Point( point_id, comm_rank, coords );
+	domain_data[i] = field( coords );
+    }
+
+    // Make a set of range points at the domain points of the inverse rank.
+    Teuchos::Array<DataTransferKit::Entity> range_points( num_points );
+    Teuchos::ArrayRCP<double> range_data( field_dim*num_points );
+    Teuchos::ArrayRCP<double> gold_data( field_dim*num_points );
+    for ( int i = 0; i < num_points; ++i )
+    {
+	point_id = num_points*inverse_rank + i;
+	pointCoords( point_id, coords );
+	range_points[i] = DataTransferKit::Point( point_id, comm_rank, coords );
+	range_data[i] = 0.0;
+	gold_data[i] = field( coords );
+    }
+
+    // Make a manager for the domain geometry.
+    DataTransferKit::BasicGeometryManager domain_manager( 
+	comm, space_dim, DataTransferKit::ENTITY_TYPE_NODE, domain_points() );
+					   
+    // Make a manager for the range geometry.
+    DataTransferKit::BasicGeometryManager range_manager( 
+	comm, space_dim, DataTransferKit::ENTITY_TYPE_NODE, range_points() );
+
+    // Make a DOF vector for the domain.
+    Teuchos::RCP<Tpetra::MultiVector<double,int,std::size_t> > domain_vector =
+	DataTransferKit::EntityCenteredDOFVector::createTpetraMultiVectorFromEntitiesAndView(
+	    comm, domain_points(), field_dim, domain_data );
+
+    // Make a DOF vector for the range.
+    Teuchos::RCP<Tpetra::MultiVector<double,int,std::size_t> > range_vector =
+	DataTransferKit::EntityCenteredDOFVector::createTpetraMultiVectorFromEntitiesAndView(
+	    comm, range_points(), field_dim, range_data );
+
+    // Make a multilevel interpolation operator.
+    double radius = 0.15;
+    Teuchos::RCP<DataTransferKit::MapOperator<double> > multilevel_op =
+	Teuchos::rcp( 
+	    new DataTransferKit::MultilevelSplineInterpolationOperator<
+	    double,DataTransferKit::WendlandBasis<2>,space_dim>(radius) );
+
+    // Setup the operator with a tight level solver tolerance.
+    Teuchos::RCP<Teuchos::ParameterList> parameters = Teuchos::parameterList();
+    parameters->set<int>( "Number of Levels", 3 );
+    parameters->sublist("Stratimikos").sublist("Linear Solver Types").sublist(
+	"Belos").sublist("Solver Types").sublist("Pseudo Block CG").set<double>(
+	    "Convergence Tolerance", 1.0e-12 );
+    multilevel_op->setup( domain_vector->getMap(),
+			  domain_manager.functionSpace(),
+			  range_vector->getMap(),
+			  range_manager.functionSpace(),
+			  parameters );
+
+    // Apply the operator.
+    multilevel_op->apply( *domain_vector, *range_vector );
+
+    // The finest level contains all source centers so the interpolant
+    // reproduces the field at the source centers.
+    for ( int i = 0; i < num_points; ++i )
+    {
+	TEST_FLOATING_EQUALITY( range_data[i], gold_data[i], 1.0e-6 );
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( MultilevelSplineInterpolationOperator, source_level_test )
+{
+    const int space_dim = 2;
+    typedef DataTransferKit::MultilevelSplineInterpolationOperator<
+	double,DataTransferKit::WendlandBasis<2>,space_dim> MLOp;
+
+    // Count the number of centers on each level.
+    int num_levels = 3;
+    int num_gids = 100000;
+    Teuchos::Array<int> level_count( num_levels, 0 );
+    int level = 0;
+    for ( int i = 0; i < num_gids; ++i )
+    {
+	level = MLOp::sourceLevel( i, num_levels );
+	TEST_ASSERT( 0 <= level && level < num_levels );
+	for ( int l = level; l < num_levels; ++l )
+	{
+	    ++level_count[l];
+	}
+    }
+
+    // Each coarser level should keep about 1/2^DIM of the centers of the
+    // next finer level.
+    TEST_EQUALITY( level_count[2], num_gids );
+    TEST_FLOATING_EQUALITY( 
+	double(level_count[1]) / num_gids, 0.25, 0.05 );
+    TEST_FLOATING_EQUALITY( 
+	double(level_count[0]) / num_gids, 0.0625, 0.1 );
+}
+
+//---------------------------------------------------------------------------//
+// end tstMultilevelSplineInterpolation.cpp
+//---------------------------------------------------------------------------//
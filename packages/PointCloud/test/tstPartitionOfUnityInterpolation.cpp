@@ -0,0 +1,205 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   tstPartitionOfUnityInterpolation.cpp
+ * \author Stuart R. Slattery
+ * \brief  PartitionOfUnityInterpolationOperator tests.
+ */
+//---------------------------------------------------------------------------//
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <limits>
+
+#include <DTK_PartitionOfUnityInterpolationOperator.hpp>
+#include <DTK_WendlandBasis.hpp>
+#include <DTK_EuclideanDistance.hpp>
+#include <DTK_Point.hpp>
+#include <DTK_BasicGeometryManager.hpp>
+#include <DTK_Entity.hpp>
+#include <DTK_EntityCenteredDOFVector.hpp>
+
+#include "Teuchos_UnitTestHarness.hpp"
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_Ptr.hpp"
+#include "Teuchos_Array.hpp"
+#include "Teuchos_ArrayRCP.hpp"
+#include "Teuchos_DefaultComm.hpp"
+#include "Teuchos_CommHelpers.hpp"
+#include "Teuchos_ParameterList.hpp"
+
+//---------------------------------------------------------------------------//
+// Helper functions.
+//---------------------------------------------------------------------------//
+double linearField( const Teuchos::ArrayView<const double>& x )
+{
+    return 1.0 + 2.0*x[0] - 3.0*x[1] + 0.5*x[2];
+}
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( PartitionOfUnityInterpolationOperator, pu_test )
+{
+    // Get the communicator.
+    Teuchos::RCP<const Teuchos::Comm<int> > comm =
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_rank = comm->getRank();
+    int comm_size = comm->getSize();
+    int inverse_rank = comm_size - comm_rank - 1;
+    const int space_dim = 3;
+    int field_dim = 1;
+
+    // Make a set of domain points.
+    int num_src = 1000;
+    Teuchos::Array<DataTransferKit::Entity> domain_points( num_src );
+    Teuchos::Array<double> coords( space_dim );
+    DataTransferKit::EntityId point_id = 0;
+    Teuchos::ArrayRCP<double> domain_data( field_dim*num_src );
+    for ( int i = 0; i < num_src; ++i )
+    {
+	point_id = num_src*comm_rank + i;
+	coords[0] = double(std::rand())/RAND_MAX;
+	coords[1] = double(std::rand())/RAND_MAX;
+	coords[2] = double(std::rand())/RAND_MAX;
+	domain_points[i] = DataTransferKit::Point( point_id, comm_rank, coords );
+	domain_data[i] = linearField( coords() );
+    }
+
+    // Make a set of range points.
+    int num_tgt = 100;
+    Teuchos::Array<DataTransferKit::Entity> range_points( num_tgt );
+    Teuchos::ArrayRCP<double> range_data( field_dim*num_tgt );
+    Teuchos::ArrayRCP<double> gold_data( field_dim*num_tgt );
+    for ( int i = 0; i < num_tgt; ++i )
+    {
+	point_id = num_tgt*inverse_rank + i;
+	coords[0] = double(std::rand())/RAND_MAX;
+	coords[1] = double(std::rand())/RAND_MAX;
+	coords[2] = double(std::rand())/RAND_MAX;
+	range_points[i] = DataTransferKit::Point( point_id, comm_rank, coords );
+	range_data[i] = 0.0;
+	gold_data[i] = linearField( coords() );
+    }
+
+    // Make a manager for the domain geometry.
+    DataTransferKit::BasicGeometryManager domain_manager( 
+	comm, space_dim, DataTransferKit::ENTITY_TYPE_NODE, domain_points() );
+					   
+    // Make a manager for the range geometry.
+    DataTransferKit::BasicGeometryManager range_manager( 
+	comm, space_dim, DataTransferKit::ENTITY_TYPE_NODE, range_points() );
+
+    // Make a DOF vector for the domain.
+    Teuchos::RCP<Tpetra::MultiVector<double,int,std::size_t> > domain_vector =
+	DataTransferKit::EntityCenteredDOFVector::createTpetraMultiVectorFromEntitiesAndView(
+	    comm, domain_points(), field_dim, domain_data );
+
+    // Make a DOF vector for the range.
+    Teuchos::RCP<Tpetra::MultiVector<double,int,std::size_t> > range_vector =
+	DataTransferKit::EntityCenteredDOFVector::createTpetraMultiVectorFromEntitiesAndView(
+	    comm, range_points(), field_dim, range_data );
+
+    // Make a partition of unity interpolation operator.
+    double radius = 0.3;
+    Teuchos::RCP<DataTransferKit::MapOperator<double> > pu_op =
+	Teuchos::rcp( 
+	    new DataTransferKit::PartitionOfUnityInterpolationOperator<
+	    double,DataTransferKit::WendlandBasis<2>,space_dim>(radius) );
+
+    // Setup the operator.
+    Teuchos::RCP<Teuchos::ParameterList> parameters = Teuchos::parameterList();
+    pu_op->setup( domain_vector->getMap(),
+		  domain_manager.functionSpace(),
+		  range_vector->getMap(),
+		  range_manager.functionSpace(),
+		  parameters );
+
+    // Apply the operator.
+    pu_op->apply( *domain_vector, *range_vector );
+
+    // The patch interpolants reproduce linear fields and the patch weights
+    // are a partition of unity so the blended interpolant does as well.
+    for ( int i = 0; i < num_tgt; ++i )
+    {
+	TEST_FLOATING_EQUALITY( range_data[i], gold_data[i], 1.0e-6 );
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( PartitionOfUnityInterpolationOperator, patch_cover_test )
+{
+    const int space_dim = 3;
+    typedef DataTransferKit::PartitionOfUnityInterpolationOperator<
+	double,DataTransferKit::WendlandBasis<2>,space_dim> PUOp;
+
+    // Make a set of target centers.
+    int num_tgt = 500;
+    Teuchos::Array<double> target_centers( space_dim*num_tgt );
+    for ( int i = 0; i < space_dim*num_tgt; ++i )
+    {
+	target_centers[i] = 4.0 * double(std::rand()) / RAND_MAX - 2.0;
+    }
+
+    // Build the patches.
+    double radius = 0.5;
+    Teuchos::Array<double> patch_centers;
+    PUOp::buildPatches( target_centers(), radius, patch_centers );
+    int num_patches = patch_centers.size() / space_dim;
+    TEST_ASSERT( 0 < num_patches );
+    TEST_ASSERT( num_patches <= num_tgt );
+
+    // Every target center should be well inside of at least one patch.
+    double min_dist = 0.0;
+    for ( int i = 0; i < num_tgt; ++i )
+    {
+	min_dist = std::numeric_limits<double>::max();
+	for ( int p = 0; p < num_patches; ++p )
+	{
+	    min_dist = std::min( 
+		min_dist,
+		DataTransferKit::EuclideanDistance<space_dim>::distance(
+		    &target_centers[space_dim*i], 
+		    &patch_centers[space_dim*p]) );
+	}
+	TEST_ASSERT( min_dist <= 0.75*radius + 1.0e-12 );
+    }
+}
+
+//---------------------------------------------------------------------------//
+// end tstPartitionOfUnityInterpolation.cpp
+//---------------------------------------------------------------------------//
@@ -232,6 +232,91 @@ TEUCHOS_UNIT_TEST( PolynomialMatrix, polynomial_matrix_transpose_apply )
     }
 }
 
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( PolynomialMatrix, distributed_coefficients_apply )
+{
+    // Make an equivalent polynomial matrix and CrsMatrix with the polynomial
+    // coefficients owned by different processes and apply them to a
+    // multivector.
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = getDefaultComm<int>();
+    int comm_size = comm->getSize();
+    int local_size = 100;
+    int global_size = local_size * comm_size;
+    int num_vec = 3;
+    int poly_size = 4;
+
+    // Create a random polynomial.
+    Teuchos::RCP<const Tpetra::Map<int,int> > row_map = 
+	Tpetra::createUniformContigMap<int,int>( global_size, comm );
+    Teuchos::RCP<Tpetra::MultiVector<double,int,int> > P =
+	Tpetra::createMultiVector<double,int,int>( row_map, poly_size );
+    P->randomize();
+
+    // Put the coefficients on different processes.
+    Teuchos::Array<int> poly_gids( poly_size );
+    for ( int p = 0; p < poly_size; ++p )
+    {
+	poly_gids[p] = (p % comm_size) * local_size + local_size - 1 - p;
+    }
+
+    // Create the CrsMatrix version of the polynomial.
+    Teuchos::RCP<Tpetra::CrsMatrix<double,int,int> > P_crs = Teuchos::rcp(
+	new Tpetra::CrsMatrix<double,int,int>( row_map, poly_size ) );
+    Teuchos::Array<double> crs_values( poly_size );
+    Teuchos::ArrayRCP<Teuchos::ArrayRCP<const double> > poly_view = 
+	P->get2dView();
+    Teuchos::ArrayView<const int> rows = row_map->getNodeElementList();
+    for ( int i = 0; i < local_size; ++i )
+    {
+	for ( int j = 0; j < poly_size; ++j )
+	{
+	    crs_values[j] = poly_view[j][i];
+	}
+	P_crs->insertGlobalValues( rows[i], poly_gids(), crs_values() );
+    }
+    P_crs->fillComplete();    
+
+    // Create the PolynomialMatrix version of the polynomial.
+    DataTransferKit::PolynomialMatrix<int> P_poly_mat( 
+	P, row_map, row_map, poly_gids() );
+
+    // Build a random vector to apply the matrices to.
+    Teuchos::RCP<Tpetra::MultiVector<double,int,int> > X =
+	Tpetra::createMultiVector<double,int,int>( row_map, num_vec );
+    X->randomize();
+
+    // Apply and transpose apply the matrices.
+    Teuchos::Array<Teuchos::ETransp> modes( 2 );
+    modes[0] = Teuchos::NO_TRANS;
+    modes[1] = Teuchos::TRANS;
+    for ( int m = 0; m < 2; ++m )
+    {
+	Teuchos::RCP<Tpetra::MultiVector<double,int,int> > Y_crs =
+	    Tpetra::createMultiVector<double,int,int>( row_map, num_vec );
+	Y_crs->randomize();
+	P_crs->apply( *X, *Y_crs, modes[m] );
+
+	Teuchos::RCP<Tpetra::MultiVector<double,int,int> > Y_poly_mat =
+	    Tpetra::createMultiVector<double,int,int>( row_map, num_vec );
+	Y_poly_mat->randomize();
+	P_poly_mat.apply( *X, *Y_poly_mat, modes[m] );
+
+	// Compare the results.
+	Teuchos::ArrayRCP<Teuchos::ArrayRCP<const double> > y_crs_view = 
+	    Y_crs->get2dView();
+	Teuchos::ArrayRCP<Teuchos::ArrayRCP<const double> > y_pm_view = 
+	    Y_poly_mat->get2dView();
+	for ( int i = 0; i < num_vec; ++i )
+	{
+	    for ( int j = 0; j < local_size; ++j )
+	    {
+		TEST_FLOATING_EQUALITY( 
+		    y_crs_view[i][j], y_pm_view[i][j], 1.0e-12 );
+	    }
+	}
+    }
+}
+
 //---------------------------------------------------------------------------//
 // end tstPolynomialMatrix.cpp
 //---------------------------------------------------------------------------//
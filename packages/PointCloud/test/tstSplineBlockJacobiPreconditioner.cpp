@@ -0,0 +1,347 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   tstSplineBlockJacobiPreconditioner.cpp
+ * \author Stuart R. Slattery
+ * \brief  Spline Block Jacobi preconditioner tests.
+ */
+//---------------------------------------------------------------------------//
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <cstdlib>
+#include <limits>
+#include <algorithm>
+
+#include <DTK_DBC.hpp>
+#include <DTK_SplineBlockJacobiPreconditioner.hpp>
+#include <DTK_SplineCoefficientMatrix.hpp>
+#include <DTK_SplineInterpolationPairing.hpp>
+#include <DTK_WuBasis.hpp>
+
+#include "Teuchos_UnitTestHarness.hpp"
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_Array.hpp"
+#include "Teuchos_ArrayRCP.hpp"
+#include "Teuchos_DefaultComm.hpp"
+#include "Teuchos_CommHelpers.hpp"
+
+#include <Tpetra_Map.hpp>
+#include <Tpetra_MultiVector.hpp>
+
+#include "BelosPseudoBlockGmresSolMgr.hpp"
+#include "BelosLinearProblem.hpp"
+#include "BelosTpetraAdapter.hpp"
+
+//---------------------------------------------------------------------------//
+// Helper functions.
+//---------------------------------------------------------------------------//
+// Apply the preconditioner and then the coefficient matrix to a random
+// vector.
+void applyPreconditionedMatrix( 
+    const int max_block_size,
+    Teuchos::RCP<Tpetra::MultiVector<double,int,std::size_t> >& x,
+    Teuchos::RCP<Tpetra::MultiVector<double,int,std::size_t> >& z )
+{
+    // Initialize.
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    const int dim = 3;
+    double radius = 1.1;
+    int num_src_points = 5;
+    int num_src_coords = dim*num_src_points;
+    int comm_rank = comm->getRank();
+    int comm_size = comm->getSize();
+    int offset = (0==comm_rank) ? dim + 1 : 0;
+
+    // Create some coordinates.
+    Teuchos::Array<double> src_coords(num_src_coords);
+    Teuchos::Array<std::size_t> src_gids(num_src_points+offset);
+    for ( int i = 0; i < num_src_points; ++i )
+    {
+	src_gids[i+offset] = comm_rank*num_src_points + i;
+	src_coords[dim*i] = double(std::rand())/RAND_MAX;
+	src_coords[dim*i+1] = double(std::rand())/RAND_MAX;
+	src_coords[dim*i+2] = double(std::rand())/RAND_MAX;
+    }
+    for ( int i = 0; i < offset; ++i )
+    {
+	src_gids[i] = num_src_points*comm_size + i;
+    }
+
+    // Create a map.
+    Teuchos::RCP<const Tpetra::Map<int,std::size_t> > map =
+	Tpetra::createNonContigMap<int,std::size_t>( src_gids(), comm );
+
+    // Create the assembled coefficient matrix.
+    DataTransferKit::SplineInterpolationPairing<dim> pairing( 
+	src_coords(), src_coords(), radius );
+    DataTransferKit::WuBasis<4> basis( radius );
+    DataTransferKit::SplineCoefficientMatrix<DataTransferKit::WuBasis<4>,dim>
+	coeff_mtx( map, src_coords(), src_gids(offset,num_src_points), 
+		   src_coords(), src_gids(offset,num_src_points),
+		   pairing, basis, true );
+
+    // Create the preconditioner.
+    DataTransferKit::SplineBlockJacobiPreconditioner<DataTransferKit::WuBasis<4>,dim>
+	prec( map, src_coords(), src_gids(offset,num_src_points), 
+	      basis, max_block_size );
+
+    // Apply z = C * M^-1 * x.
+    int num_vec = 2;
+    x = Tpetra::createMultiVector<double,int,std::size_t>( map, num_vec );
+    z = Tpetra::createMultiVector<double,int,std::size_t>( map, num_vec );
+    Tpetra::MultiVector<double,int,std::size_t> y( map, num_vec );
+    x->randomize();
+    prec.apply( *x, y );
+    coeff_mtx.getC()->apply( y, *z );
+}
+
+//---------------------------------------------------------------------------//
+// Solve the coefficient system of a shuffled grid of source centers with
+// Belos and return the number of iterations.
+int solveShuffledGrid( const bool precondition )
+{
+    // Initialize.
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    const int dim = 3;
+    int num_side = 8;
+    int num_src_points = num_side*num_side*num_side;
+    double spacing = 1.0 / (num_side-1);
+    double radius = 3.0 * spacing;
+    int comm_rank = comm->getRank();
+    int comm_size = comm->getSize();
+    int offset = (0==comm_rank) ? dim + 1 : 0;
+
+    // Create a grid of coordinates offset by the process rank and shuffle it
+    // so the input order carries no locality.
+    Teuchos::Array<double> src_coords(dim*num_src_points);
+    Teuchos::Array<std::size_t> src_gids(num_src_points+offset);
+    for ( int k = 0; k < num_side; ++k )
+    {
+	for ( int j = 0; j < num_side; ++j )
+	{
+	    for ( int i = 0; i < num_side; ++i )
+	    {
+		int n = i + j*num_side + k*num_side*num_side;
+		src_coords[dim*n] = comm_rank + i*spacing;
+		src_coords[dim*n+1] = j*spacing;
+		src_coords[dim*n+2] = k*spacing;
+	    }
+	}
+    }
+    std::srand( 1 );
+    for ( int n = num_src_points - 1; n > 0; --n )
+    {
+	int m = std::rand() % (n+1);
+	for ( int d = 0; d < dim; ++d )
+	{
+	    std::swap( src_coords[dim*n+d], src_coords[dim*m+d] );
+	}
+    }
+    for ( int i = 0; i < num_src_points; ++i )
+    {
+	src_gids[i+offset] = comm_rank*num_src_points + i;
+    }
+    for ( int i = 0; i < offset; ++i )
+    {
+	src_gids[i] = num_src_points*comm_size + i;
+    }
+
+    // Create a map.
+    Teuchos::RCP<const Tpetra::Map<int,std::size_t> > map =
+	Tpetra::createNonContigMap<int,std::size_t>( src_gids(), comm );
+
+    // Create the assembled coefficient matrix.
+    DataTransferKit::SplineInterpolationPairing<dim> pairing( 
+	src_coords(), src_coords(), radius );
+    DataTransferKit::WuBasis<4> basis( radius );
+    DataTransferKit::SplineCoefficientMatrix<DataTransferKit::WuBasis<4>,dim>
+	coeff_mtx( map, src_coords(), src_gids(offset,num_src_points), 
+		   src_coords(), src_gids(offset,num_src_points),
+		   pairing, basis, true );
+
+    // Setup the problem.
+    typedef Tpetra::MultiVector<double,int,std::size_t> MV;
+    typedef Tpetra::Operator<double,int,std::size_t> OP;
+    Teuchos::RCP<MV> x = Tpetra::createMultiVector<double,int,std::size_t>(
+	map, 1 );
+    Teuchos::RCP<MV> b = Tpetra::createMultiVector<double,int,std::size_t>(
+	map, 1 );
+    b->putScalar( 1.0 );
+    Belos::LinearProblem<double,MV,OP> problem( coeff_mtx.getC(), x, b );
+    if ( precondition )
+    {
+	problem.setRightPrec( Teuchos::rcp(
+	    new DataTransferKit::SplineBlockJacobiPreconditioner<
+	    DataTransferKit::WuBasis<4>,dim>(
+		map, src_coords(), src_gids(offset,num_src_points), 
+		basis, 64) ) );
+    }
+    problem.setProblem();
+
+    // Solve the problem with belos.
+    Teuchos::RCP<Teuchos::ParameterList> parameters = Teuchos::parameterList();
+    parameters->set<int>( "Maximum Iterations", 2*num_src_points );
+    parameters->set<int>( "Num Blocks", 2*num_src_points );
+    parameters->set<double>( "Convergence Tolerance", 1.0e-8 );
+    Belos::PseudoBlockGmresSolMgr<double,MV,OP> solver( 
+	Teuchos::rcpFromRef(problem), parameters );
+    DTK_INSIST( Belos::Converged == solver.solve() );
+    return solver.getNumIters();
+}
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// With a single block per process the preconditioner is the inverse of the
+// coefficient matrix in serial.
+TEUCHOS_UNIT_TEST( SplineBlockJacobiPreconditioner, single_block_test )
+{
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    const int dim = 3;
+
+    Teuchos::RCP<Tpetra::MultiVector<double,int,std::size_t> > x;
+    Teuchos::RCP<Tpetra::MultiVector<double,int,std::size_t> > z;
+    applyPreconditionedMatrix( 100, x, z );
+
+    Teuchos::ArrayRCP<Teuchos::ArrayRCP<const double> > x_view = x->get2dView();
+    Teuchos::ArrayRCP<Teuchos::ArrayRCP<const double> > z_view = z->get2dView();
+    int num_check = 0;
+    if ( 1 == comm->getSize() )
+    {
+	num_check = x->getLocalLength();
+    }
+    else if ( 0 == comm->getRank() )
+    {
+	num_check = dim + 1;
+    }
+    for ( unsigned n = 0; n < x->getNumVectors(); ++n )
+    {
+	for ( int i = 0; i < num_check; ++i )
+	{
+	    TEST_FLOATING_EQUALITY( x_view[n][i], z_view[n][i], 1.0e-8 );
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+// With multiple blocks the coarse correction still satisfies the polynomial
+// constraints exactly.
+TEUCHOS_UNIT_TEST( SplineBlockJacobiPreconditioner, multiple_block_test )
+{
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    const int dim = 3;
+
+    Teuchos::RCP<Tpetra::MultiVector<double,int,std::size_t> > x;
+    Teuchos::RCP<Tpetra::MultiVector<double,int,std::size_t> > z;
+    applyPreconditionedMatrix( 2, x, z );
+
+    Teuchos::ArrayRCP<Teuchos::ArrayRCP<const double> > x_view = x->get2dView();
+    Teuchos::ArrayRCP<Teuchos::ArrayRCP<const double> > z_view = z->get2dView();
+    int num_check = ( 0 == comm->getRank() ) ? dim + 1 : 0;
+    for ( unsigned n = 0; n < x->getNumVectors(); ++n )
+    {
+	for ( int i = 0; i < num_check; ++i )
+	{
+	    TEST_FLOATING_EQUALITY( x_view[n][i], z_view[n][i], 1.0e-8 );
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+// Duplicate centers make the block basis matrix singular. The preconditioner
+// must still be built and give finite values.
+TEUCHOS_UNIT_TEST( SplineBlockJacobiPreconditioner, duplicate_center_test )
+{
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    const int dim = 3;
+    double radius = 1.1;
+    int num_src_points = 5;
+    int comm_rank = comm->getRank();
+    int comm_size = comm->getSize();
+    int offset = (0==comm_rank) ? dim + 1 : 0;
+
+    // Put all of the local source centers at the same location.
+    Teuchos::Array<double> src_coords( dim*num_src_points, 0.5 );
+    Teuchos::Array<std::size_t> src_gids(num_src_points+offset);
+    for ( int i = 0; i < num_src_points; ++i )
+    {
+	src_gids[i+offset] = comm_rank*num_src_points + i;
+    }
+    for ( int i = 0; i < offset; ++i )
+    {
+	src_gids[i] = num_src_points*comm_size + i;
+    }
+    Teuchos::RCP<const Tpetra::Map<int,std::size_t> > map =
+	Tpetra::createNonContigMap<int,std::size_t>( src_gids(), comm );
+
+    DataTransferKit::WuBasis<4> basis( radius );
+    DataTransferKit::SplineBlockJacobiPreconditioner<DataTransferKit::WuBasis<4>,dim>
+	prec( map, src_coords(), src_gids(offset,num_src_points), 
+	      basis, 100 );
+
+    Tpetra::MultiVector<double,int,std::size_t> x( map, 1 );
+    Tpetra::MultiVector<double,int,std::size_t> y( map, 1 );
+    x.randomize();
+    prec.apply( x, y );
+    Teuchos::ArrayRCP<const double> y_view = y.getData( 0 );
+    for ( int i = 0; i < y_view.size(); ++i )
+    {
+	TEST_ASSERT( y_view[i] == y_view[i] );
+	TEST_ASSERT( std::abs(y_view[i]) < 
+		     std::numeric_limits<double>::max() );
+    }
+}
+
+//---------------------------------------------------------------------------//
+// The blocks are built from spatially ordered centers so the preconditioner
+// reduces the iteration count even if the centers are given in random order.
+TEUCHOS_UNIT_TEST( SplineBlockJacobiPreconditioner, shuffled_cloud_test )
+{
+    int unpreconditioned_iters = solveShuffledGrid( false );
+    int preconditioned_iters = solveShuffledGrid( true );
+    TEST_ASSERT( preconditioned_iters < unpreconditioned_iters );
+}
+
+//---------------------------------------------------------------------------//
+// end tstSplineBlockJacobiPreconditioner.cpp
+//---------------------------------------------------------------------------//
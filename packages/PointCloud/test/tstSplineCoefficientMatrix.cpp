@@ -189,6 +189,90 @@ TEUCHOS_UNIT_TEST( SplineCoefficientMatrix, coeff_mtx_test )
     solver.solve();
 }
 
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( SplineCoefficientMatrix, assembled_coeff_mtx_test )
+{
+    // Initialize.
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    const int dim = 3;
+    double radius = 1.1;
+    int num_src_points = 5;
+    int num_src_coords = dim*num_src_points;
+    int comm_rank = comm->getRank();
+    int comm_size = comm->getSize();
+    int offset = (0==comm_rank) ? dim + 1 : 0;
+
+    // Create some coordinates.
+    Teuchos::Array<double> src_coords(num_src_coords);
+    Teuchos::Array<std::size_t> src_gids(num_src_points+offset);
+    for ( int i = 0; i < num_src_points; ++i )
+    {
+	src_gids[i+offset] = comm_rank*num_src_points + i;
+	src_coords[dim*i] = double(std::rand())/RAND_MAX;
+	src_coords[dim*i+1] = double(std::rand())/RAND_MAX;
+	src_coords[dim*i+2] = double(std::rand())/RAND_MAX;
+    }
+    for ( int i = 0; i < offset; ++i )
+    {
+	src_gids[i] = num_src_points*comm_size + i;
+    }
+
+    // Create a map.
+    Teuchos::RCP<const Tpetra::Map<int,std::size_t> > map =
+	Tpetra::createNonContigMap<int,std::size_t>( src_gids(), comm );
+
+    // Create a pairing.
+    DataTransferKit::SplineInterpolationPairing<dim> pairing( 
+	src_coords(), src_coords(), radius );
+
+    // Create the component and assembled coefficient matrices.
+    DataTransferKit::WuBasis<4> basis( radius );
+    DataTransferKit::SplineCoefficientMatrix<DataTransferKit::WuBasis<4>,dim>
+	coeff_mtx( map, src_coords(), src_gids(offset,num_src_points), 
+		   src_coords(), src_gids(offset,num_src_points),
+		   pairing, basis );
+    DataTransferKit::SplineCoefficientMatrix<DataTransferKit::WuBasis<4>,dim>
+	assembled_mtx( map, src_coords(), src_gids(offset,num_src_points), 
+		       src_coords(), src_gids(offset,num_src_points),
+		       pairing, basis, true );
+    TEST_ASSERT( Teuchos::nonnull(coeff_mtx.getP()) );
+    TEST_ASSERT( Teuchos::nonnull(coeff_mtx.getM()) );
+    TEST_ASSERT( Teuchos::is_null(coeff_mtx.getC()) );
+    TEST_ASSERT( Teuchos::is_null(assembled_mtx.getP()) );
+    TEST_ASSERT( Teuchos::is_null(assembled_mtx.getM()) );
+    TEST_ASSERT( Teuchos::nonnull(assembled_mtx.getC()) );
+
+    // Create some vectors.
+    int num_vec = 2;
+    Teuchos::RCP<Tpetra::MultiVector<double,int,std::size_t> > x =
+	Tpetra::createMultiVector<double,int,std::size_t>( map, num_vec );
+    Teuchos::RCP<Tpetra::MultiVector<double,int,std::size_t> > y =
+	Tpetra::createMultiVector<double,int,std::size_t>( map, num_vec );
+    Teuchos::RCP<Tpetra::MultiVector<double,int,std::size_t> > z =
+	Tpetra::createMultiVector<double,int,std::size_t>( map, num_vec );
+    x->randomize();
+
+    // Apply the components y = (P + M + P^T) x.
+    coeff_mtx.getP()->apply( *x, *y, Teuchos::NO_TRANS, 1.0, 0.0 );
+    coeff_mtx.getM()->apply( *x, *y, Teuchos::NO_TRANS, 1.0, 1.0 );
+    coeff_mtx.getP()->apply( *x, *y, Teuchos::TRANS, 1.0, 1.0 );
+
+    // Apply the assembled matrix z = C x.
+    assembled_mtx.getC()->apply( *x, *z, Teuchos::NO_TRANS, 1.0, 0.0 );
+
+    // Check the results.
+    Teuchos::ArrayRCP<Teuchos::ArrayRCP<const double> > y_view = y->get2dView();
+    Teuchos::ArrayRCP<Teuchos::ArrayRCP<const double> > z_view = z->get2dView();
+    for ( int n = 0; n < num_vec; ++n )
+    {
+	for ( unsigned i = 0; i < y->getLocalLength(); ++i )
+	{
+	    TEST_FLOATING_EQUALITY( y_view[n][i], z_view[n][i], 1.0e-12 );
+	}
+    }
+}
+
 //---------------------------------------------------------------------------//
 // end tstSplineCoefficientMatrix.cpp
 //---------------------------------------------------------------------------//
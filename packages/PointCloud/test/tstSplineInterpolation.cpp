@@ -46,6 +46,7 @@
 #include <limits>
 
 #include <DTK_SplineInterpolationOperator.hpp>
+#include <DTK_DBC.hpp>
 #include <DTK_WuBasis.hpp>
 #include <DTK_Point.hpp>
 #include <DTK_BasicGeometryManager.hpp>
@@ -156,6 +157,148 @@ TEUCHOS_UNIT_TEST( SplineInterpolationOperator, spline_test )
     }
 }
 
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( SplineInterpolationOperator, multi_field_test )
+{
+    // Get the communicator.
+    Teuchos::RCP<const Teuchos::Comm<int> > comm =
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_rank = comm->getRank();
+    int comm_size = comm->getSize();
+    int inverse_rank = comm_size - comm_rank - 1;
+    const int space_dim = 3;
+    int field_dim = 3;
+
+    // Solve for all of the fields together with a block solver.
+    Teuchos::RCP<Teuchos::ParameterList> parameters =
+	Teuchos::rcp( new Teuchos::ParameterList() );
+    parameters->set<int>( "Number of Fields", field_dim );
+
+    // Make a set of domain points. Each field is one coordinate.
+    int num_points = 100;
+    Teuchos::Array<DataTransferKit::Entity> domain_points( num_points );
+    Teuchos::Array<double> coords( space_dim );
+    DataTransferKit::EntityId point_id = 0;
+    Teuchos::ArrayRCP<double> domain_data( field_dim*num_points );
+    for ( int i = 0; i < num_points; ++i )
+    {
+	point_id = num_points*comm_rank + i;
+	coords[0] = double(std::rand())/RAND_MAX;
+	coords[1] = double(std::rand())/RAND_MAX;
+	coords[2] = double(std::rand())/RAND_MAX;
+	domain_points[i] = DataTransferKit::Point( point_id, comm_rank, coords );
+	for ( int d = 0; d < field_dim; ++d )
+	{
+	    domain_data[d*num_points + i] = coords[d];
+	}
+    }
+
+    // Make a set of range points.
+    Teuchos::Array<DataTransferKit::Entity> range_points( num_points );
+    Teuchos::ArrayRCP<double> range_data( field_dim*num_points );
+    Teuchos::ArrayRCP<double> gold_data( field_dim*num_points );
+    for ( int i = 0; i < num_points; ++i )
+    {
+	point_id = num_points*inverse_rank + i;
+	coords[0] = double(std::rand())/RAND_MAX;
+	coords[1] = double(std::rand())/RAND_MAX;
+	coords[2] = double(std::rand())/RAND_MAX;
+	range_points[i] = DataTransferKit::Point( point_id, comm_rank, coords );
+	for ( int d = 0; d < field_dim; ++d )
+	{
+	    range_data[d*num_points + i] = 0.0;
+	    gold_data[d*num_points + i] = coords[d];
+	}
+    }
+
+    // Make a manager for the domain geometry.
+    DataTransferKit::BasicGeometryManager domain_manager( 
+	comm, space_dim, DataTransferKit::ENTITY_TYPE_NODE, domain_points() );
+					   
+    // Make a manager for the range geometry.
+    DataTransferKit::BasicGeometryManager range_manager( 
+	comm, space_dim, DataTransferKit::ENTITY_TYPE_NODE, range_points() );
+
+    // Make a DOF vector for the domain.
+    Teuchos::RCP<Tpetra::MultiVector<double,int,std::size_t> > domain_vector =
+	DataTransferKit::EntityCenteredDOFVector::createTpetraMultiVectorFromEntitiesAndView(
+	    comm, domain_points(), field_dim, domain_data );
+
+    // Make a DOF vector for the range.
+    Teuchos::RCP<Tpetra::MultiVector<double,int,std::size_t> > range_vector =
+	DataTransferKit::EntityCenteredDOFVector::createTpetraMultiVectorFromEntitiesAndView(
+	    comm, range_points(), field_dim, range_data );
+
+    // Make a spline interpolation operator.
+    double radius = 0.5;
+    Teuchos::RCP<DataTransferKit::MapOperator<double> > spline_op =
+	Teuchos::rcp( 
+	    new DataTransferKit::SplineInterpolationOperator<double,DataTransferKit::WuBasis<2>,space_dim>(radius) );
+
+    // Setup the operator.
+    spline_op->setup( domain_vector->getMap(),
+		      domain_manager.functionSpace(),
+		      range_vector->getMap(),
+		      range_manager.functionSpace(),
+		      parameters );
+
+    // Apply the operator.
+    spline_op->apply( *domain_vector, *range_vector );
+
+    // Check the apply.
+    for ( int i = 0; i < field_dim*num_points; ++i )
+    {
+	TEST_FLOATING_EQUALITY( range_data[i], gold_data[i], 1.0 );
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( SplineInterpolationOperator, knn_rejected_test )
+{
+    // Get the communicator.
+    Teuchos::RCP<const Teuchos::Comm<int> > comm =
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_rank = comm->getRank();
+    const int space_dim = 3;
+    int field_dim = 1;
+
+    // Make a set of points.
+    int num_points = 10;
+    Teuchos::Array<DataTransferKit::Entity> points( num_points );
+    Teuchos::Array<double> coords( space_dim );
+    DataTransferKit::EntityId point_id = 0;
+    Teuchos::ArrayRCP<double> data( field_dim*num_points, 0.0 );
+    for ( int i = 0; i < num_points; ++i )
+    {
+	point_id = num_points*comm_rank + i;
+	coords[0] = point_id;
+	coords[1] = point_id;
+	coords[2] = point_id;
+	points[i] = DataTransferKit::Point( point_id, comm_rank, coords );
+    }
+    DataTransferKit::BasicGeometryManager manager( 
+	comm, space_dim, DataTransferKit::ENTITY_TYPE_NODE, points() );
+    Teuchos::RCP<Tpetra::MultiVector<double,int,std::size_t> > vector =
+	DataTransferKit::EntityCenteredDOFVector::createTpetraMultiVectorFromEntitiesAndView(
+	    comm, points(), field_dim, data );
+
+    // A nearest neighbor stencil does not give a symmetric positive definite
+    // coefficient matrix so the spline operator must reject it.
+    double radius = 2.0;
+    Teuchos::RCP<DataTransferKit::MapOperator<double> > spline_op =
+	Teuchos::rcp( 
+	    new DataTransferKit::SplineInterpolationOperator<double,DataTransferKit::WuBasis<2>,space_dim>(radius) );
+    Teuchos::RCP<Teuchos::ParameterList> parameters = Teuchos::parameterList();
+    parameters->set<std::string>( "Type of Search", "Nearest Neighbor" );
+    parameters->set<int>( "Num Neighbors", 3 );
+    TEST_THROW( spline_op->setup( vector->getMap(),
+				  manager.functionSpace(),
+				  vector->getMap(),
+				  manager.functionSpace(),
+				  parameters ),
+		DataTransferKit::Assertion );
+}
+
 //---------------------------------------------------------------------------//
 // end tstMovingLeastSquare.cpp
 //---------------------------------------------------------------------------//
@@ -53,6 +53,7 @@
 #include "Teuchos_ArrayRCP.hpp"
 #include "Teuchos_DefaultComm.hpp"
 #include "Teuchos_CommHelpers.hpp"
+#include "Teuchos_as.hpp"
 
 //---------------------------------------------------------------------------//
 // HELPER FUNCTIONS
@@ -199,6 +200,103 @@ TEUCHOS_UNIT_TEST( SplineInterpolationPairing, dim_3_test )
     TEST_EQUALITY( children_per_parent[1], 1 );
 }
 
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( SplineInterpolationPairing, dim_1_knn_test )
+{
+    int dim = 1;
+    int num_src_points = 10;
+    int num_src_coords = dim*num_src_points;
+
+    Teuchos::Array<double> src_coords(num_src_coords);
+    for ( int i = 0; i < num_src_points; ++i )
+    {
+	src_coords[dim*i] = 1.0*i;
+    }
+
+    int num_tgt_points = 2;
+    int num_tgt_coords = dim*num_tgt_points;
+    Teuchos::Array<double> tgt_coords( num_tgt_coords );
+    tgt_coords[0] = 4.9;
+    tgt_coords[1] = 10.0;
+
+    unsigned num_neighbors = 2;
+    double radius = 1.1;
+
+    DataTransferKit::SplineInterpolationPairing<1> pairing( 
+	src_coords(), tgt_coords(), num_neighbors, radius );
+    
+    Teuchos::ArrayView<const unsigned> view = pairing.childCenterIds( 0 );
+    TEST_EQUALITY( 2, view.size() );
+    TEST_EQUALITY( 5, view[0] )
+    TEST_EQUALITY( 4, view[1] )
+    TEST_FLOATING_EQUALITY( pairing.parentSupportRadius(0), 0.9*1.01, 1.0e-12 );
+
+    view = pairing.childCenterIds( 1 );
+    TEST_EQUALITY( 1, view.size() );
+    TEST_EQUALITY( 9, view[0] );
+    TEST_FLOATING_EQUALITY( pairing.parentSupportRadius(1), 1.01, 1.0e-12 );
+
+    Teuchos::ArrayRCP<std::size_t> children_per_parent = 
+	pairing.childrenPerParent();
+    TEST_EQUALITY( children_per_parent[0], 2 );
+    TEST_EQUALITY( children_per_parent[1], 1 );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( SplineInterpolationPairing, distances_test )
+{
+    int num_src_points = 1000;
+    Teuchos::Array<double> src_coords(num_src_points);
+    for ( int i = 0; i < num_src_points; ++i )
+    {
+	src_coords[i] = 1.0*i;
+    }
+
+    // Use enough targets to span several search blocks.
+    int num_tgt_points = 600;
+    Teuchos::Array<double> tgt_coords( num_tgt_points );
+    for ( int i = 0; i < num_tgt_points; ++i )
+    {
+	tgt_coords[i] = i + 0.25;
+    }
+
+    double radius = 1.1;
+
+    DataTransferKit::SplineInterpolationPairing<1> pairing( 
+	src_coords(), tgt_coords(), radius, true );
+    TEST_ASSERT( pairing.hasDistances() );
+
+    Teuchos::ArrayView<const unsigned> view;
+    Teuchos::ArrayView<const double> dists;
+    for ( int i = 0; i < num_tgt_points; ++i )
+    {
+	view = pairing.childCenterIds( i );
+	dists = pairing.childCenterDistances( i );
+	TEST_EQUALITY( 2, view.size() );
+	TEST_EQUALITY( 2, dists.size() );
+	TEST_EQUALITY( i, Teuchos::as<int>(view[0]) );
+	TEST_EQUALITY( i+1, Teuchos::as<int>(view[1]) );
+	TEST_FLOATING_EQUALITY( dists[0], 0.25, 1.0e-12 );
+	TEST_FLOATING_EQUALITY( dists[1], 0.75, 1.0e-12 );
+    }
+
+    DataTransferKit::SplineInterpolationPairing<1> knn_pairing( 
+	src_coords(), tgt_coords(), 1, radius, true );
+    TEST_ASSERT( knn_pairing.hasDistances() );
+    for ( int i = 0; i < num_tgt_points; ++i )
+    {
+	view = knn_pairing.childCenterIds( i );
+	dists = knn_pairing.childCenterDistances( i );
+	TEST_EQUALITY( 1, view.size() );
+	TEST_EQUALITY( i, Teuchos::as<int>(view[0]) );
+	TEST_FLOATING_EQUALITY( dists[0], 0.25, 1.0e-12 );
+    }
+
+    DataTransferKit::SplineInterpolationPairing<1> no_dist_pairing( 
+	src_coords(), tgt_coords(), radius );
+    TEST_ASSERT( !no_dist_pairing.hasDistances() );
+}
+
 //---------------------------------------------------------------------------//
 // end tstSplineInterpolationPairing.cpp
 //---------------------------------------------------------------------------//
@@ -0,0 +1,213 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   tstSplineInverseOperator.cpp
+ * \author Stuart R. Slattery
+ * \brief  Spline inverse operator tests.
+ */
+//---------------------------------------------------------------------------//
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <cstdlib>
+
+#include <DTK_SplineInverseOperator.hpp>
+#include <DTK_DBC.hpp>
+
+#include "Teuchos_UnitTestHarness.hpp"
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_Array.hpp"
+#include "Teuchos_ArrayRCP.hpp"
+#include "Teuchos_DefaultComm.hpp"
+#include "Teuchos_ParameterList.hpp"
+
+#include <Tpetra_Map.hpp>
+#include <Tpetra_MultiVector.hpp>
+#include <Tpetra_CrsMatrix.hpp>
+
+#include <Thyra_TpetraThyraWrappers.hpp>
+#include <Thyra_LinearOpWithSolveFactoryHelpers.hpp>
+
+#include <Stratimikos_DefaultLinearSolverBuilder.hpp>
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( SplineInverseOperator, reuse_test )
+{
+    // Initialize.
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    int num_rows = 10;
+    Teuchos::RCP<const Tpetra::Map<int,std::size_t> > map =
+	Tpetra::createUniformContigMap<int,std::size_t>( 
+	    num_rows*comm->getSize(), comm );
+
+    // Create a diagonal matrix.
+    Teuchos::RCP<Tpetra::CrsMatrix<double,int,std::size_t> > A =
+	Teuchos::rcp( new Tpetra::CrsMatrix<double,int,std::size_t>(map,1) );
+    Teuchos::ArrayView<const std::size_t> rows = map->getNodeElementList();
+    Teuchos::Array<std::size_t> index( 1 );
+    Teuchos::Array<double> value( 1 );
+    for ( int i = 0; i < num_rows; ++i )
+    {
+	index[0] = rows[i];
+	value[0] = 2.0 + i;
+	A->insertGlobalValues( rows[i], index(), value() );
+    }
+    A->fillComplete();
+
+    // Create the inverse.
+    Teuchos::RCP<const Thyra::LinearOpBase<double> > thyra_A =
+	Thyra::createConstLinearOp<double>(
+	    Teuchos::rcp_implicit_cast<const Tpetra::Operator<double,int,std::size_t> >(A) );
+    Teuchos::RCP<Teuchos::ParameterList> builder_params = 
+	Teuchos::parameterList();
+    builder_params->set<std::string>( "Linear Solver Type", "Belos" );
+    Stratimikos::DefaultLinearSolverBuilder builder;
+    builder.setParameterList( builder_params );
+    Teuchos::RCP<Thyra::LinearOpWithSolveFactoryBase<double> > factory = 
+	Thyra::createLinearSolveStrategy( builder );
+    DataTransferKit::SplineInverseOperator<double> A_inv(
+	Thyra::linearOpWithSolve<double>(*factory, thyra_A) );
+
+    // Apply the inverse to several right-hand sides. Each solve starts from
+    // the solution of the previous one.
+    int num_vec = 2;
+    Teuchos::RCP<Tpetra::MultiVector<double,int,std::size_t> > x =
+	Tpetra::createMultiVector<double,int,std::size_t>( map, num_vec );
+    Teuchos::RCP<Tpetra::MultiVector<double,int,std::size_t> > y =
+	Tpetra::createMultiVector<double,int,std::size_t>( map, num_vec );
+    Teuchos::RCP<Thyra::MultiVectorBase<double> > thyra_x =
+	Thyra::createMultiVector( x );
+    Teuchos::RCP<Thyra::MultiVectorBase<double> > thyra_y =
+	Thyra::createMultiVector( y );
+    for ( int k = 1; k < 4; ++k )
+    {
+	x->putScalar( 1.0 * k );
+	y->putScalar( 1.0 );
+	A_inv.apply( Thyra::NOTRANS, *thyra_x, thyra_y.ptr(), 2.0, 1.0 );
+
+	Teuchos::ArrayRCP<Teuchos::ArrayRCP<const double> > y_view = 
+	    y->get2dView();
+	for ( int n = 0; n < num_vec; ++n )
+	{
+	    for ( int i = 0; i < num_rows; ++i )
+	    {
+		TEST_FLOATING_EQUALITY( 
+		    y_view[n][i], 1.0 + 2.0 * k / (2.0 + i), 1.0e-6 );
+	    }
+	}
+    }
+
+    // Reset the initial guess and apply again.
+    A_inv.resetInitialGuess();
+    x->putScalar( 1.0 );
+    A_inv.apply( Thyra::NOTRANS, *thyra_x, thyra_y.ptr(), 1.0, 0.0 );
+    Teuchos::ArrayRCP<Teuchos::ArrayRCP<const double> > y_view = 
+	y->get2dView();
+    for ( int n = 0; n < num_vec; ++n )
+    {
+	for ( int i = 0; i < num_rows; ++i )
+	{
+	    TEST_FLOATING_EQUALITY( y_view[n][i], 1.0 / (2.0 + i), 1.0e-6 );
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( SplineInverseOperator, unconverged_test )
+{
+    // Initialize.
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    int num_rows = 10;
+    Teuchos::RCP<const Tpetra::Map<int,std::size_t> > map =
+	Tpetra::createUniformContigMap<int,std::size_t>( 
+	    num_rows*comm->getSize(), comm );
+
+    // Create a diagonal matrix with distinct eigenvalues.
+    Teuchos::RCP<Tpetra::CrsMatrix<double,int,std::size_t> > A =
+	Teuchos::rcp( new Tpetra::CrsMatrix<double,int,std::size_t>(map,1) );
+    Teuchos::ArrayView<const std::size_t> rows = map->getNodeElementList();
+    Teuchos::Array<std::size_t> index( 1 );
+    Teuchos::Array<double> value( 1 );
+    for ( int i = 0; i < num_rows; ++i )
+    {
+	index[0] = rows[i];
+	value[0] = 2.0 + i;
+	A->insertGlobalValues( rows[i], index(), value() );
+    }
+    A->fillComplete();
+
+    // Create an inverse with a solver that cannot converge in one
+    // iteration.
+    Teuchos::RCP<const Thyra::LinearOpBase<double> > thyra_A =
+	Thyra::createConstLinearOp<double>(
+	    Teuchos::rcp_implicit_cast<const Tpetra::Operator<double,int,std::size_t> >(A) );
+    Teuchos::RCP<Teuchos::ParameterList> builder_params = 
+	Teuchos::parameterList();
+    builder_params->set<std::string>( "Linear Solver Type", "Belos" );
+    Teuchos::ParameterList& belos_params = 
+	builder_params->sublist("Linear Solver Types").sublist("Belos");
+    belos_params.set<std::string>( "Solver Type", "Pseudo Block GMRES" );
+    belos_params.sublist("Solver Types").sublist("Pseudo Block GMRES").set<int>(
+	"Maximum Iterations", 1 );
+    Stratimikos::DefaultLinearSolverBuilder builder;
+    builder.setParameterList( builder_params );
+    Teuchos::RCP<Thyra::LinearOpWithSolveFactoryBase<double> > factory = 
+	Thyra::createLinearSolveStrategy( builder );
+    DataTransferKit::SplineInverseOperator<double> A_inv(
+	Thyra::linearOpWithSolve<double>(*factory, thyra_A) );
+
+    // The failed solve must be reported.
+    Teuchos::RCP<Tpetra::MultiVector<double,int,std::size_t> > x =
+	Tpetra::createMultiVector<double,int,std::size_t>( map, 1 );
+    Teuchos::RCP<Tpetra::MultiVector<double,int,std::size_t> > y =
+	Tpetra::createMultiVector<double,int,std::size_t>( map, 1 );
+    Teuchos::RCP<Thyra::MultiVectorBase<double> > thyra_x =
+	Thyra::createMultiVector( x );
+    Teuchos::RCP<Thyra::MultiVectorBase<double> > thyra_y =
+	Thyra::createMultiVector( y );
+    x->putScalar( 1.0 );
+    TEST_THROW( A_inv.apply( Thyra::NOTRANS, *thyra_x, thyra_y.ptr() ),
+		DataTransferKit::Assertion );
+}
+
+//---------------------------------------------------------------------------//
+// end tstSplineInverseOperator.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,235 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   tstSplineNeighborhood.cpp
+ * \author Stuart R. Slattery
+ * \brief  Spline neighborhood and neighborhood cache tests.
+ */
+//---------------------------------------------------------------------------//
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+#include <DTK_SplineNeighborhood.hpp>
+#include <DTK_SplineNeighborhoodCache.hpp>
+
+#include "Teuchos_UnitTestHarness.hpp"
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_Ptr.hpp"
+#include "Teuchos_Array.hpp"
+#include "Teuchos_ArrayRCP.hpp"
+#include "Teuchos_DefaultComm.hpp"
+#include "Teuchos_CommHelpers.hpp"
+
+//---------------------------------------------------------------------------//
+// HELPER FUNCTIONS
+//---------------------------------------------------------------------------//
+
+// Get the default communicator.
+Teuchos::RCP<const Teuchos::Comm<int> > getDefaultComm()
+{
+#ifdef HAVE_MPI
+    return Teuchos::DefaultComm<int>::getComm();
+#else
+    return Teuchos::rcp(new Teuchos::SerialComm<int>() );
+#endif
+}
+
+//---------------------------------------------------------------------------//
+// Build the source centers of a process in a row at y = 2*rank.
+void buildSources( const int rank,
+		   Teuchos::Array<double>& src_coords,
+		   Teuchos::Array<std::size_t>& src_gids )
+{
+    int num_src_points = 10;
+    src_coords.resize( 2*num_src_points );
+    src_gids.resize( num_src_points );
+    for ( int i = 0; i < num_src_points; ++i )
+    {
+	src_coords[2*i] = 1.0*i;
+	src_coords[2*i+1] = 2.0*rank;
+	src_gids[i] = 10*rank + i;
+    }
+}
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( SplineNeighborhood, neighborhood_test )
+{
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = getDefaultComm();
+    int rank = comm->getRank();
+    int size = comm->getSize();
+    int inverse_rank = size - rank - 1;
+
+    Teuchos::Array<double> src_coords;
+    Teuchos::Array<std::size_t> src_gids;
+    buildSources( rank, src_coords, src_gids );
+
+    Teuchos::Array<double> tgt_coords( 4 );
+    tgt_coords[0] = 4.9;
+    tgt_coords[1] = 2.0*inverse_rank;
+    tgt_coords[2] = 11.4;
+    tgt_coords[3] = 2.0*inverse_rank;
+
+    double radius = 1.5;
+
+    DataTransferKit::SplineNeighborhood<2> neighborhood(
+	comm, src_coords(), src_gids(), tgt_coords(), false, 0, radius );
+
+    int num_import = 6;
+    TEST_EQUALITY( num_import, neighborhood.distributor()->getNumImports() );
+    Teuchos::ArrayView<const double> dist_sources =
+	neighborhood.distributedSourceCenters();
+    Teuchos::ArrayView<const std::size_t> dist_gids =
+	neighborhood.distributedSourceGids();
+    TEST_EQUALITY( 2*num_import, dist_sources.size() );
+    TEST_EQUALITY( num_import, dist_gids.size() );
+    for ( int i = 0; i < num_import; ++i )
+    {
+	TEST_EQUALITY( dist_sources[2*i], 4.0+i );
+	TEST_EQUALITY( dist_gids[i], 10*inverse_rank + 4 + i );
+    }
+
+    Teuchos::ArrayView<const unsigned> view = 
+	neighborhood.pairings().childCenterIds( 0 );
+    TEST_EQUALITY( 3, view.size() );
+    TEST_EQUALITY( dist_gids[view[0]], 10*inverse_rank + 5 );
+    TEST_EQUALITY( dist_gids[view[1]], 10*inverse_rank + 4 );
+    TEST_EQUALITY( dist_gids[view[2]], 10*inverse_rank + 6 );
+    TEST_EQUALITY( 0, neighborhood.pairings().childCenterIds(1).size() );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( SplineNeighborhood, cache_test )
+{
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = getDefaultComm();
+    int rank = comm->getRank();
+    int size = comm->getSize();
+    int inverse_rank = size - rank - 1;
+
+    Teuchos::Array<double> src_coords;
+    Teuchos::Array<std::size_t> src_gids;
+    buildSources( rank, src_coords, src_gids );
+
+    Teuchos::Array<double> tgt_coords( 4 );
+    tgt_coords[0] = 4.9;
+    tgt_coords[1] = 2.0*inverse_rank;
+    tgt_coords[2] = 11.4;
+    tgt_coords[3] = 2.0*inverse_rank;
+
+    double radius = 1.5;
+
+    DataTransferKit::SplineNeighborhoodCache<2> cache;
+    TEST_EQUALITY( 0, cache.size() );
+
+    // The first request builds the neighborhood.
+    Teuchos::RCP<const DataTransferKit::SplineNeighborhood<2> > n1 =
+	cache.getNeighborhood( comm, src_coords(), src_gids(), tgt_coords(),
+			       false, 0, radius );
+    TEST_EQUALITY( 1, cache.size() );
+    TEST_EQUALITY( 0, cache.numHits() );
+
+    // A second request with the same clouds and support reuses it.
+    Teuchos::RCP<const DataTransferKit::SplineNeighborhood<2> > n2 =
+	cache.getNeighborhood( comm, src_coords(), src_gids(), tgt_coords(),
+			       false, 0, radius );
+    TEST_EQUALITY( 1, cache.size() );
+    TEST_EQUALITY( 1, cache.numHits() );
+    TEST_EQUALITY( n1.get(), n2.get() );
+
+    // A different target cloud, radius, or type of search builds a new one.
+    Teuchos::RCP<const DataTransferKit::SplineNeighborhood<2> > n3 =
+	cache.getNeighborhood( comm, src_coords(), src_gids(), src_coords(),
+			       false, 0, radius );
+    TEST_EQUALITY( 2, cache.size() );
+    TEST_INEQUALITY( n1.get(), n3.get() );
+
+    Teuchos::RCP<const DataTransferKit::SplineNeighborhood<2> > n4 =
+	cache.getNeighborhood( comm, src_coords(), src_gids(), tgt_coords(),
+			       false, 0, 2.0*radius );
+    TEST_EQUALITY( 3, cache.size() );
+    TEST_INEQUALITY( n1.get(), n4.get() );
+
+    Teuchos::RCP<const DataTransferKit::SplineNeighborhood<2> > n5 =
+	cache.getNeighborhood( comm, src_coords(), src_gids(), tgt_coords(),
+			       true, 2, radius );
+    TEST_EQUALITY( 4, cache.size() );
+    TEST_EQUALITY( 2, n5->pairings().childCenterIds(0).size() );
+
+    // The source/source neighborhood is also found after later requests.
+    Teuchos::RCP<const DataTransferKit::SplineNeighborhood<2> > n6 =
+	cache.getNeighborhood( comm, src_coords(), src_gids(), src_coords(),
+			       false, 0, radius );
+    TEST_EQUALITY( 4, cache.size() );
+    TEST_EQUALITY( 2, cache.numHits() );
+    TEST_EQUALITY( n3.get(), n6.get() );
+
+    // Matches are decided by the values of the clouds and not by their
+    // storage.
+    Teuchos::Array<double> src_copy( src_coords );
+    Teuchos::Array<std::size_t> gids_copy( src_gids );
+    Teuchos::RCP<const DataTransferKit::SplineNeighborhood<2> > n7 =
+	cache.getNeighborhood( comm, src_copy(), gids_copy(), tgt_coords(),
+			       false, 0, radius );
+    TEST_EQUALITY( 4, cache.size() );
+    TEST_EQUALITY( 3, cache.numHits() );
+    TEST_EQUALITY( n1.get(), n7.get() );
+
+    // A changed global id or target center builds a new neighborhood.
+    gids_copy[0] += 1;
+    Teuchos::RCP<const DataTransferKit::SplineNeighborhood<2> > n8 =
+	cache.getNeighborhood( comm, src_copy(), gids_copy(), tgt_coords(),
+			       false, 0, radius );
+    TEST_EQUALITY( 5, cache.size() );
+    TEST_INEQUALITY( n1.get(), n8.get() );
+
+    tgt_coords[2] = 11.5;
+    Teuchos::RCP<const DataTransferKit::SplineNeighborhood<2> > n9 =
+	cache.getNeighborhood( comm, src_coords(), src_gids(), tgt_coords(),
+			       false, 0, radius );
+    TEST_EQUALITY( 6, cache.size() );
+    TEST_EQUALITY( 3, cache.numHits() );
+    TEST_INEQUALITY( n1.get(), n9.get() );
+
+    cache.clear();
+    TEST_EQUALITY( 0, cache.size() );
+}
+
+//---------------------------------------------------------------------------//
+// end tstSplineNeighborhood.cpp
+//---------------------------------------------------------------------------//
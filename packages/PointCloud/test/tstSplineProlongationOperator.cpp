@@ -112,6 +112,84 @@ TEUCHOS_UNIT_TEST( SplineProlongationOperator, polynomial_matrix_apply )
     }
 }
 
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( SplineProlongationOperator, balanced_apply )
+{
+    // Spread the polynomial coefficients over the processes and prolongate a
+    // multivector.
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_rank = comm->getRank();
+    int comm_size = comm->getSize();
+    int local_size = 100;
+    int global_size = local_size * comm_size;
+    int num_vec = 3;
+    int poly_size = 4;
+    int offset = 0;
+    int poly_begin = 0;
+    for ( int p = 0; p < poly_size; ++p )
+    {
+	int owner = (p * comm_size) / poly_size;
+	if ( owner == comm_rank )
+	{
+	    ++offset;
+	}
+	else if ( owner < comm_rank )
+	{
+	    ++poly_begin;
+	}
+    }
+
+    // Create a map.
+    Teuchos::RCP<const Tpetra::Map<int,int> > map = 
+	Tpetra::createUniformContigMap<int,int>( global_size, comm );
+
+    // Create a prolongator.
+    DataTransferKit::SplineProlongationOperator<double,int> 
+	prolongation_op( offset, map );
+
+    // Check the prolongator.
+    Teuchos::RCP<const Tpetra::Map<int,int> > range_map =
+	prolongation_op.getRangeMap();
+    TEST_EQUALITY( range_map->getNodeNumElements(),
+		   Teuchos::as<unsigned>(offset + local_size) );
+    TEST_EQUALITY( range_map->getGlobalNumElements(),
+		   Teuchos::as<unsigned>(poly_size + global_size) );
+    for ( int i = 0; i < offset; ++i )
+    {
+	TEST_EQUALITY( range_map->getGlobalElement(i), 
+		       global_size + poly_begin + i );
+    }
+
+    // Build a random vector to prolongate.
+    Teuchos::RCP<Tpetra::MultiVector<double,int,int> > X =
+	Tpetra::createMultiVector<double,int,int>( map, num_vec );
+    X->randomize();
+
+    // Build a prolongated vector.
+    Teuchos::RCP<Tpetra::MultiVector<double,int,int> > Y =
+	Tpetra::createMultiVector<double,int,int>( range_map, num_vec );
+    Y->putScalar( 1.0 );
+
+    // Prolongate.
+    prolongation_op.apply( *X, *Y );
+
+    // Compare the results.
+    Teuchos::ArrayRCP<Teuchos::ArrayRCP<const double> > X_view = X->get2dView();
+    Teuchos::ArrayRCP<Teuchos::ArrayRCP<const double> > Y_view = Y->get2dView();
+    for ( int i = 0; i < num_vec; ++i )
+    {
+	for ( int j = 0; j < offset; ++j )
+	{
+	    TEST_EQUALITY( Y_view[i][j], 0.0 );
+	}
+	for ( int j = 0; j < local_size; ++j )
+	{
+	    TEST_EQUALITY( Y_view[i][j+offset], X_view[i][j] );
+	}
+    }
+}
+
 //---------------------------------------------------------------------------//
 // end tstSplineProlongationOperator.cpp
 //---------------------------------------------------------------------------//
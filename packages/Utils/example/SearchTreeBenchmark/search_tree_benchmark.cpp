@@ -0,0 +1,416 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   search_tree_benchmark.cpp
+ * \author Stuart R. Slattery
+ * \brief  Search tree benchmarks over synthetic point clouds.
+ */
+//---------------------------------------------------------------------------//
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include <random>
+#include <cstdlib>
+
+#include <DTK_StaticSearchTree.hpp>
+#include <DTK_SpaceFillingCurve.hpp>
+#include <DTK_DBC.hpp>
+
+#include <Teuchos_CommandLineProcessor.hpp>
+#include <Teuchos_Array.hpp>
+#include <Teuchos_ArrayView.hpp>
+#include <Teuchos_Ptr.hpp>
+#include <Teuchos_Time.hpp>
+
+#if HAVE_DTK_OPENMP
+#include <omp.h>
+#endif
+
+//---------------------------------------------------------------------------//
+// Benchmark settings.
+//---------------------------------------------------------------------------//
+struct BenchmarkSettings
+{
+    int num_points;
+    int num_queries;
+    int num_neighbors;
+    int num_repeat;
+    DataTransferKit::SpaceFillingCurve::CurveType curve;
+    std::string curve_name;
+    bool leaf_blocks;
+    bool parallel_build;
+    Teuchos::Array<int> leaf_sizes;
+};
+
+//---------------------------------------------------------------------------//
+// Split a comma separated list.
+//---------------------------------------------------------------------------//
+Teuchos::Array<std::string> splitList( const std::string& list )
+{
+    Teuchos::Array<std::string> items;
+    std::stringstream stream( list );
+    std::string item;
+    while ( std::getline(stream, item, ',') )
+    {
+	if ( !item.empty() )
+	{
+	    items.push_back( item );
+	}
+    }
+    return items;
+}
+
+//---------------------------------------------------------------------------//
+// Build a synthetic point cloud over the unit box.
+//
+// uniform:     Uniform in the unit box.
+// clustered:   Normal clusters around 16 uniform centers.
+// anisotropic: Uniform with each dimension 100 times thinner than the
+//              last.
+// surface:     Points on the sphere of diameter 1 in the unit box with a
+//              small normal jitter. In 1D the sphere is the two ends of the
+//              unit interval.
+//---------------------------------------------------------------------------//
+bool buildCloud( const int dim, 
+		 const std::string& distribution,
+		 const int num_points,
+		 std::mt19937& generator,
+		 Teuchos::Array<double>& points )
+{
+    std::uniform_real_distribution<double> uniform( 0.0, 1.0 );
+    std::normal_distribution<double> normal( 0.0, 1.0 );
+    points.resize( dim*num_points );
+
+    if ( "uniform" == distribution )
+    {
+	for ( int n = 0; n < dim*num_points; ++n )
+	{
+	    points[n] = uniform( generator );
+	}
+    }
+    else if ( "clustered" == distribution )
+    {
+	int num_clusters = 16;
+	Teuchos::Array<double> centers( dim*num_clusters );
+	for ( int n = 0; n < dim*num_clusters; ++n )
+	{
+	    centers[n] = uniform( generator );
+	}
+	std::uniform_int_distribution<int> cluster( 0, num_clusters - 1 );
+	for ( int i = 0; i < num_points; ++i )
+	{
+	    int c = cluster( generator );
+	    for ( int d = 0; d < dim; ++d )
+	    {
+		points[dim*i+d] = centers[dim*c+d] + 0.01*normal( generator );
+	    }
+	}
+    }
+    else if ( "anisotropic" == distribution )
+    {
+	for ( int i = 0; i < num_points; ++i )
+	{
+	    for ( int d = 0; d < dim; ++d )
+	    {
+		points[dim*i+d] = std::pow( 0.01, d ) * uniform( generator );
+	    }
+	}
+    }
+    else if ( "surface" == distribution )
+    {
+	double norm = 0.0;
+	for ( int i = 0; i < num_points; ++i )
+	{
+	    norm = 0.0;
+	    for ( int d = 0; d < dim; ++d )
+	    {
+		points[dim*i+d] = normal( generator );
+		norm += points[dim*i+d] * points[dim*i+d];
+	    }
+	    norm = std::sqrt( norm );
+	    for ( int d = 0; d < dim; ++d )
+	    {
+		points[dim*i+d] = 0.5 + 0.5*points[dim*i+d]/norm +
+				  1.0e-4*normal( generator );
+	    }
+	}
+    }
+    else
+    {
+	return false;
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------//
+// Benchmark the trees over one cloud and write a row for each leaf size.
+//---------------------------------------------------------------------------//
+template<int DIM>
+void benchmarkCloud( const std::string& distribution,
+		     const Teuchos::ArrayView<const double>& points,
+		     const Teuchos::ArrayView<const double>& queries,
+		     const BenchmarkSettings& settings,
+		     const int num_threads,
+		     std::ostream& output )
+{
+    Teuchos::Array<std::size_t> offsets;
+    Teuchos::Array<unsigned> neighbors;
+    Teuchos::Array<double> dists;
+
+    // Search the radius that holds the requested number of neighbors on
+    // average so the radius and n-nearest neighbor searches return the
+    // same amount of data.
+    double radius = 0.0;
+    {
+	DataTransferKit::NanoflannTree<DIM> tree( points, 10 );
+	tree.nnSearchBatch( queries, settings.num_neighbors, 
+			    offsets, neighbors, Teuchos::ptrFromRef(dists) );
+	for ( int q = 0; q < settings.num_queries; ++q )
+	{
+	    if ( offsets[q+1] > offsets[q] )
+	    {
+		radius += dists[ offsets[q+1] - 1 ];
+	    }
+	}
+	radius /= settings.num_queries;
+    }
+
+    Teuchos::Time timer( "search tree benchmark" );
+    for ( int l = 0; l < settings.leaf_sizes.size(); ++l )
+    {
+	// Keep the fastest of the repeated runs.
+	double build_time = 0.0;
+	double knn_time = 0.0;
+	double radius_time = 0.0;
+	std::size_t memory = 0;
+	std::size_t num_radius_neighbors = 0;
+	for ( int r = 0; r < settings.num_repeat; ++r )
+	{
+	    timer.start( true );
+	    DataTransferKit::NanoflannTree<DIM> tree( 
+		points, settings.leaf_sizes[l], settings.parallel_build,
+		settings.curve, settings.leaf_blocks );
+	    timer.stop();
+	    build_time = ( 0 == r ) ? timer.totalElapsedTime()
+			 : std::min( build_time, timer.totalElapsedTime() );
+	    memory = tree.usedMemory();
+
+	    timer.start( true );
+	    tree.nnSearchBatch( queries, settings.num_neighbors, 
+				offsets, neighbors );
+	    timer.stop();
+	    knn_time = ( 0 == r ) ? timer.totalElapsedTime()
+		       : std::min( knn_time, timer.totalElapsedTime() );
+
+	    timer.start( true );
+	    tree.radiusSearchBatch( queries, radius, offsets, neighbors );
+	    timer.stop();
+	    radius_time = ( 0 == r ) ? timer.totalElapsedTime()
+			  : std::min( radius_time, timer.totalElapsedTime() );
+	    num_radius_neighbors = neighbors.size();
+	}
+
+	output << DIM << ","
+	       << distribution << ","
+	       << points.size() / DIM << ","
+	       << settings.num_queries << ","
+	       << settings.leaf_sizes[l] << ","
+	       << settings.curve_name << ","
+	       << settings.leaf_blocks << ","
+	       << settings.parallel_build << ","
+	       << num_threads << ","
+	       << build_time << ","
+	       << memory << ","
+	       << settings.num_neighbors << ","
+	       << knn_time << ","
+	       << settings.num_queries / knn_time << ","
+	       << radius << ","
+	       << double(num_radius_neighbors) / settings.num_queries << ","
+	       << radius_time << ","
+	       << settings.num_queries / radius_time << std::endl;
+    }
+}
+
+//---------------------------------------------------------------------------//
+// Benchmark driver.
+//---------------------------------------------------------------------------//
+int main( int argc, char* argv[] )
+{
+    // Read in command line options.
+    BenchmarkSettings settings;
+    settings.num_points = 100000;
+    settings.num_queries = 10000;
+    settings.num_neighbors = 8;
+    settings.num_repeat = 3;
+    settings.curve_name = "None";
+    settings.leaf_blocks = false;
+    settings.parallel_build = false;
+    std::string dim_list = "1,2,3";
+    std::string distribution_list = "uniform,clustered,anisotropic,surface";
+    std::string leaf_size_list = "2,5,10,20,50";
+    int seed = 5489;
+    std::string output_filename;
+
+    Teuchos::CommandLineProcessor clp(false);
+    clp.setDocString( 
+	"Benchmark NanoflannTree construction, n-nearest neighbor and radius "
+	"searches over synthetic point clouds. Writes one CSV row for each "
+	"dimension, distribution and leaf size. Times are in seconds, rates "
+	"in queries per second and memory in bytes." );
+    clp.setOption( "dims", &dim_list,
+		   "Comma separated spatial dimensions" );
+    clp.setOption( "distributions", &distribution_list,
+		   "Comma separated point distributions: uniform, clustered, "
+		   "anisotropic, surface" );
+    clp.setOption( "points", &settings.num_points,
+		   "Number of tree points" );
+    clp.setOption( "queries", &settings.num_queries,
+		   "Number of query points" );
+    clp.setOption( "neighbors", &settings.num_neighbors,
+		   "Number of neighbors for n-nearest neighbor searches" );
+    clp.setOption( "leaf-sizes", &leaf_size_list,
+		   "Comma separated maximum leaf sizes" );
+    clp.setOption( "repeat", &settings.num_repeat,
+		   "Number of runs of each case. The fastest is reported" );
+    clp.setOption( "curve", &settings.curve_name,
+		   "Space filling curve to sort the points: None, Morton, "
+		   "Hilbert" );
+    clp.setOption( "leaf-blocks", "no-leaf-blocks", &settings.leaf_blocks,
+		   "Store the leaf coordinates in blocks" );
+    clp.setOption( "parallel-build", "serial-build", 
+		   &settings.parallel_build,
+		   "Build the trees with threads" );
+    clp.setOption( "seed", &seed, "Random number seed" );
+    clp.setOption( "output", &output_filename,
+		   "CSV output file. Writes to standard output if empty" );
+    Teuchos::CommandLineProcessor::EParseCommandLineReturn parse_return =
+	clp.parse( argc, argv );
+    if ( Teuchos::CommandLineProcessor::PARSE_HELP_PRINTED == parse_return )
+    {
+	return 0;
+    }
+    if ( Teuchos::CommandLineProcessor::PARSE_SUCCESSFUL != parse_return )
+    {
+	return 1;
+    }
+
+    // Check the options.
+    Teuchos::Array<std::string> dim_names = splitList( dim_list );
+    Teuchos::Array<int> dims;
+    for ( int d = 0; d < dim_names.size(); ++d )
+    {
+	dims.push_back( std::atoi(dim_names[d].c_str()) );
+	DTK_INSIST( 1 <= dims.back() && dims.back() <= 3 );
+    }
+    Teuchos::Array<std::string> distributions = 
+	splitList( distribution_list );
+    Teuchos::Array<std::string> leaf_sizes = splitList( leaf_size_list );
+    for ( int l = 0; l < leaf_sizes.size(); ++l )
+    {
+	settings.leaf_sizes.push_back( std::atoi(leaf_sizes[l].c_str()) );
+	DTK_INSIST( 0 < settings.leaf_sizes.back() );
+    }
+    DTK_INSIST( 0 < settings.num_points );
+    DTK_INSIST( 0 < settings.num_queries );
+    DTK_INSIST( 0 < settings.num_neighbors );
+    DTK_INSIST( settings.num_neighbors <= settings.num_points );
+    DTK_INSIST( 0 < settings.num_repeat );
+    settings.curve = 
+	DataTransferKit::SpaceFillingCurve::curveType( settings.curve_name );
+
+    int num_threads = 1;
+#if HAVE_DTK_OPENMP
+    num_threads = omp_get_max_threads();
+#endif
+
+    std::ofstream output_file;
+    if ( !output_filename.empty() )
+    {
+	output_file.open( output_filename.c_str() );
+	DTK_INSIST( output_file.good() );
+    }
+    std::ostream& output = 
+	output_filename.empty() ? std::cout : output_file;
+    output << "dim,distribution,num_points,num_queries,leaf_size,curve,"
+	   << "leaf_blocks,parallel_build,num_threads,build_time,memory,"
+	   << "num_neighbors,knn_time,knn_rate,radius,radius_neighbors,"
+	   << "radius_time,radius_rate" << std::endl;
+
+    // Run each cloud.
+    std::mt19937 generator( seed );
+    Teuchos::Array<double> cloud;
+    for ( int d = 0; d < dims.size(); ++d )
+    {
+	int dim = dims[d];
+	for ( int n = 0; n < distributions.size(); ++n )
+	{
+	    // Draw the queries from the same cloud as the tree points.
+	    bool valid_distribution = buildCloud( 
+		dim, distributions[n], 
+		settings.num_points + settings.num_queries, 
+		generator, cloud );
+	    DTK_INSIST( valid_distribution );
+	    Teuchos::ArrayView<const double> points = 
+		cloud( 0, dim*settings.num_points );
+	    Teuchos::ArrayView<const double> queries = 
+		cloud( dim*settings.num_points, dim*settings.num_queries );
+
+	    switch ( dim )
+	    {
+		case 1:
+		    benchmarkCloud<1>( distributions[n], points, queries, 
+				       settings, num_threads, output );
+		    break;
+		case 2:
+		    benchmarkCloud<2>( distributions[n], points, queries, 
+				       settings, num_threads, output );
+		    break;
+		case 3:
+		    benchmarkCloud<3>( distributions[n], points, queries, 
+				       settings, num_threads, output );
+		    break;
+	    }
+	}
+    }
+
+    return 0;
+}
+
+//---------------------------------------------------------------------------//
+// end search_tree_benchmark.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,101 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_BatchSearch.hpp
+ * \author Stuart R. Slattery
+ * \brief  Blocked driver for batches of variable size searches.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef DTK_BATCHSEARCH_HPP
+#define DTK_BATCHSEARCH_HPP
+
+#include <cstddef>
+
+#include <Teuchos_Array.hpp>
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \class BatchSearch
+ *
+ * \brief Run a batch of searches that each find a different number of
+ * results and gather the results in compressed row form.
+ *
+ * The query object searches a single query with
+ *
+ * void operator()( const int query, Teuchos::Array<Result>& results ) const
+ *
+ * and replaces the contents of results. The store object receives the
+ * results with
+ *
+ * void resize( const std::size_t num_results )
+ *
+ * void operator()( const std::size_t position, const Result& result ) const
+ *
+ * where resize is called once with the total number of results before any
+ * result is stored. Results are stored concurrently at distinct positions.
+ */
+//---------------------------------------------------------------------------//
+class BatchSearch
+{
+  public:
+
+    // Search a batch of queries in blocks and store the results.
+    template<class Result,class Query,class Store>
+    static void search( const int num_queries,
+			const int block_size,
+			const Query& query,
+			Store& store,
+			Teuchos::Array<std::size_t>& offsets );
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+// Template includes.
+//---------------------------------------------------------------------------//
+
+#include "DTK_BatchSearch_impl.hpp"
+
+//---------------------------------------------------------------------------//
+
+#endif // end DTK_BATCHSEARCH_HPP
+
+//---------------------------------------------------------------------------//
+// end DTK_BatchSearch.hpp
+//---------------------------------------------------------------------------//
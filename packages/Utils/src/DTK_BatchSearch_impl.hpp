@@ -0,0 +1,136 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_BatchSearch_impl.hpp
+ * \author Stuart R. Slattery
+ * \brief  Blocked driver for batches of variable size searches.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef DTK_BATCHSEARCH_IMPL_HPP
+#define DTK_BATCHSEARCH_IMPL_HPP
+
+#include <algorithm>
+
+#include "DTK_DBC.hpp"
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Search a batch of queries in blocks and store the results.
+ *
+ * \param num_queries The number of queries in the batch.
+ *
+ * \param block_size The number of queries searched together by a thread.
+ *
+ * \param query The single query search.
+ *
+ * \param store The result output.
+ *
+ * \param offsets Returns the offset of the first result of each query into
+ * the stored results. Its size is the number of queries plus one.
+ *
+ * The queries are split into blocks searched in parallel. Each block
+ * gathers its results in its own buffer and the buffers are stored after
+ * the offsets are computed.
+ */
+template<class Result,class Query,class Store>
+void BatchSearch::search( const int num_queries,
+			  const int block_size,
+			  const Query& query,
+			  Store& store,
+			  Teuchos::Array<std::size_t>& offsets )
+{
+    DTK_REQUIRE( 0 <= num_queries );
+    DTK_REQUIRE( 0 < block_size );
+
+    offsets.assign( num_queries + 1, 0 );
+
+    // Search the blocks.
+    int num_blocks = (num_queries + block_size - 1) / block_size;
+    Teuchos::Array<Teuchos::Array<Result> > block_results( num_blocks );
+    std::size_t* offset_ptr = offsets.getRawPtr();
+#if HAVE_DTK_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for ( int b = 0; b < num_blocks; ++b )
+    {
+	int begin = b * block_size;
+	int end = std::min( begin + block_size, num_queries );
+	Teuchos::Array<Result>& results = block_results[b];
+	Teuchos::Array<Result> query_results;
+	for ( int i = begin; i < end; ++i )
+	{
+	    query( i, query_results );
+	    offset_ptr[i+1] = query_results.size();
+	    results.insert( results.end(), 
+			    query_results.begin(), query_results.end() );
+	}
+    }
+
+    // Compute the offsets.
+    for ( int i = 0; i < num_queries; ++i )
+    {
+	offsets[i+1] += offsets[i];
+    }
+    store.resize( offsets.back() );
+
+    // Store the blocks.
+#if HAVE_DTK_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for ( int b = 0; b < num_blocks; ++b )
+    {
+	const Teuchos::Array<Result>& results = block_results[b];
+	std::size_t begin = offset_ptr[b * block_size];
+	int num_results = results.size();
+	for ( int n = 0; n < num_results; ++n )
+	{
+	    store( begin + n, results[n] );
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+
+#endif // end DTK_BATCHSEARCH_IMPL_HPP
+
+//---------------------------------------------------------------------------//
+// end DTK_BatchSearch_impl.hpp
+//---------------------------------------------------------------------------//
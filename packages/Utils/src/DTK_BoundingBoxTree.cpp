@@ -0,0 +1,610 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_BoundingBoxTree.cpp
+ * \author Stuart R. Slattery
+ * \brief  Axis-aligned bounding box tree.
+ */
+//---------------------------------------------------------------------------//
+
+#include <limits>
+#include <algorithm>
+#include <cmath>
+
+#include "DTK_BoundingBoxTree.hpp"
+#include "DTK_BatchSearch.hpp"
+#include "DTK_DBC.hpp"
+
+#include <Teuchos_as.hpp>
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Compare box ids by the coordinate of their centers in one
+ * dimension. Ties are ordered by id so the tree does not depend on the
+ * selection algorithm.
+ */
+class BoundingBoxTreeCenterCompare
+{
+  public:
+
+    BoundingBoxTreeCenterCompare( const double* centers,
+				  const int dim,
+				  const int d )
+	: d_centers( centers )
+	, d_dim( dim )
+	, d_d( d )
+    { /* ... */ }
+
+    bool operator()( const unsigned a, const unsigned b ) const
+    { 
+	return ( d_centers[d_dim*a+d_d] < d_centers[d_dim*b+d_d] ) ||
+	    ( d_centers[d_dim*a+d_d] == d_centers[d_dim*b+d_d] && a < b );
+    }
+
+  private:
+    const double* d_centers;
+    int d_dim;
+    int d_d;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Point or box search of a single batch query for BatchSearch.
+ */
+class BoundingBoxTreeBatchQuery
+{
+  public:
+
+    BoundingBoxTreeBatchQuery( const BoundingBoxTree& tree,
+			       const bool point_query,
+			       const double* queries,
+			       const int query_size )
+	: d_tree( tree )
+	, d_point_query( point_query )
+	, d_queries( queries )
+	, d_query_size( query_size )
+    { /* ... */ }
+
+    void operator()( const int i, Teuchos::Array<unsigned>& box_ids ) const
+    {
+	if ( d_point_query )
+	{
+	    d_tree.pointSearch( d_queries + i*d_query_size, box_ids );
+	}
+	else
+	{
+	    d_tree.boxSearch( d_queries + i*d_query_size, box_ids );
+	}
+    }
+
+  private:
+
+    const BoundingBoxTree& d_tree;
+    bool d_point_query;
+    const double* d_queries;
+    int d_query_size;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Store the box ids of a batch search for BatchSearch.
+ */
+class BoundingBoxTreeIdStore
+{
+  public:
+
+    BoundingBoxTreeIdStore( Teuchos::Array<unsigned>& box_ids )
+	: d_box_ids( box_ids )
+	, d_id_ptr( 0 )
+    { /* ... */ }
+
+    void resize( const std::size_t num_ids )
+    {
+	d_box_ids.resize( num_ids );
+	d_id_ptr = d_box_ids.getRawPtr();
+    }
+
+    void operator()( const std::size_t n, const unsigned id ) const
+    {
+	d_id_ptr[n] = id;
+    }
+
+  private:
+
+    Teuchos::Array<unsigned>& d_box_ids;
+    unsigned* d_id_ptr;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Constructor.
+ *
+ * \param space_dim The spatial dimension of the boxes.
+ *
+ * \param boxes The boxes, 6 values per box in the DTK bounding box layout.
+ * The boxes are copied.
+ *
+ * \param max_leaf_size The maximum number of boxes in a leaf.
+ */
+BoundingBoxTree::BoundingBoxTree( 
+    const int space_dim,
+    const Teuchos::ArrayView<const double>& boxes,
+    const unsigned max_leaf_size )
+    : d_space_dim( space_dim )
+    , d_max_leaf_size( max_leaf_size )
+{
+    DTK_REQUIRE( 0 < space_dim && space_dim <= 3 );
+    DTK_REQUIRE( 0 == boxes.size() % 6 );
+    DTK_REQUIRE( 0 < max_leaf_size );
+
+    int num_boxes = boxes.size() / 6;
+    d_ids.resize( num_boxes );
+    Teuchos::Array<double> centers( num_boxes * d_space_dim );
+    for ( int i = 0; i < num_boxes; ++i )
+    {
+	d_ids[i] = i;
+	for ( int d = 0; d < d_space_dim; ++d )
+	{
+	    centers[i*d_space_dim + d] = 0.5 * (boxes[6*i+d] + boxes[6*i+d+3]);
+	}
+    }
+
+    // Build the tree. This orders the box ids.
+    if ( num_boxes > 0 )
+    {
+	buildNode( boxes, centers(), 0, num_boxes );
+    }
+
+    // Store the boxes in tree order so the boxes of a leaf are contiguous.
+    d_boxes.resize( boxes.size() );
+    for ( int i = 0; i < num_boxes; ++i )
+    {
+	std::copy( boxes.begin() + 6*d_ids[i], boxes.begin() + 6*d_ids[i] + 6,
+		   d_boxes.begin() + 6*i );
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Find the boxes that contain a point.
+ *
+ * \param point The point coordinates.
+ *
+ * \param box_ids Returns the ids of the boxes containing the point in
+ * increasing order. The array is cleared first.
+ */
+void BoundingBoxTree::pointSearch( const double* point, 
+				   Teuchos::Array<unsigned>& box_ids ) const
+{
+    box_ids.clear();
+    if ( !d_nodes.empty() )
+    {
+	pointSearchNode( 0, point, box_ids );
+	std::sort( box_ids.begin(), box_ids.end() );
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Find the boxes that overlap a box.
+ *
+ * \param box The box, 6 values in the DTK bounding box layout.
+ *
+ * \param box_ids Returns the ids of the boxes overlapping the box in
+ * increasing order. The array is cleared first.
+ */
+void BoundingBoxTree::boxSearch( const double* box, 
+				 Teuchos::Array<unsigned>& box_ids ) const
+{
+    box_ids.clear();
+    if ( !d_nodes.empty() )
+    {
+	boxSearchNode( 0, box, box_ids );
+	std::sort( box_ids.begin(), box_ids.end() );
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Find the boxes nearest to a point.
+ *
+ * \param point The point coordinates.
+ *
+ * \param num_neighbors The number of boxes to find. If the tree has fewer
+ * boxes then all of them are found.
+ *
+ * \param neighbors Returns the ids of the nearest boxes with their squared
+ * distances to the point, sorted by distance. The distance to a box
+ * containing the point is zero.
+ */
+void BoundingBoxTree::nearestSearch( 
+    const double* point,
+    const unsigned num_neighbors,
+    Teuchos::Array<std::pair<unsigned,double> >& neighbors ) const
+{
+    unsigned num_found = 
+	std::min( num_neighbors, Teuchos::as<unsigned>(d_ids.size()) );
+    neighbors.resize( num_found );
+    if ( 0 == num_found )
+    {
+	return;
+    }
+
+    Teuchos::Array<unsigned> ids( num_found );
+    Teuchos::Array<double> dists( num_found );
+    nanoflann::KNNResultSet<double,unsigned> result_set( num_found );
+    result_set.init( ids.getRawPtr(), dists.getRawPtr() );
+    nearestSearchNode( 0, point, result_set );
+    for ( unsigned n = 0; n < num_found; ++n )
+    {
+	neighbors[n] = std::make_pair( ids[n], dists[n] );
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Find the boxes that contain each point of a batch.
+ *
+ * \param points The point coordinates, space_dim values per point.
+ *
+ * \param offsets Returns the offset of the first box of each point into the
+ * box ids. Its size is the number of points plus one.
+ *
+ * \param box_ids Returns the ids of the boxes containing each point in
+ * increasing order.
+ */
+void BoundingBoxTree::pointSearchBatch( 
+    const Teuchos::ArrayView<const double>& points,
+    Teuchos::Array<std::size_t>& offsets,
+    Teuchos::Array<unsigned>& box_ids ) const
+{
+    DTK_REQUIRE( 0 == points.size() % d_space_dim );
+    searchBatch( POINT_QUERY, points, offsets, box_ids );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Find the boxes that overlap each box of a batch.
+ *
+ * \param boxes The query boxes, 6 values per box in the DTK bounding box
+ * layout.
+ *
+ * \param offsets Returns the offset of the first box overlapping each query
+ * box into the box ids. Its size is the number of query boxes plus one.
+ *
+ * \param box_ids Returns the ids of the boxes overlapping each query box in
+ * increasing order.
+ */
+void BoundingBoxTree::boxSearchBatch( 
+    const Teuchos::ArrayView<const double>& boxes,
+    Teuchos::Array<std::size_t>& offsets,
+    Teuchos::Array<unsigned>& box_ids ) const
+{
+    DTK_REQUIRE( 0 == boxes.size() % 6 );
+    searchBatch( BOX_QUERY, boxes, offsets, box_ids );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Find the boxes nearest to each point of a batch.
+ *
+ * \param points The point coordinates, space_dim values per point.
+ *
+ * \param num_neighbors The number of boxes to find for each point. If the
+ * tree has fewer boxes then all of them are found.
+ *
+ * \param offsets Returns the offset of the first box of each point into the
+ * box ids. Its size is the number of points plus one.
+ *
+ * \param box_ids Returns the ids of the nearest boxes of each point sorted
+ * by distance.
+ *
+ * \param box_dists If not null, returns the distance to each box.
+ */
+void BoundingBoxTree::nearestSearchBatch( 
+    const Teuchos::ArrayView<const double>& points,
+    const unsigned num_neighbors,
+    Teuchos::Array<std::size_t>& offsets,
+    Teuchos::Array<unsigned>& box_ids,
+    const Teuchos::Ptr<Teuchos::Array<double> >& box_dists ) const
+{
+    DTK_REQUIRE( 0 == points.size() % d_space_dim );
+
+    int num_points = points.size() / d_space_dim;
+    std::size_t num_found = 
+	std::min( num_neighbors, Teuchos::as<unsigned>(d_ids.size()) );
+    bool store_dists = Teuchos::nonnull( box_dists );
+
+    offsets.resize( num_points + 1 );
+    for ( int i = 0; i < num_points + 1; ++i )
+    {
+	offsets[i] = i * num_found;
+    }
+    box_ids.resize( num_points * num_found );
+    if ( store_dists )
+    {
+	box_dists->resize( num_points * num_found );
+    }
+    if ( 0 == num_found )
+    {
+	return;
+    }
+
+    // Every point has the same number of boxes so each one is written
+    // directly into its slot of the output.
+    int num_blocks = 
+	(num_points + d_batch_block_size - 1) / d_batch_block_size;
+    const double* point_ptr = points.getRawPtr();
+    unsigned* id_ptr = box_ids.getRawPtr();
+    double* dist_ptr = store_dists ? box_dists->getRawPtr() : 0;
+#if HAVE_DTK_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for ( int b = 0; b < num_blocks; ++b )
+    {
+	int begin = b * d_batch_block_size;
+	int end = std::min( begin + d_batch_block_size, num_points );
+	Teuchos::Array<double> block_dists( store_dists ? 0 : num_found );
+	double* dists = 0;
+	for ( int i = begin; i < end; ++i )
+	{
+	    dists = store_dists 
+		    ? dist_ptr + i*num_found : block_dists.getRawPtr();
+	    nanoflann::KNNResultSet<double,unsigned> result_set( num_found );
+	    result_set.init( id_ptr + i*num_found, dists );
+	    nearestSearchNode( 0, point_ptr + i*d_space_dim, result_set );
+	    if ( store_dists )
+	    {
+		for ( std::size_t n = 0; n < num_found; ++n )
+		{
+		    dists[n] = std::sqrt( dists[n] );
+		}
+	    }
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Build the subtree over a range of boxes.
+ *
+ * \param boxes The boxes in their original order.
+ *
+ * \param centers The box centers in their original order.
+ *
+ * \param begin The first box of the subtree in tree order.
+ *
+ * \param end One past the last box of the subtree in tree order.
+ *
+ * \return The index of the subtree root node.
+ */
+int BoundingBoxTree::buildNode( 
+    const Teuchos::ArrayView<const double>& boxes,
+    const Teuchos::ArrayView<const double>& centers,
+    const unsigned begin,
+    const unsigned end )
+{
+    int node = d_nodes.size();
+    d_nodes.push_back( Node() );
+    d_nodes[node].begin = begin;
+    d_nodes[node].end = end;
+    d_nodes[node].child1 = -1;
+    d_nodes[node].child2 = -1;
+
+    // Bound the boxes and their centers.
+    double max = std::numeric_limits<double>::max();
+    double center_low[3] = { max, max, max };
+    double center_high[3] = { -max, -max, -max };
+    for ( int d = 0; d < 3; ++d )
+    {
+	d_nodes[node].box[d] = max;
+	d_nodes[node].box[d+3] = -max;
+    }
+    for ( unsigned i = begin; i < end; ++i )
+    {
+	for ( int d = 0; d < d_space_dim; ++d )
+	{
+	    d_nodes[node].box[d] = 
+		std::min( d_nodes[node].box[d], boxes[6*d_ids[i]+d] );
+	    d_nodes[node].box[d+3] = 
+		std::max( d_nodes[node].box[d+3], boxes[6*d_ids[i]+d+3] );
+	    center_low[d] = std::min( center_low[d], 
+				      centers[d_ids[i]*d_space_dim+d] );
+	    center_high[d] = std::max( center_high[d],
+				       centers[d_ids[i]*d_space_dim+d] );
+	}
+    }
+    if ( end - begin <= d_max_leaf_size )
+    {
+	return node;
+    }
+
+    // Split at the median center along the longest extent of the centers.
+    int split_dim = 0;
+    for ( int d = 1; d < d_space_dim; ++d )
+    {
+	if ( center_high[d] - center_low[d] > 
+	     center_high[split_dim] - center_low[split_dim] )
+	{
+	    split_dim = d;
+	}
+    }
+    unsigned middle = begin + (end - begin) / 2;
+    std::nth_element( d_ids.begin() + begin, 
+		      d_ids.begin() + middle,
+		      d_ids.begin() + end,
+		      BoundingBoxTreeCenterCompare(
+			  centers.getRawPtr(), d_space_dim, split_dim) );
+
+    // The node array may grow while the children are built so they are
+    // assigned by index afterwards.
+    int child1 = buildNode( boxes, centers, begin, middle );
+    int child2 = buildNode( boxes, centers, middle, end );
+    d_nodes[node].child1 = child1;
+    d_nodes[node].child2 = child2;
+    return node;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Find the boxes of a subtree that contain a point.
+ */
+void BoundingBoxTree::pointSearchNode( 
+    const int node,
+    const double* point, 
+    Teuchos::Array<unsigned>& box_ids ) const
+{
+    const Node& current = d_nodes[node];
+    if ( !boxContainsPoint(current.box, point) )
+    {
+	return;
+    }
+    if ( -1 == current.child1 )
+    {
+	for ( unsigned i = current.begin; i < current.end; ++i )
+	{
+	    if ( boxContainsPoint(&d_boxes[6*i], point) )
+	    {
+		box_ids.push_back( d_ids[i] );
+	    }
+	}
+	return;
+    }
+    pointSearchNode( current.child1, point, box_ids );
+    pointSearchNode( current.child2, point, box_ids );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Find the boxes of a subtree that overlap a box.
+ */
+void BoundingBoxTree::boxSearchNode( 
+    const int node,
+    const double* box, 
+    Teuchos::Array<unsigned>& box_ids ) const
+{
+    const Node& current = d_nodes[node];
+    if ( !boxesOverlap(current.box, box) )
+    {
+	return;
+    }
+    if ( -1 == current.child1 )
+    {
+	for ( unsigned i = current.begin; i < current.end; ++i )
+	{
+	    if ( boxesOverlap(&d_boxes[6*i], box) )
+	    {
+		box_ids.push_back( d_ids[i] );
+	    }
+	}
+	return;
+    }
+    boxSearchNode( current.child1, box, box_ids );
+    boxSearchNode( current.child2, box, box_ids );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Find the boxes of a subtree nearest to a point. The nearer child
+ * is searched first and a child is skipped if it is farther than the
+ * current worst neighbor.
+ */
+void BoundingBoxTree::nearestSearchNode( 
+    const int node,
+    const double* point,
+    nanoflann::KNNResultSet<double,unsigned>& result_set ) const
+{
+    const Node& current = d_nodes[node];
+    if ( -1 == current.child1 )
+    {
+	double dist = 0.0;
+	for ( unsigned i = current.begin; i < current.end; ++i )
+	{
+	    dist = boxDistance( &d_boxes[6*i], point );
+	    if ( dist < result_set.worstDist() )
+	    {
+		result_set.addPoint( dist, d_ids[i] );
+	    }
+	}
+	return;
+    }
+
+    int near_child = current.child1;
+    int far_child = current.child2;
+    double near_dist = boxDistance( d_nodes[near_child].box, point );
+    double far_dist = boxDistance( d_nodes[far_child].box, point );
+    if ( far_dist < near_dist )
+    {
+	std::swap( near_child, far_child );
+	std::swap( near_dist, far_dist );
+    }
+    if ( near_dist < result_set.worstDist() )
+    {
+	nearestSearchNode( near_child, point, result_set );
+    }
+    if ( far_dist < result_set.worstDist() )
+    {
+	nearestSearchNode( far_child, point, result_set );
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Run point or box queries for a batch.
+ *
+ * The queries are split into blocks searched in parallel by BatchSearch.
+ */
+void BoundingBoxTree::searchBatch( 
+    const QueryType query_type,
+    const Teuchos::ArrayView<const double>& queries,
+    Teuchos::Array<std::size_t>& offsets,
+    Teuchos::Array<unsigned>& box_ids ) const
+{
+    int query_size = ( POINT_QUERY == query_type ) ? d_space_dim : 6;
+    BoundingBoxTreeBatchQuery query( 
+	*this, POINT_QUERY == query_type, queries.getRawPtr(), query_size );
+    BoundingBoxTreeIdStore store( box_ids );
+    BatchSearch::search<unsigned>( queries.size() / query_size,
+				   d_batch_block_size, query, store, offsets );
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+// end DTK_BoundingBoxTree.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,287 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_BoundingBoxTree.hpp
+ * \author Stuart R. Slattery
+ * \brief  Axis-aligned bounding box tree.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef DTK_BOUNDINGBOXTREE_HPP
+#define DTK_BOUNDINGBOXTREE_HPP
+
+#include <utility>
+
+#include <Teuchos_ArrayView.hpp>
+#include <Teuchos_Array.hpp>
+#include <Teuchos_Ptr.hpp>
+
+#include <DTK_nanoflann.hpp>
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \class BoundingBoxTree
+ *
+ * \brief Spatial searching for sets of axis-aligned bounding boxes.
+ *
+ * Boxes are given with 6 values each in the DTK bounding box layout (xmin,
+ * ymin, zmin, xmax, ymax, zmax). Only the first space_dim coordinate pairs
+ * are used so the unused components of 1D and 2D boxes are ignored. Boxes
+ * are closed: a point on the boundary of a box is in the box and boxes that
+ * touch overlap.
+ *
+ * The tree is built by splitting the boxes at the median of their centers
+ * along the longest extent of the centers until at most max_leaf_size
+ * boxes are left in a node. Each node stores the box bounding its boxes.
+ * Point and box queries return the matching box ids in increasing order so
+ * their results are the same as a linear scan over the boxes. Batched
+ * queries are split over the OpenMP threads.
+ */
+//---------------------------------------------------------------------------//
+class BoundingBoxTree
+{
+  public:
+
+    // Constructor.
+    BoundingBoxTree( const int space_dim,
+		     const Teuchos::ArrayView<const double>& boxes,
+		     const unsigned max_leaf_size = 4 );
+
+    //! Destructor.
+    ~BoundingBoxTree()
+    { /* ... */ }
+
+    //! Get the number of boxes in the tree.
+    int numBoxes() const
+    { return d_ids.size(); }
+
+    // Find the boxes that contain a point.
+    void pointSearch( const double* point, 
+		      Teuchos::Array<unsigned>& box_ids ) const;
+
+    // Find the boxes that overlap a box.
+    void boxSearch( const double* box, 
+		    Teuchos::Array<unsigned>& box_ids ) const;
+
+    // Find the boxes nearest to a point.
+    void nearestSearch( 
+	const double* point,
+	const unsigned num_neighbors,
+	Teuchos::Array<std::pair<unsigned,double> >& neighbors ) const;
+
+    // Find the boxes that contain each point of a batch.
+    void pointSearchBatch( const Teuchos::ArrayView<const double>& points,
+			   Teuchos::Array<std::size_t>& offsets,
+			   Teuchos::Array<unsigned>& box_ids ) const;
+
+    // Find the boxes that overlap each box of a batch.
+    void boxSearchBatch( const Teuchos::ArrayView<const double>& boxes,
+			 Teuchos::Array<std::size_t>& offsets,
+			 Teuchos::Array<unsigned>& box_ids ) const;
+
+    // Find the boxes nearest to each point of a batch.
+    void nearestSearchBatch( 
+	const Teuchos::ArrayView<const double>& points,
+	const unsigned num_neighbors,
+	Teuchos::Array<std::size_t>& offsets,
+	Teuchos::Array<unsigned>& box_ids,
+	const Teuchos::Ptr<Teuchos::Array<double> >& box_dists =
+	Teuchos::null ) const;
+
+  private:
+
+    // Tree node.
+    struct Node
+    {
+	// Bounding box of the node boxes.
+	double box[6];
+
+	// Index of the first child. -1 for leaves.
+	int child1;
+
+	// Index of the second child. -1 for leaves.
+	int child2;
+
+	// First box of the node in tree order.
+	unsigned begin;
+
+	// One past the last box of the node in tree order.
+	unsigned end;
+    };
+
+    // Query types of the batch driver.
+    enum QueryType
+    {
+	POINT_QUERY,
+	BOX_QUERY
+    };
+
+  private:
+
+    // Build the subtree over a range of boxes.
+    int buildNode( const Teuchos::ArrayView<const double>& boxes,
+		   const Teuchos::ArrayView<const double>& centers,
+		   const unsigned begin,
+		   const unsigned end );
+
+    // Find the boxes of a subtree that contain a point.
+    void pointSearchNode( const int node,
+			  const double* point, 
+			  Teuchos::Array<unsigned>& box_ids ) const;
+
+    // Find the boxes of a subtree that overlap a box.
+    void boxSearchNode( const int node,
+			const double* box, 
+			Teuchos::Array<unsigned>& box_ids ) const;
+
+    // Find the boxes of a subtree nearest to a point.
+    void nearestSearchNode( 
+	const int node,
+	const double* point,
+	nanoflann::KNNResultSet<double,unsigned>& result_set ) const;
+
+    // Run point or box queries for a batch.
+    void searchBatch( const QueryType query_type,
+		      const Teuchos::ArrayView<const double>& queries,
+		      Teuchos::Array<std::size_t>& offsets,
+		      Teuchos::Array<unsigned>& box_ids ) const;
+
+    // Check if a box contains a point.
+    inline bool boxContainsPoint( const double* box, 
+				  const double* point ) const;
+
+    // Check if two boxes overlap.
+    inline bool boxesOverlap( const double* box_a, 
+			      const double* box_b ) const;
+
+    // Get the squared distance from a point to a box.
+    inline double boxDistance( const double* box, 
+			       const double* point ) const;
+
+  private:
+
+    // Spatial dimension.
+    int d_space_dim;
+
+    // Maximum number of boxes in a leaf.
+    unsigned d_max_leaf_size;
+
+    // Boxes in tree order, 6 values per box.
+    Teuchos::Array<double> d_boxes;
+
+    // Original id of each box in tree order.
+    Teuchos::Array<unsigned> d_ids;
+
+    // Tree nodes with the root first.
+    Teuchos::Array<Node> d_nodes;
+
+    // Number of batch queries searched together by a thread.
+    static const int d_batch_block_size = 256;
+};
+
+//---------------------------------------------------------------------------//
+// Inline functions.
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Check if a box contains a point.
+ */
+bool BoundingBoxTree::boxContainsPoint( const double* box, 
+					const double* point ) const
+{
+    for ( int d = 0; d < d_space_dim; ++d )
+    {
+	if ( point[d] < box[d] || point[d] > box[d+3] )
+	{
+	    return false;
+	}
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Check if two boxes overlap.
+ */
+bool BoundingBoxTree::boxesOverlap( const double* box_a, 
+				    const double* box_b ) const
+{
+    for ( int d = 0; d < d_space_dim; ++d )
+    {
+	if ( box_a[d] > box_b[d+3] || box_a[d+3] < box_b[d] )
+	{
+	    return false;
+	}
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get the squared distance from a point to a box. The distance is
+ * zero if the box contains the point.
+ */
+double BoundingBoxTree::boxDistance( const double* box, 
+				     const double* point ) const
+{
+    double dist = 0.0;
+    double diff = 0.0;
+    for ( int d = 0; d < d_space_dim; ++d )
+    {
+	diff = 0.0;
+	if ( point[d] < box[d] )
+	{
+	    diff = box[d] - point[d];
+	}
+	else if ( point[d] > box[d+3] )
+	{
+	    diff = point[d] - box[d+3];
+	}
+	dist += diff*diff;
+    }
+    return dist;
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+
+#endif // end DTK_BOUNDINGBOXTREE_HPP
+
+//---------------------------------------------------------------------------//
+// end DTK_BoundingBoxTree.hpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,275 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_DynamicSearchTree.hpp
+ * \author Stuart R. Slattery
+ * \brief  Updatable search tree for moving point clouds.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef DTK_DYNAMICSEARCHTREE_HPP
+#define DTK_DYNAMICSEARCHTREE_HPP
+
+#include <utility>
+
+#include "DTK_StaticSearchTree.hpp"
+
+#include <Teuchos_ArrayView.hpp>
+#include <Teuchos_Array.hpp>
+#include <Teuchos_Ptr.hpp>
+#include <Teuchos_as.hpp>
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \class DynamicSearchTree
+ * \brief Spatial searching for point clouds that change.
+ *
+ * The tree is a k-d tree whose nodes store the bounding box of their points
+ * and searches prune with the boxes rather than the split planes. Points
+ * may then be inserted, removed and moved without rebuilding the tree:
+ *
+ * - An inserted point descends to the leaf whose box grows least and a leaf
+ *   that grows past twice the maximum leaf size is split.
+ * - A removed point is dropped from its leaf. Its id is not reused.
+ * - After points move the boxes of their leaves and of the ancestors of
+ *   those leaves are refit. The cost is proportional to the number of moved
+ *   points times the tree depth.
+ *
+ * Refit and insertion degrade the tree as the leaf boxes grow and overlap.
+ * The tree tracks the total size of its leaf boxes and the number of points
+ * inserted or removed since it was built, and rebuilds itself once the leaf
+ * boxes grow by more than the rebuild factor or as many points have been
+ * inserted or removed as it was built with.
+ *
+ * Point ids are the order of the points given to the constructor followed
+ * by the order of insertion. The tree owns a copy of the coordinates.
+ */
+//---------------------------------------------------------------------------//
+template<int DIM>
+class DynamicSearchTree : public StaticSearchTree
+{
+  public:
+
+    // Constructor.
+    DynamicSearchTree( const Teuchos::ArrayView<const double>& points,
+		       const unsigned max_leaf_size,
+		       const double rebuild_factor = 2.0 );
+
+    //! Destructor.
+    ~DynamicSearchTree()
+    { /* ... */ }
+
+    // Perform an n-nearest neighbor search.
+    Teuchos::Array<unsigned> nnSearch( 
+	const Teuchos::ArrayView<const double>& point,
+	const unsigned num_neighbors ) const;
+
+    // Perform a nearest neighbor search within a specified radius.
+    Teuchos::Array<unsigned> radiusSearch( 
+	const Teuchos::ArrayView<const double>& point, 
+	const double radius ) const;
+
+    // Perform an n-nearest neighbor search for a batch of points.
+    void nnSearchBatch(
+	const Teuchos::ArrayView<const double>& points,
+	const unsigned num_neighbors,
+	Teuchos::Array<std::size_t>& offsets,
+	Teuchos::Array<unsigned>& neighbors,
+	const Teuchos::Ptr<Teuchos::Array<double> >& neighbor_dists =
+	Teuchos::null ) const;
+
+    // Perform a nearest neighbor search within a specified radius for a
+    // batch of points.
+    void radiusSearchBatch(
+	const Teuchos::ArrayView<const double>& points,
+	const double radius,
+	Teuchos::Array<std::size_t>& offsets,
+	Teuchos::Array<unsigned>& neighbors,
+	const Teuchos::Ptr<Teuchos::Array<double> >& neighbor_dists =
+	Teuchos::null ) const;
+
+    // Perform an n-nearest neighbor search into caller-owned buffers.
+    void nnSearch( const double* point,
+		   const unsigned num_neighbors,
+		   unsigned* neighbors,
+		   double* neighbor_dists ) const;
+
+    // Perform a nearest neighbor search within a specified radius into a
+    // caller-owned buffer.
+    void radiusSearch( 
+	const double* point,
+	const double radius,
+	Teuchos::Array<std::pair<unsigned,double> >& neighbors ) const;
+
+    // Insert a point and get its id.
+    unsigned insert( const Teuchos::ArrayView<const double>& point );
+
+    // Remove a point.
+    void remove( const unsigned id );
+
+    // Move a set of points and refit the tree to their new coordinates.
+    void updatePoints( const Teuchos::ArrayView<const unsigned>& ids,
+		       const Teuchos::ArrayView<const double>& points );
+
+    // Rebuild the tree from the current points.
+    void rebuild();
+
+    //! Get the number of points in the tree.
+    std::size_t numPoints() const
+    { return d_num_points; }
+
+    //! Determine if a point id is in the tree.
+    bool isActive( const unsigned id ) const
+    { return Teuchos::as<int>(id) < d_point_leaf.size() && 
+	    -1 != d_point_leaf[id]; }
+
+    //! Get the number of times the tree has been rebuilt.
+    int numRebuilds() const
+    { return d_num_rebuilds; }
+
+  private:
+
+    // Tree node.
+    struct Node
+    {
+	// Bounding box. Lower bounds followed by upper bounds.
+	double box[2*DIM];
+
+	// Child nodes. -1 for a leaf.
+	int children[2];
+
+	// Parent node. -1 for the root.
+	int parent;
+
+	// Point ids of a leaf.
+	Teuchos::Array<unsigned> ids;
+    };
+
+  private:
+
+    // Build a subtree over a range of point ids and get its root.
+    int buildNode( Teuchos::Array<unsigned>& ids,
+		   const int begin, const int end, const int parent );
+
+    // Split a leaf in two at the median of its longest box dimension.
+    void splitLeaf( const int leaf );
+
+    // Create a leaf over a range of point ids and get its index.
+    int createLeaf( const Teuchos::Array<unsigned>& ids,
+		    const int begin, const int end, const int parent );
+
+    // Get the longest box dimension of a node.
+    int splitDimension( const int node ) const;
+
+    // Set the box of a leaf to the box of its points.
+    void fitLeaf( const int leaf );
+
+    // Set the box of an internal node to the union of its children.
+    void fitInternal( const int node );
+
+    // Rebuild the tree if its quality has degraded.
+    void checkQuality();
+
+    // Get the squared distance from a point to the box of a node.
+    double boxDistance( const int node, const double* point ) const;
+
+    // Get the size of the box of a node.
+    double boxMeasure( const int node ) const;
+
+    // Get the squared distance between a point and a tree point.
+    double pointDistance( const double* point, const unsigned id ) const;
+
+    // Search a subtree for the nearest neighbors of a point.
+    void nearestSearch( const int node,
+			const double* point,
+			const unsigned num_neighbors,
+			unsigned* neighbors,
+			double* neighbor_dists,
+			unsigned& num_found ) const;
+
+  private:
+
+    // Maximum leaf size.
+    unsigned d_max_leaf_size;
+
+    // Factor by which the leaf boxes may grow before a rebuild.
+    double d_rebuild_factor;
+
+    // Point coordinates of all ids.
+    Teuchos::Array<double> d_points;
+
+    // Leaf of each point id. -1 if the point was removed.
+    Teuchos::Array<int> d_point_leaf;
+
+    // Number of points in the tree.
+    std::size_t d_num_points;
+
+    // Tree nodes. Children always follow their parent.
+    Teuchos::Array<Node> d_nodes;
+
+    // Total size of the leaf boxes.
+    double d_leaf_measure;
+
+    // Total size of the leaf boxes when the tree was built.
+    double d_build_measure;
+
+    // Number of points when the tree was built.
+    std::size_t d_build_size;
+
+    // Number of points inserted or removed since the tree was built.
+    std::size_t d_num_modified;
+
+    // Number of rebuilds.
+    int d_num_rebuilds;
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+// Template includes.
+//---------------------------------------------------------------------------//
+
+#include "DTK_DynamicSearchTree_impl.hpp"
+
+//---------------------------------------------------------------------------//
+
+#endif // end DTK_DYNAMICSEARCHTREE_HPP
+
+//---------------------------------------------------------------------------//
+// end DTK_DynamicSearchTree.hpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,769 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_DynamicSearchTree_impl.hpp
+ * \author Stuart R. Slattery
+ * \brief  Updatable search tree for moving point clouds.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef DTK_DYNAMICSEARCHTREE_IMPL_HPP
+#define DTK_DYNAMICSEARCHTREE_IMPL_HPP
+
+#include <limits>
+#include <algorithm>
+
+#include "DTK_DBC.hpp"
+
+#include <Teuchos_as.hpp>
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Compare point ids by one of their coordinates.
+ */
+class DynamicSearchTreeCoordinateCompare
+{
+  public:
+
+    DynamicSearchTreeCoordinateCompare( const double* points,
+					const int dim,
+					const int d )
+	: d_points( points )
+	, d_dim( dim )
+	, d_d( d )
+    { /* ... */ }
+
+    bool operator()( const unsigned a, const unsigned b ) const
+    { return d_points[d_dim*a+d_d] < d_points[d_dim*b+d_d]; }
+
+  private:
+    const double* d_points;
+    int d_dim;
+    int d_d;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Compare neighbors by their distance.
+ */
+class DynamicSearchTreeDistanceCompare
+{
+  public:
+
+    bool operator()( const std::pair<unsigned,double>& a, 
+		     const std::pair<unsigned,double>& b ) const
+    { return a.second < b.second; }
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Constructor.
+ *
+ * \param points The point cloud coordinates to build the tree with.
+ *
+ * \param max_leaf_size The maximum number of points in a leaf when the tree
+ * is built.
+ *
+ * \param rebuild_factor The tree is rebuilt when the total size of its leaf
+ * boxes grows by more than this factor. Must be greater than one.
+ */
+template<int DIM>
+DynamicSearchTree<DIM>::DynamicSearchTree( 
+    const Teuchos::ArrayView<const double>& points,
+    const unsigned max_leaf_size,
+    const double rebuild_factor )
+    : d_max_leaf_size( std::max(max_leaf_size,1u) )
+    , d_rebuild_factor( rebuild_factor )
+    , d_points( points.begin(), points.end() )
+    , d_point_leaf( points.size() / DIM, 0 )
+    , d_num_points( points.size() / DIM )
+    , d_leaf_measure( 0.0 )
+    , d_build_measure( 0.0 )
+    , d_build_size( 0 )
+    , d_num_modified( 0 )
+    , d_num_rebuilds( 0 )
+{
+    DTK_REQUIRE( 0 == points.size() % DIM );
+    DTK_REQUIRE( 1.0 < rebuild_factor );
+
+    rebuild();
+    d_num_rebuilds = 0;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Perform an n-nearest neighbor search.
+ */
+template<int DIM>
+Teuchos::Array<unsigned> DynamicSearchTree<DIM>::nnSearch( 
+    const Teuchos::ArrayView<const double>& point, 
+    const unsigned num_neighbors ) const
+{
+    DTK_REQUIRE( DIM == point.size() );
+    unsigned num_found = std::min( Teuchos::as<std::size_t>(num_neighbors),
+				   d_num_points );
+    Teuchos::Array<unsigned> neighbors( num_found );
+    Teuchos::Array<double> neighbor_dists( num_found );
+    nnSearch( point.getRawPtr(), num_found,
+	      neighbors.getRawPtr(), neighbor_dists.getRawPtr() );
+    return neighbors;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Perform a nearest neighbor search within a specified radius.
+ */ 
+template<int DIM>
+Teuchos::Array<unsigned> DynamicSearchTree<DIM>::radiusSearch( 
+    const Teuchos::ArrayView<const double>& point, 
+    const double radius ) const
+{
+    DTK_REQUIRE( DIM == point.size() );
+    Teuchos::Array<std::pair<unsigned,double> > neighbor_pairs;
+    radiusSearch( point.getRawPtr(), radius, neighbor_pairs );
+    Teuchos::Array<unsigned> neighbors( neighbor_pairs.size() );
+    for ( int n = 0; n < neighbor_pairs.size(); ++n )
+    {
+	neighbors[n] = neighbor_pairs[n].first;
+    }
+    return neighbors;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Perform an n-nearest neighbor search for a batch of points.
+ *
+ * If the tree has fewer points than the number of neighbors then all of
+ * them are found.
+ */
+template<int DIM>
+void DynamicSearchTree<DIM>::nnSearchBatch(
+    const Teuchos::ArrayView<const double>& points,
+    const unsigned num_neighbors,
+    Teuchos::Array<std::size_t>& offsets,
+    Teuchos::Array<unsigned>& neighbors,
+    const Teuchos::Ptr<Teuchos::Array<double> >& neighbor_dists ) const
+{
+    std::size_t num_found = std::min( 
+	Teuchos::as<std::size_t>(num_neighbors), d_num_points );
+    nnSearchBatchImpl<DIM>( 
+	*this, points, num_found, offsets, neighbors, neighbor_dists );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Perform a nearest neighbor search within a specified radius for a
+ * batch of points.
+ */
+template<int DIM>
+void DynamicSearchTree<DIM>::radiusSearchBatch(
+    const Teuchos::ArrayView<const double>& points,
+    const double radius,
+    Teuchos::Array<std::size_t>& offsets,
+    Teuchos::Array<unsigned>& neighbors,
+    const Teuchos::Ptr<Teuchos::Array<double> >& neighbor_dists ) const
+{
+    radiusSearchBatchImpl<DIM>( 
+	*this, points, radius, offsets, neighbors, neighbor_dists );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Perform an n-nearest neighbor search into caller-owned buffers.
+ *
+ * The neighbors are sorted by distance and the squared distances are
+ * returned. No more neighbors than there are points in the tree should be
+ * requested.
+ */
+template<int DIM>
+void DynamicSearchTree<DIM>::nnSearch( const double* point,
+				       const unsigned num_neighbors,
+				       unsigned* neighbors,
+				       double* neighbor_dists ) const
+{
+    DTK_REQUIRE( num_neighbors <= d_num_points );
+    unsigned num_found = 0;
+    if ( 0 < num_neighbors )
+    {
+	nearestSearch( 0, point, num_neighbors, 
+		       neighbors, neighbor_dists, num_found );
+    }
+    DTK_ENSURE( num_neighbors == num_found );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Perform a nearest neighbor search within a specified radius into a
+ * caller-owned buffer.
+ *
+ * The neighbor ids and their squared distances are sorted by distance. The
+ * buffer is cleared first.
+ */ 
+template<int DIM>
+void DynamicSearchTree<DIM>::radiusSearch( 
+    const double* point,
+    const double radius,
+    Teuchos::Array<std::pair<unsigned,double> >& neighbors ) const
+{
+    neighbors.clear();
+    if ( d_nodes.empty() )
+    {
+	return;
+    }
+
+    // Pad the radius as the static tree does.
+    double l2_radius = radius*radius + 
+		       100.0*std::numeric_limits<double>::epsilon();
+
+    // Visit the nodes whose boxes intersect the search sphere.
+    Teuchos::Array<int> stack( 1, 0 );
+    int node = 0;
+    double dist = 0.0;
+    while ( !stack.empty() )
+    {
+	node = stack.back();
+	stack.pop_back();
+	if ( boxDistance(node,point) > l2_radius )
+	{
+	    continue;
+	}
+	if ( -1 == d_nodes[node].children[0] )
+	{
+	    const Teuchos::Array<unsigned>& ids = d_nodes[node].ids;
+	    for ( int n = 0; n < ids.size(); ++n )
+	    {
+		dist = pointDistance( point, ids[n] );
+		if ( dist <= l2_radius )
+		{
+		    neighbors.push_back( std::make_pair(ids[n],dist) );
+		}
+	    }
+	}
+	else
+	{
+	    stack.push_back( d_nodes[node].children[0] );
+	    stack.push_back( d_nodes[node].children[1] );
+	}
+    }
+
+    // Sort the neighbors by distance.
+    std::sort( neighbors.begin(), neighbors.end(), 
+	       DynamicSearchTreeDistanceCompare() );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Insert a point and get its id.
+ */
+template<int DIM>
+unsigned DynamicSearchTree<DIM>::insert( 
+    const Teuchos::ArrayView<const double>& point )
+{
+    DTK_REQUIRE( DIM == point.size() );
+
+    unsigned id = d_point_leaf.size();
+    d_points.insert( d_points.end(), point.begin(), point.end() );
+    d_point_leaf.push_back( 0 );
+    ++d_num_points;
+    ++d_num_modified;
+
+    // An empty tree gets a new root leaf.
+    if ( d_nodes.empty() )
+    {
+	rebuild();
+	return id;
+    }
+
+    // Descend to the leaf whose box grows least, growing the boxes on the
+    // way.
+    int node = 0;
+    double growth[2];
+    Node* current = 0;
+    while ( -1 != d_nodes[node].children[0] )
+    {
+	current = &d_nodes[node];
+	for ( int d = 0; d < DIM; ++d )
+	{
+	    current->box[d] = std::min( current->box[d], point[d] );
+	    current->box[DIM+d] = std::max( current->box[DIM+d], point[d] );
+	}
+	for ( int c = 0; c < 2; ++c )
+	{
+	    const double* box = d_nodes[current->children[c]].box;
+	    growth[c] = 0.0;
+	    for ( int d = 0; d < DIM; ++d )
+	    {
+		growth[c] += std::max( box[d] - point[d], 0.0 ) +
+			     std::max( point[d] - box[DIM+d], 0.0 );
+	    }
+	}
+	node = current->children[ (growth[1] < growth[0]) ? 1 : 0 ];
+    }
+
+    // Add the point to the leaf.
+    d_leaf_measure -= boxMeasure( node );
+    for ( int d = 0; d < DIM; ++d )
+    {
+	d_nodes[node].box[d] = std::min( d_nodes[node].box[d], point[d] );
+	d_nodes[node].box[DIM+d] = 
+	    std::max( d_nodes[node].box[DIM+d], point[d] );
+    }
+    d_leaf_measure += boxMeasure( node );
+    d_nodes[node].ids.push_back( id );
+    d_point_leaf[id] = node;
+
+    // Split the leaf if it is too large.
+    if ( Teuchos::as<unsigned>(d_nodes[node].ids.size()) > 
+	 2*d_max_leaf_size )
+    {
+	splitLeaf( node );
+    }
+
+    checkQuality();
+    return id;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Remove a point.
+ *
+ * The box of its leaf is not shrunk. It still bounds the remaining points
+ * and is fit again when the points of the leaf move.
+ */
+template<int DIM>
+void DynamicSearchTree<DIM>::remove( const unsigned id )
+{
+    DTK_REQUIRE( isActive(id) );
+
+    Teuchos::Array<unsigned>& ids = d_nodes[ d_point_leaf[id] ].ids;
+    typename Teuchos::Array<unsigned>::iterator id_it =
+	std::find( ids.begin(), ids.end(), id );
+    DTK_CHECK( id_it != ids.end() );
+    *id_it = ids.back();
+    ids.pop_back();
+    d_point_leaf[id] = -1;
+    --d_num_points;
+    ++d_num_modified;
+
+    checkQuality();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Move a set of points and refit the tree to their new coordinates.
+ *
+ * \param ids The ids of the points that moved.
+ *
+ * \param points The new coordinates of the points that moved, DIM values
+ * per point.
+ *
+ * Only the leaves of the moved points and their ancestors are refit.
+ */
+template<int DIM>
+void DynamicSearchTree<DIM>::updatePoints( 
+    const Teuchos::ArrayView<const unsigned>& ids,
+    const Teuchos::ArrayView<const double>& points )
+{
+    DTK_REQUIRE( DIM*ids.size() == points.size() );
+
+    // Move the points and collect their leaves.
+    Teuchos::Array<int> dirty;
+    for ( int i = 0; i < ids.size(); ++i )
+    {
+	DTK_REQUIRE( isActive(ids[i]) );
+	std::copy( points.begin() + DIM*i, points.begin() + DIM*(i+1),
+		   d_points.begin() + DIM*ids[i] );
+	dirty.push_back( d_point_leaf[ids[i]] );
+    }
+
+    // Add the ancestors of the leaves.
+    std::sort( dirty.begin(), dirty.end() );
+    dirty.erase( std::unique(dirty.begin(), dirty.end()), dirty.end() );
+    int num_leaves = dirty.size();
+    for ( int i = 0; i < num_leaves; ++i )
+    {
+	for ( int node = d_nodes[dirty[i]].parent; 
+	      -1 != node; 
+	      node = d_nodes[node].parent )
+	{
+	    dirty.push_back( node );
+	}
+    }
+    std::sort( dirty.begin(), dirty.end() );
+    dirty.erase( std::unique(dirty.begin(), dirty.end()), dirty.end() );
+
+    // Children follow their parents so fitting in reverse order fits every
+    // node after its children.
+    for ( int i = dirty.size() - 1; i >= 0; --i )
+    {
+	if ( -1 == d_nodes[dirty[i]].children[0] )
+	{
+	    fitLeaf( dirty[i] );
+	}
+	else
+	{
+	    fitInternal( dirty[i] );
+	}
+    }
+
+    checkQuality();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Rebuild the tree from the current points.
+ */
+template<int DIM>
+void DynamicSearchTree<DIM>::rebuild()
+{
+    Teuchos::Array<unsigned> ids;
+    ids.reserve( d_num_points );
+    for ( int i = 0; i < d_point_leaf.size(); ++i )
+    {
+	if ( -1 != d_point_leaf[i] )
+	{
+	    ids.push_back( i );
+	}
+    }
+
+    d_nodes.clear();
+    d_leaf_measure = 0.0;
+    if ( !ids.empty() )
+    {
+	buildNode( ids, 0, ids.size(), -1 );
+    }
+
+    d_build_measure = d_leaf_measure;
+    d_build_size = d_num_points;
+    d_num_modified = 0;
+    ++d_num_rebuilds;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Build a subtree over a range of point ids and get its root.
+ */
+template<int DIM>
+int DynamicSearchTree<DIM>::buildNode( Teuchos::Array<unsigned>& ids,
+				       const int begin, 
+				       const int end, 
+				       const int parent )
+{
+    int node = createLeaf( ids, begin, end, parent );
+
+    // Split the node at the median of its longest box dimension.
+    if ( Teuchos::as<unsigned>(end - begin) > d_max_leaf_size )
+    {
+	d_leaf_measure -= boxMeasure( node );
+	d_nodes[node].ids.clear();
+	int mid = begin + (end - begin) / 2;
+	std::nth_element( 
+	    ids.begin() + begin, ids.begin() + mid, ids.begin() + end,
+	    DynamicSearchTreeCoordinateCompare(
+		d_points.getRawPtr(), DIM, splitDimension(node)) );
+	int left = buildNode( ids, begin, mid, node );
+	int right = buildNode( ids, mid, end, node );
+	d_nodes[node].children[0] = left;
+	d_nodes[node].children[1] = right;
+    }
+
+    return node;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Split a leaf in two at the median of its longest box dimension.
+ */
+template<int DIM>
+void DynamicSearchTree<DIM>::splitLeaf( const int leaf )
+{
+    DTK_REQUIRE( -1 == d_nodes[leaf].children[0] );
+
+    // The leaf becomes an internal node. Its box still bounds its points.
+    Teuchos::Array<unsigned> ids;
+    ids.swap( d_nodes[leaf].ids );
+    d_leaf_measure -= boxMeasure( leaf );
+
+    int mid = ids.size() / 2;
+    std::nth_element( 
+	ids.begin(), ids.begin() + mid, ids.end(),
+	DynamicSearchTreeCoordinateCompare(
+	    d_points.getRawPtr(), DIM, splitDimension(leaf)) );
+    int left = createLeaf( ids, 0, mid, leaf );
+    int right = createLeaf( ids, mid, ids.size(), leaf );
+    d_nodes[leaf].children[0] = left;
+    d_nodes[leaf].children[1] = right;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Create a leaf over a range of point ids and get its index.
+ */
+template<int DIM>
+int DynamicSearchTree<DIM>::createLeaf( const Teuchos::Array<unsigned>& ids,
+					const int begin, 
+					const int end, 
+					const int parent )
+{
+    int leaf = d_nodes.size();
+    d_nodes.push_back( Node() );
+    d_nodes[leaf].children[0] = -1;
+    d_nodes[leaf].children[1] = -1;
+    d_nodes[leaf].parent = parent;
+    for ( int d = 0; d < DIM; ++d )
+    {
+	d_nodes[leaf].box[d] = std::numeric_limits<double>::max();
+	d_nodes[leaf].box[DIM+d] = -std::numeric_limits<double>::max();
+    }
+    d_nodes[leaf].ids.assign( ids.begin() + begin, ids.begin() + end );
+    for ( int i = begin; i < end; ++i )
+    {
+	d_point_leaf[ ids[i] ] = leaf;
+    }
+    fitLeaf( leaf );
+    return leaf;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get the longest box dimension of a node.
+ */
+template<int DIM>
+int DynamicSearchTree<DIM>::splitDimension( const int node ) const
+{
+    const double* box = d_nodes[node].box;
+    int split = 0;
+    for ( int d = 1; d < DIM; ++d )
+    {
+	if ( box[DIM+d] - box[d] > box[DIM+split] - box[split] )
+	{
+	    split = d;
+	}
+    }
+    return split;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Set the box of a leaf to the box of its points.
+ */
+template<int DIM>
+void DynamicSearchTree<DIM>::fitLeaf( const int leaf )
+{
+    Node& node = d_nodes[leaf];
+    d_leaf_measure -= boxMeasure( leaf );
+    for ( int d = 0; d < DIM; ++d )
+    {
+	node.box[d] = std::numeric_limits<double>::max();
+	node.box[DIM+d] = -std::numeric_limits<double>::max();
+    }
+    const double* p = 0;
+    for ( int n = 0; n < node.ids.size(); ++n )
+    {
+	p = d_points.getRawPtr() + DIM*node.ids[n];
+	for ( int d = 0; d < DIM; ++d )
+	{
+	    node.box[d] = std::min( node.box[d], p[d] );
+	    node.box[DIM+d] = std::max( node.box[DIM+d], p[d] );
+	}
+    }
+    d_leaf_measure += boxMeasure( leaf );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Set the box of an internal node to the union of its children.
+ */
+template<int DIM>
+void DynamicSearchTree<DIM>::fitInternal( const int node )
+{
+    const double* left = d_nodes[ d_nodes[node].children[0] ].box;
+    const double* right = d_nodes[ d_nodes[node].children[1] ].box;
+    for ( int d = 0; d < DIM; ++d )
+    {
+	d_nodes[node].box[d] = std::min( left[d], right[d] );
+	d_nodes[node].box[DIM+d] = std::max( left[DIM+d], right[DIM+d] );
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Rebuild the tree if its quality has degraded.
+ */
+template<int DIM>
+void DynamicSearchTree<DIM>::checkQuality()
+{
+    if ( d_leaf_measure > d_rebuild_factor * d_build_measure ||
+	 d_num_modified > std::max(d_build_size, 
+				   Teuchos::as<std::size_t>(d_max_leaf_size)) )
+    {
+	rebuild();
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get the squared distance from a point to the box of a node.
+ */
+template<int DIM>
+double DynamicSearchTree<DIM>::boxDistance( const int node, 
+					    const double* point ) const
+{
+    const double* box = d_nodes[node].box;
+    double dist = 0.0;
+    double dx = 0.0;
+    for ( int d = 0; d < DIM; ++d )
+    {
+	dx = std::max( std::max(box[d] - point[d], point[d] - box[DIM+d]), 
+		       0.0 );
+	dist += dx*dx;
+    }
+    return dist;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get the size of the box of a node as the sum of its extents. An
+ * empty box has no size.
+ */
+template<int DIM>
+double DynamicSearchTree<DIM>::boxMeasure( const int node ) const
+{
+    const double* box = d_nodes[node].box;
+    double measure = 0.0;
+    for ( int d = 0; d < DIM; ++d )
+    {
+	if ( box[DIM+d] < box[d] )
+	{
+	    return 0.0;
+	}
+	measure += box[DIM+d] - box[d];
+    }
+    return measure;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get the squared distance between a point and a tree point.
+ */
+template<int DIM>
+double DynamicSearchTree<DIM>::pointDistance( const double* point, 
+					      const unsigned id ) const
+{
+    const double* p = d_points.getRawPtr() + DIM*id;
+    double dist = 0.0;
+    double dx = 0.0;
+    for ( int d = 0; d < DIM; ++d )
+    {
+	dx = point[d] - p[d];
+	dist += dx*dx;
+    }
+    return dist;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Search a subtree for the nearest neighbors of a point.
+ *
+ * The neighbors found so far are kept sorted by squared distance. Children
+ * are visited nearest first and subtrees whose boxes are further than the
+ * current furthest neighbor are pruned once enough neighbors are found.
+ */
+template<int DIM>
+void DynamicSearchTree<DIM>::nearestSearch( const int node,
+					    const double* point,
+					    const unsigned num_neighbors,
+					    unsigned* neighbors,
+					    double* neighbor_dists,
+					    unsigned& num_found ) const
+{
+    const Node& current = d_nodes[node];
+
+    // Test the points of a leaf.
+    if ( -1 == current.children[0] )
+    {
+	double dist = 0.0;
+	unsigned n = 0;
+	for ( int i = 0; i < current.ids.size(); ++i )
+	{
+	    dist = pointDistance( point, current.ids[i] );
+	    if ( num_found == num_neighbors && 
+		 dist >= neighbor_dists[num_found-1] )
+	    {
+		continue;
+	    }
+
+	    // Insert the point in sorted order.
+	    n = (num_found < num_neighbors) ? num_found++ : num_found - 1;
+	    for ( ; n > 0 && neighbor_dists[n-1] > dist; --n )
+	    {
+		neighbors[n] = neighbors[n-1];
+		neighbor_dists[n] = neighbor_dists[n-1];
+	    }
+	    neighbors[n] = current.ids[i];
+	    neighbor_dists[n] = dist;
+	}
+	return;
+    }
+
+    // Visit the nearest child first.
+    double child_dists[2] = 
+	{ boxDistance(current.children[0],point),
+	  boxDistance(current.children[1],point) };
+    int first = (child_dists[1] < child_dists[0]) ? 1 : 0;
+    for ( int c = 0; c < 2; ++c )
+    {
+	int child = (0 == c) ? first : 1 - first;
+	if ( num_found < num_neighbors || 
+	     child_dists[child] < neighbor_dists[num_found-1] )
+	{
+	    nearestSearch( current.children[child], point, num_neighbors,
+			   neighbors, neighbor_dists, num_found );
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+
+#endif // end DTK_DYNAMICSEARCHTREE_IMPL_HPP
+
+//---------------------------------------------------------------------------//
+// end DTK_DynamicSearchTree_impl.hpp
+//---------------------------------------------------------------------------//
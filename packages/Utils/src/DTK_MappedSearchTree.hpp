@@ -0,0 +1,194 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_MappedSearchTree.hpp
+ * \author Stuart R. Slattery
+ * \brief  Search tree queried in place from a tree image.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef DTK_MAPPEDSEARCHTREE_HPP
+#define DTK_MAPPEDSEARCHTREE_HPP
+
+#include <string>
+#include <utility>
+
+#include "DTK_StaticSearchTree.hpp"
+#include "DTK_SearchTreeImage.hpp"
+
+#include <Teuchos_ArrayView.hpp>
+#include <Teuchos_Array.hpp>
+#include <Teuchos_Ptr.hpp>
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \class MappedSearchTree
+ * \brief Spatial searching for point clouds over a tree image.
+ *
+ * The tree searches an image written by NanoflannTree::writeImage in place.
+ * An image file is mapped read-only into memory so opening it costs no
+ * parsing or index construction and its pages are shared by every process
+ * on a node that maps the same file. An image already in memory may be
+ * searched directly instead.
+ *
+ * Neighbors are returned as indices into the points the image was built
+ * from and are found with the same distances as the NanoflannTree that
+ * wrote the image.
+ */
+//---------------------------------------------------------------------------//
+template<int DIM>
+class MappedSearchTree : public StaticSearchTree
+{
+  public:
+
+    // File constructor.
+    explicit MappedSearchTree( const std::string& filename );
+
+    // Memory constructor.
+    explicit MappedSearchTree( const Teuchos::ArrayView<const char>& image );
+
+    // Destructor.
+    ~MappedSearchTree();
+
+    // Perform an n-nearest neighbor search.
+    Teuchos::Array<unsigned> nnSearch( 
+	const Teuchos::ArrayView<const double>& point,
+	const unsigned num_neighbors ) const;
+
+    // Perform a nearest neighbor search within a specified radius.
+    Teuchos::Array<unsigned> radiusSearch( 
+	const Teuchos::ArrayView<const double>& point, 
+	const double radius ) const;
+
+    // Perform an n-nearest neighbor search into caller-owned buffers.
+    void nnSearch( const double* point,
+		   const unsigned num_neighbors,
+		   unsigned* neighbors,
+		   double* neighbor_dists ) const;
+
+    // Perform a nearest neighbor search within a specified radius into a
+    // caller-owned buffer.
+    void radiusSearch( 
+	const double* point,
+	const double radius,
+	Teuchos::Array<std::pair<unsigned,double> >& neighbors ) const;
+
+    // Perform an n-nearest neighbor search for a batch of points.
+    void nnSearchBatch(
+	const Teuchos::ArrayView<const double>& points,
+	const unsigned num_neighbors,
+	Teuchos::Array<std::size_t>& offsets,
+	Teuchos::Array<unsigned>& neighbors,
+	const Teuchos::Ptr<Teuchos::Array<double> >& neighbor_dists =
+	Teuchos::null ) const;
+
+    // Perform a nearest neighbor search within a specified radius for a
+    // batch of points.
+    void radiusSearchBatch(
+	const Teuchos::ArrayView<const double>& points,
+	const double radius,
+	Teuchos::Array<std::size_t>& offsets,
+	Teuchos::Array<unsigned>& neighbors,
+	const Teuchos::Ptr<Teuchos::Array<double> >& neighbor_dists =
+	Teuchos::null ) const;
+
+    //! Get the number of points in the tree.
+    std::size_t numPoints() const
+    { return d_header->num_points; }
+
+  private:
+
+    // Set the image sections from the start of an image.
+    void setImage( const char* image, const std::size_t image_size );
+
+    // Check if an aligned image section lies within the image.
+    static bool sectionFits( const std::uint64_t offset, 
+			     const std::uint64_t size,
+			     const std::uint64_t image_size );
+
+    // Compute the squared distances from a point to the root bounding box.
+    double initialDistances( const double* point, double* dists ) const;
+
+    // Search the tree from a node.
+    template<class ResultSet>
+    void searchNode( ResultSet& result_set,
+		     const double* point,
+		     const int node,
+		     double mindistsq,
+		     double* dists ) const;
+
+    // Disallow copies of the mapping.
+    MappedSearchTree( const MappedSearchTree& );
+    MappedSearchTree& operator=( const MappedSearchTree& );
+
+  private:
+
+    // Start of the file mapping. Null if the image is not owned.
+    void* d_map;
+
+    // Size of the file mapping.
+    std::size_t d_map_size;
+
+    // Image header.
+    const SearchTreeImageHeader* d_header;
+
+    // Point coordinates in tree order.
+    const double* d_points;
+
+    // Original point ids in tree order.
+    const std::uint32_t* d_ids;
+
+    // Tree nodes.
+    const SearchTreeImageNode* d_nodes;
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+// Template includes.
+//---------------------------------------------------------------------------//
+
+#include "DTK_MappedSearchTree_impl.hpp"
+
+//---------------------------------------------------------------------------//
+
+#endif // end DTK_MAPPEDSEARCHTREE_HPP
+
+//---------------------------------------------------------------------------//
+// end DTK_MappedSearchTree.hpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,492 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_MappedSearchTree_impl.hpp
+ * \author Stuart R. Slattery
+ * \brief  Search tree queried in place from a tree image.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef DTK_MAPPEDSEARCHTREE_IMPL_HPP
+#define DTK_MAPPEDSEARCHTREE_IMPL_HPP
+
+#include <limits>
+#include <algorithm>
+#include <cstring>
+
+#include "DTK_DBC.hpp"
+
+#include <Teuchos_as.hpp>
+
+#include <DTK_nanoflann.hpp>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \brief File constructor.
+ *
+ * \param filename An image file written by NanoflannTree::writeImage with
+ * the same dimension as this tree. The file is mapped read-only and must
+ * not be changed while the tree exists.
+ */
+template<int DIM>
+MappedSearchTree<DIM>::MappedSearchTree( const std::string& filename )
+    : d_map( 0 )
+    , d_map_size( 0 )
+{
+    int fd = open( filename.c_str(), O_RDONLY );
+    DTK_INSIST( -1 != fd );
+
+    // Only map a file large enough to hold a header. The file is closed
+    // before any check so a bad file does not leak the descriptor. The
+    // mapping stays valid after the file is closed.
+    struct stat file_stat;
+    int stat_error = fstat( fd, &file_stat );
+    if ( 0 == stat_error )
+    {
+	d_map_size = file_stat.st_size;
+    }
+    if ( 0 == stat_error && d_map_size >= sizeof(SearchTreeImageHeader) )
+    {
+	d_map = mmap( 0, d_map_size, PROT_READ, MAP_SHARED, fd, 0 );
+    }
+    close( fd );
+    DTK_INSIST( 0 == stat_error );
+    DTK_INSIST( d_map_size >= sizeof(SearchTreeImageHeader) );
+    DTK_INSIST( MAP_FAILED != d_map );
+
+    // The destructor is not called if the image is invalid so unmap it
+    // here.
+    try
+    {
+	setImage( static_cast<const char*>(d_map), d_map_size );
+    }
+    catch ( ... )
+    {
+	munmap( d_map, d_map_size );
+	throw;
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Memory constructor.
+ *
+ * \param image An image written by NanoflannTree::writeImage with the same
+ * dimension as this tree. The image is not copied and must stay alive and
+ * unchanged for the lifetime of the tree. It must start on an 8 byte
+ * boundary.
+ */
+template<int DIM>
+MappedSearchTree<DIM>::MappedSearchTree( 
+    const Teuchos::ArrayView<const char>& image )
+    : d_map( 0 )
+    , d_map_size( 0 )
+{
+    DTK_REQUIRE( Teuchos::as<std::size_t>(image.size()) >= 
+		 sizeof(SearchTreeImageHeader) );
+    DTK_REQUIRE( 0 == reinterpret_cast<std::size_t>(image.getRawPtr()) % 
+		 SearchTreeImageHeader::alignment );
+    setImage( image.getRawPtr(), image.size() );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Destructor.
+ */
+template<int DIM>
+MappedSearchTree<DIM>::~MappedSearchTree()
+{
+    if ( 0 != d_map )
+    {
+	munmap( d_map, d_map_size );
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Perform an n-nearest neighbor search.
+ */
+template<int DIM>
+Teuchos::Array<unsigned> MappedSearchTree<DIM>::nnSearch( 
+    const Teuchos::ArrayView<const double>& point, 
+    const unsigned num_neighbors ) const
+{
+    DTK_REQUIRE( DIM == point.size() );
+    Teuchos::Array<unsigned> neighbors( num_neighbors );
+    Teuchos::Array<double> neighbor_dists( num_neighbors );
+    nnSearch( point.getRawPtr(), num_neighbors,
+	      neighbors.getRawPtr(), neighbor_dists.getRawPtr() );
+    return neighbors;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Perform a nearest neighbor search within a specified radius.
+ */ 
+template<int DIM>
+Teuchos::Array<unsigned> MappedSearchTree<DIM>::radiusSearch( 
+    const Teuchos::ArrayView<const double>& point, 
+    const double radius ) const
+{
+    DTK_REQUIRE( DIM == point.size() );
+    Teuchos::Array<std::pair<unsigned,double> > neighbor_pairs;
+    radiusSearch( point.getRawPtr(), radius, neighbor_pairs );
+    Teuchos::Array<unsigned> neighbors( neighbor_pairs.size() );
+    for ( int n = 0; n < neighbor_pairs.size(); ++n )
+    {
+	neighbors[n] = neighbor_pairs[n].first;
+    }
+    return neighbors;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Perform an n-nearest neighbor search into caller-owned buffers.
+ *
+ * The neighbors are sorted by distance and the squared distances are
+ * returned. Both buffers must hold num_neighbors entries and no more
+ * neighbors than there are points in the tree should be requested.
+ */
+template<int DIM>
+void MappedSearchTree<DIM>::nnSearch( const double* point,
+				      const unsigned num_neighbors,
+				      unsigned* neighbors,
+				      double* neighbor_dists ) const
+{
+    DTK_REQUIRE( num_neighbors <= d_header->num_points );
+    if ( 0 == num_neighbors )
+    {
+	return;
+    }
+    nanoflann::KNNResultSet<double,unsigned> result_set( num_neighbors );
+    result_set.init( neighbors, neighbor_dists );
+    double dists[DIM];
+    double mindistsq = initialDistances( point, dists );
+    searchNode( result_set, point, 0, mindistsq, dists );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Perform a nearest neighbor search within a specified radius into a
+ * caller-owned buffer.
+ *
+ * The neighbor ids and their squared distances are sorted by distance. The
+ * buffer is cleared first and reusing it between searches avoids
+ * reallocation.
+ */ 
+template<int DIM>
+void MappedSearchTree<DIM>::radiusSearch( 
+    const double* point,
+    const double radius,
+    Teuchos::Array<std::pair<unsigned,double> >& neighbors ) const
+{
+    double l2_radius = radius*radius + 
+		       100.0*std::numeric_limits<double>::epsilon();
+    nanoflann::RadiusResultSet<double,unsigned> result_set( 
+	l2_radius, neighbors );
+    if ( 0 == d_header->num_nodes )
+    {
+	return;
+    }
+    double dists[DIM];
+    double mindistsq = initialDistances( point, dists );
+    searchNode( result_set, point, 0, mindistsq, dists );
+    std::sort( neighbors.begin(), neighbors.end(), 
+	       nanoflann::IndexDist_Sorter() );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Perform an n-nearest neighbor search for a batch of points.
+ *
+ * \param points The query point coordinates, DIM values per point.
+ *
+ * \param num_neighbors The number of neighbors to find for each point. If
+ * the tree has fewer points then all of them are found.
+ *
+ * \param offsets Returns the offset of the first neighbor of each query
+ * point into the neighbors. Its size is the number of query points plus
+ * one.
+ *
+ * \param neighbors Returns the neighbors of all query points sorted by
+ * distance for each point.
+ *
+ * \param neighbor_dists If not null, returns the distance to each neighbor.
+ */
+template<int DIM>
+void MappedSearchTree<DIM>::nnSearchBatch(
+    const Teuchos::ArrayView<const double>& points,
+    const unsigned num_neighbors,
+    Teuchos::Array<std::size_t>& offsets,
+    Teuchos::Array<unsigned>& neighbors,
+    const Teuchos::Ptr<Teuchos::Array<double> >& neighbor_dists ) const
+{
+    std::size_t num_found = std::min( 
+	Teuchos::as<std::size_t>(num_neighbors), numPoints() );
+    nnSearchBatchImpl<DIM>( *this, points, num_found, 
+			    offsets, neighbors, neighbor_dists );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Perform a nearest neighbor search within a specified radius for a
+ * batch of points.
+ *
+ * \param points The query point coordinates, DIM values per point.
+ *
+ * \param radius The search radius.
+ *
+ * \param offsets Returns the offset of the first neighbor of each query
+ * point into the neighbors. Its size is the number of query points plus
+ * one.
+ *
+ * \param neighbors Returns the neighbors of all query points sorted by
+ * distance for each point.
+ *
+ * \param neighbor_dists If not null, returns the distance to each neighbor.
+ */
+template<int DIM>
+void MappedSearchTree<DIM>::radiusSearchBatch(
+    const Teuchos::ArrayView<const double>& points,
+    const double radius,
+    Teuchos::Array<std::size_t>& offsets,
+    Teuchos::Array<unsigned>& neighbors,
+    const Teuchos::Ptr<Teuchos::Array<double> >& neighbor_dists ) const
+{
+    radiusSearchBatchImpl<DIM>( *this, points, radius, 
+				offsets, neighbors, neighbor_dists );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Set the image sections from the start of an image.
+ */
+template<int DIM>
+void MappedSearchTree<DIM>::setImage( const char* image, 
+				      const std::size_t image_size )
+{
+    DTK_INSIST( sizeof(SearchTreeImageHeader) <= image_size );
+    d_header = reinterpret_cast<const SearchTreeImageHeader*>( image );
+
+    DTK_INSIST( 0 == std::strncmp(d_header->magic,
+				  SearchTreeImageHeader::magicString(),
+				  sizeof(d_header->magic)) );
+    DTK_INSIST( SearchTreeImageHeader::byte_order_marker == 
+		d_header->byte_order );
+    DTK_INSIST( SearchTreeImageHeader::current_version == 
+		d_header->version );
+    DTK_INSIST( DIM == d_header->dim );
+    DTK_INSIST( d_header->image_size <= image_size );
+
+    // Check that the sections lie within the image. The searches start at
+    // the root node so a tree with points must have one.
+    std::uint64_t num_points = d_header->num_points;
+    std::uint64_t num_nodes = d_header->num_nodes;
+    DTK_INSIST( 0 == num_points || 0 < num_nodes );
+    DTK_INSIST( sectionFits(d_header->points_offset, 
+			    num_points * DIM * sizeof(double),
+			    d_header->image_size) );
+    DTK_INSIST( sectionFits(d_header->ids_offset, 
+			    num_points * sizeof(std::uint32_t),
+			    d_header->image_size) );
+    DTK_INSIST( sectionFits(d_header->nodes_offset, 
+			    num_nodes * sizeof(SearchTreeImageNode),
+			    d_header->image_size) );
+
+    d_points = reinterpret_cast<const double*>( 
+	image + d_header->points_offset );
+    d_ids = reinterpret_cast<const std::uint32_t*>( 
+	image + d_header->ids_offset );
+    d_nodes = reinterpret_cast<const SearchTreeImageNode*>( 
+	image + d_header->nodes_offset );
+
+    // Check that the searches stay within the nodes and points. The nodes
+    // are written with each child after its parent so the searches always
+    // terminate.
+    std::int64_t end_node = d_header->num_nodes;
+    for ( std::int64_t n = 0; n < end_node; ++n )
+    {
+	const SearchTreeImageNode& node = d_nodes[n];
+	if ( -1 == node.child1 )
+	{
+	    DTK_INSIST( node.left <= node.right );
+	    DTK_INSIST( node.right <= d_header->num_points );
+	}
+	else
+	{
+	    DTK_INSIST( 0 <= node.divfeat && node.divfeat < DIM );
+	    DTK_INSIST( n < node.child1 && node.child1 < end_node );
+	    DTK_INSIST( n < node.child2 && node.child2 < end_node );
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Check if an aligned image section lies within the image.
+ */
+template<int DIM>
+bool MappedSearchTree<DIM>::sectionFits( const std::uint64_t offset, 
+					 const std::uint64_t size,
+					 const std::uint64_t image_size )
+{
+    return ( 0 == offset % SearchTreeImageHeader::alignment ) &&
+	( sizeof(SearchTreeImageHeader) <= offset ) &&
+	( offset <= image_size ) && ( size <= image_size - offset );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Compute the squared distances from a point to the root bounding
+ * box in each dimension.
+ *
+ * \return The squared distance from the point to the box.
+ */
+template<int DIM>
+double MappedSearchTree<DIM>::initialDistances( const double* point, 
+						double* dists ) const
+{
+    double distsq = 0.0;
+    for ( int d = 0; d < DIM; ++d )
+    {
+	dists[d] = 0.0;
+	if ( point[d] < d_header->low[d] )
+	{
+	    dists[d] = (point[d] - d_header->low[d]) * 
+		       (point[d] - d_header->low[d]);
+	    distsq += dists[d];
+	}
+	if ( point[d] > d_header->high[d] )
+	{
+	    dists[d] = (point[d] - d_header->high[d]) * 
+		       (point[d] - d_header->high[d]);
+	    distsq += dists[d];
+	}
+    }
+    return distsq;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Search the tree from a node.
+ *
+ * This follows the exact search of nanoflann so the neighbors are visited
+ * and ordered the same way as in the tree that wrote the image.
+ *
+ * \param result_set The nanoflann result set to add the neighbors to.
+ *
+ * \param point The query point.
+ *
+ * \param node The index of the node to search.
+ *
+ * \param mindistsq The squared distance from the point to the node.
+ *
+ * \param dists The squared distance from the point to the node in each
+ * dimension.
+ */
+template<int DIM>
+template<class ResultSet>
+void MappedSearchTree<DIM>::searchNode( ResultSet& result_set,
+					const double* point,
+					const int node,
+					double mindistsq,
+					double* dists ) const
+{
+    const SearchTreeImageNode& current = d_nodes[node];
+
+    // Check the points of a leaf.
+    if ( -1 == current.child1 )
+    {
+	double worst_dist = result_set.worstDist();
+	for ( std::uint32_t i = current.left; i < current.right; ++i )
+	{
+	    const double* leaf_point = d_points + i*DIM;
+	    double dist = 0.0;
+	    for ( int d = 0; d < DIM; ++d )
+	    {
+		dist += (point[d] - leaf_point[d]) * (point[d] - leaf_point[d]);
+	    }
+	    if ( dist < worst_dist )
+	    {
+		result_set.addPoint( dist, d_ids[i] );
+	    }
+	}
+	return;
+    }
+
+    // Search the child on the side of the point first.
+    int split = current.divfeat;
+    double val = point[split];
+    double diff1 = val - current.divlow;
+    double diff2 = val - current.divhigh;
+    int best_child = current.child2;
+    int other_child = current.child1;
+    double cut_dist = diff1 * diff1;
+    if ( (diff1+diff2) < 0 )
+    {
+	best_child = current.child1;
+	other_child = current.child2;
+	cut_dist = diff2 * diff2;
+    }
+    searchNode( result_set, point, best_child, mindistsq, dists );
+
+    // Search the other child if it may hold closer points.
+    double dst = dists[split];
+    mindistsq = mindistsq + cut_dist - dst;
+    dists[split] = cut_dist;
+    if ( mindistsq <= result_set.worstDist() )
+    {
+	searchNode( result_set, point, other_child, mindistsq, dists );
+    }
+    dists[split] = dst;
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+
+#endif // end DTK_MAPPEDSEARCHTREE_IMPL_HPP
+
+//---------------------------------------------------------------------------//
+// end DTK_MappedSearchTree_impl.hpp
+//---------------------------------------------------------------------------//
@@ -39,6 +39,11 @@
 //---------------------------------------------------------------------------//
 
 #include "DTK_SearchTreeFactory.hpp"
+#include "DTK_MappedSearchTree.hpp"
+#include "DTK_SearchTreeImage.hpp"
+#include "DTK_DBC.hpp"
+
+#include <fstream>
 
 namespace DataTransferKit
 {
@@ -52,12 +57,27 @@ namespace DataTransferKit
  *
  * \param leaf_size The leaft size to build the tree with.
  *
+ * \param parallel_build If true, build the tree with threads.
+ *
+ * \param curve If not NONE, sort the tree points and batch query points
+ * along this curve.
+ *
+ * \param leaf_blocks If true, store the leaf coordinates by dimension for
+ * vectorized leaf scans.
+ *
+ * \param eps If positive, n-nearest neighbor searches return neighbors
+ * within a factor of (1+eps) of the exact distances.
+ *
  * \return The constructed tree.
  */
 Teuchos::RCP<StaticSearchTree> SearchTreeFactory::createStaticTree( 
     const unsigned dim,
     const Teuchos::ArrayView<const double>& points,
-    const unsigned leaf_size )
+    const unsigned leaf_size,
+    const bool parallel_build,
+    const SpaceFillingCurve::CurveType curve,
+    const bool leaf_blocks,
+    const double eps )
 {
     Teuchos::RCP<StaticSearchTree> tree;
 
@@ -66,21 +86,71 @@ Teuchos::RCP<StaticSearchTree> SearchTreeFactory::createStaticTree(
 	case 1:
 	{
 	    tree = Teuchos::rcp( 
-		new NanoflannTree<1>(points, leaf_size) );
+		new NanoflannTree<1>(points, leaf_size, parallel_build, 
+				     curve, leaf_blocks, eps) );
 	}
 	break;
 
 	case 2:
 	{
 	    tree = Teuchos::rcp( 
-		new NanoflannTree<2>(points, leaf_size) );
+		new NanoflannTree<2>(points, leaf_size, parallel_build, 
+				     curve, leaf_blocks, eps) );
 	}
 	break;
 
 	case 3:
 	{
 	    tree = Teuchos::rcp( 
-		new NanoflannTree<3>(points, leaf_size) );
+		new NanoflannTree<3>(points, leaf_size, parallel_build, 
+				     curve, leaf_blocks, eps) );
+	}
+	break;
+    };
+
+    return tree;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Tree image creation method.
+ *
+ * \param filename An image file written by NanoflannTree::writeImage. The
+ * file is mapped read-only and the tree is searched in place without being
+ * rebuilt.
+ *
+ * \return The tree over the image with the dimension of the image.
+ */
+Teuchos::RCP<StaticSearchTree> SearchTreeFactory::createMappedTree( 
+    const std::string& filename )
+{
+    // Read the dimension from the image header.
+    SearchTreeImageHeader header;
+    std::ifstream image( filename.c_str(), std::ios::in | std::ios::binary );
+    image.read( reinterpret_cast<char*>(&header), sizeof(header) );
+    DTK_INSIST( image.good() );
+    image.close();
+    DTK_INSIST( 1 <= header.dim && header.dim <= 3 );
+
+    Teuchos::RCP<StaticSearchTree> tree;
+
+    switch ( header.dim )
+    {
+	case 1:
+	{
+	    tree = Teuchos::rcp( new MappedSearchTree<1>(filename) );
+	}
+	break;
+
+	case 2:
+	{
+	    tree = Teuchos::rcp( new MappedSearchTree<2>(filename) );
+	}
+	break;
+
+	case 3:
+	{
+	    tree = Teuchos::rcp( new MappedSearchTree<3>(filename) );
 	}
 	break;
     };
@@ -42,9 +42,12 @@
 #define DTK_SEARCHTREEFACTORY_HPP
 
 #include "DTK_StaticSearchTree.hpp"
+#include "DTK_SpaceFillingCurve.hpp"
 
 #include <Teuchos_RCP.hpp>
 
+#include <string>
+
 namespace DataTransferKit
 {
 //---------------------------------------------------------------------------//
@@ -70,7 +73,15 @@ class SearchTreeFactory
     static Teuchos::RCP<StaticSearchTree> createStaticTree(
 	const unsigned dim,
 	const Teuchos::ArrayView<const double>& points,
-	const unsigned leaf_size );
+	const unsigned leaf_size,
+	const bool parallel_build = false,
+	const SpaceFillingCurve::CurveType curve = SpaceFillingCurve::NONE,
+	const bool leaf_blocks = false,
+	const double eps = 0.0 );
+
+    // Tree image creation method.
+    static Teuchos::RCP<StaticSearchTree> createMappedTree(
+	const std::string& filename );
 };
 
 //---------------------------------------------------------------------------//
@@ -0,0 +1,181 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_SearchTreeImage.hpp
+ * \author Stuart R. Slattery
+ * \brief  Flat binary image format for search trees.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef DTK_SEARCHTREEIMAGE_HPP
+#define DTK_SEARCHTREEIMAGE_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Search tree image format.
+ *
+ * A search tree image holds everything needed to query a built tree in one
+ * flat block of memory so it can be written to a file and mapped back in
+ * without parsing or rebuilding. An image is laid out as:
+ *
+ * 1) A SearchTreeImageHeader.
+ *
+ * 2) The point coordinates in tree order, DIM doubles per point. The points
+ * of each leaf are contiguous.
+ *
+ * 3) The id of each point in the original point array as 32-bit unsigned
+ * integers.
+ *
+ * 4) The tree nodes as SearchTreeImageNode with the root first.
+ *
+ * Every section starts on an 8 byte boundary at the offset given in the
+ * header. Images are written in the byte order of the machine and can only
+ * be read on machines with the same byte order.
+ */
+//---------------------------------------------------------------------------//
+struct SearchTreeImageHeader
+{
+    //! Magic string identifying an image.
+    char magic[8];
+
+    //! Byte order marker. Reads as byte_order_marker on a machine with the
+    //! byte order of the writer.
+    std::uint32_t byte_order;
+
+    //! Image format version.
+    std::uint32_t version;
+
+    //! Spatial dimension.
+    std::uint32_t dim;
+
+    //! Number of points.
+    std::uint32_t num_points;
+
+    //! Number of tree nodes.
+    std::uint32_t num_nodes;
+
+    //! Unused.
+    std::uint32_t padding;
+
+    //! Byte offset of the point coordinates.
+    std::uint64_t points_offset;
+
+    //! Byte offset of the point ids.
+    std::uint64_t ids_offset;
+
+    //! Byte offset of the tree nodes.
+    std::uint64_t nodes_offset;
+
+    //! Total size of the image in bytes.
+    std::uint64_t image_size;
+
+    //! Lower corner of the point bounding box. Only the first dim values
+    //! are used.
+    double low[3];
+
+    //! Upper corner of the point bounding box. Only the first dim values
+    //! are used.
+    double high[3];
+
+    //! Magic string value.
+    static const char* magicString()
+    { return "DTKTREE"; }
+
+    //! Byte order marker value.
+    static const std::uint32_t byte_order_marker = 0x01020304;
+
+    //! Current format version.
+    static const std::uint32_t current_version = 1;
+
+    //! Alignment of the image sections in bytes.
+    static const std::size_t alignment = 8;
+
+    //! Round a byte offset up to the section alignment.
+    static std::uint64_t align( const std::uint64_t offset )
+    { return (offset + alignment - 1) / alignment * alignment; }
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Search tree image node.
+ *
+ * Leaves have no children and hold the range [left,right) of the image
+ * points. Inner nodes split along dimension divfeat. Their first child holds
+ * the points with coordinates up to divlow and their second child the
+ * points with coordinates from divhigh.
+ */
+//---------------------------------------------------------------------------//
+struct SearchTreeImageNode
+{
+    //! First point of a leaf.
+    std::uint32_t left;
+
+    //! One past the last point of a leaf.
+    std::uint32_t right;
+
+    //! Split dimension of an inner node. -1 for leaves.
+    std::int32_t divfeat;
+
+    //! Index of the first child. -1 for leaves.
+    std::int32_t child1;
+
+    //! Index of the second child. -1 for leaves.
+    std::int32_t child2;
+
+    //! Unused.
+    std::int32_t padding;
+
+    //! Upper bound of the first child along the split dimension.
+    double divlow;
+
+    //! Lower bound of the second child along the split dimension.
+    double divhigh;
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+
+#endif // end DTK_SEARCHTREEIMAGE_HPP
+
+//---------------------------------------------------------------------------//
+// end DTK_SearchTreeImage.hpp
+//---------------------------------------------------------------------------//
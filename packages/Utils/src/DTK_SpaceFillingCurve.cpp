@@ -0,0 +1,273 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_SpaceFillingCurve.cpp
+ * \author Stuart R. Slattery
+ * \brief  Space-filling curve ordering of point clouds.
+ */
+//---------------------------------------------------------------------------//
+
+#include <limits>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
+#include "DTK_SpaceFillingCurve.hpp"
+#include "DTK_DBC.hpp"
+
+#include <Teuchos_as.hpp>
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get a curve type from its parameter name.
+ *
+ * \param name One of "None", "Morton", or "Hilbert".
+ *
+ * \return The curve type.
+ */
+SpaceFillingCurve::CurveType 
+SpaceFillingCurve::curveType( const std::string& name )
+{
+    bool valid_name = 
+	( "None" == name || "Morton" == name || "Hilbert" == name );
+    DTK_INSIST( valid_name );
+
+    CurveType curve = NONE;
+    if ( "Morton" == name )
+    {
+	curve = MORTON;
+    }
+    else if ( "Hilbert" == name )
+    {
+	curve = HILBERT;
+    }
+    return curve;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Compute the permutation that sorts a point cloud along a curve.
+ *
+ * \param dim The spatial dimension of the points.
+ *
+ * \param points The point coordinates, dim values per point.
+ *
+ * \param curve The curve to sort along. NONE gives the identity.
+ *
+ * \param permutation Returns the original index of each point in curve
+ * order. Points with the same curve index keep their original order.
+ */
+void SpaceFillingCurve::sortPermutation( 
+    const int dim,
+    const Teuchos::ArrayView<const double>& points,
+    const CurveType curve,
+    Teuchos::Array<unsigned>& permutation )
+{
+    DTK_REQUIRE( 0 < dim && dim <= 3 );
+    DTK_REQUIRE( 0 == points.size() % dim );
+
+    int num_points = points.size() / dim;
+    permutation.resize( num_points );
+    for ( int i = 0; i < num_points; ++i )
+    {
+	permutation[i] = i;
+    }
+    if ( NONE == curve || 0 == num_points )
+    {
+	return;
+    }
+
+    // Get the bounding box of the points.
+    Teuchos::Array<double> low( dim, std::numeric_limits<double>::max() );
+    Teuchos::Array<double> high( dim, -std::numeric_limits<double>::max() );
+    for ( int i = 0; i < num_points; ++i )
+    {
+	for ( int d = 0; d < dim; ++d )
+	{
+	    low[d] = std::min( low[d], points[dim*i+d] );
+	    high[d] = std::max( high[d], points[dim*i+d] );
+	}
+    }
+
+    // Quantize the points onto a grid with as many bits per dimension as
+    // fit in the index and compute their curve indices.
+    int num_bits = std::min( 32, 64 / dim );
+    double num_cells = std::ldexp( 1.0, num_bits );
+    Teuchos::Array<double> scale( dim, 0.0 );
+    for ( int d = 0; d < dim; ++d )
+    {
+	if ( high[d] > low[d] )
+	{
+	    scale[d] = num_cells / (high[d] - low[d]);
+	}
+    }
+    Teuchos::Array<std::pair<std::uint64_t,unsigned> > keys( num_points );
+    std::uint64_t cell[3];
+    for ( int i = 0; i < num_points; ++i )
+    {
+	for ( int d = 0; d < dim; ++d )
+	{
+	    cell[d] = Teuchos::as<std::uint64_t>( std::min( 
+		    num_cells - 1.0, (points[dim*i+d] - low[d]) * scale[d] ) );
+	}
+	keys[i] = std::make_pair( curveIndex(dim,num_bits,curve,cell), 
+				  Teuchos::as<unsigned>(i) );
+    }
+
+    // Sort the points by their curve indices.
+    std::sort( keys.begin(), keys.end() );
+    for ( int i = 0; i < num_points; ++i )
+    {
+	permutation[i] = keys[i].second;
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Gather the points of a cloud in permutation order.
+ *
+ * \param dim The spatial dimension of the points.
+ *
+ * \param points The point coordinates, dim values per point.
+ *
+ * \param permutation The original index of each point in the new order.
+ *
+ * \param permuted_points Returns the coordinates in the new order.
+ */
+void SpaceFillingCurve::permutePoints( 
+    const int dim,
+    const Teuchos::ArrayView<const double>& points,
+    const Teuchos::ArrayView<const unsigned>& permutation,
+    Teuchos::Array<double>& permuted_points )
+{
+    DTK_REQUIRE( dim*permutation.size() == points.size() );
+
+    int num_points = permutation.size();
+    permuted_points.resize( points.size() );
+    for ( int i = 0; i < num_points; ++i )
+    {
+	for ( int d = 0; d < dim; ++d )
+	{
+	    permuted_points[dim*i+d] = points[dim*permutation[i]+d];
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Compute the curve index of a point from its integer coordinates.
+ *
+ * \param dim The spatial dimension of the point.
+ *
+ * \param num_bits The number of bits in each coordinate.
+ *
+ * \param curve The curve type.
+ *
+ * \param cell The integer coordinates of the point. These are overwritten.
+ *
+ * The Morton index interleaves the bits of the coordinates. The Hilbert
+ * index first transforms the coordinates into the transposed Hilbert index
+ * with Skilling's algorithm (AIP Conf. Proc. 707, 2004) and then
+ * interleaves its bits.
+ */
+std::uint64_t SpaceFillingCurve::curveIndex( const int dim,
+					     const int num_bits,
+					     const CurveType curve,
+					     std::uint64_t* cell )
+{
+    if ( HILBERT == curve )
+    {
+	std::uint64_t top = std::uint64_t(1) << (num_bits-1);
+	std::uint64_t mask = 0;
+	std::uint64_t t = 0;
+
+	// Inverse undo.
+	for ( std::uint64_t q = top; q > 1; q >>= 1 )
+	{
+	    mask = q - 1;
+	    for ( int d = 0; d < dim; ++d )
+	    {
+		if ( cell[d] & q )
+		{
+		    cell[0] ^= mask;
+		}
+		else
+		{
+		    t = (cell[0] ^ cell[d]) & mask;
+		    cell[0] ^= t;
+		    cell[d] ^= t;
+		}
+	    }
+	}
+
+	// Gray encode.
+	for ( int d = 1; d < dim; ++d )
+	{
+	    cell[d] ^= cell[d-1];
+	}
+	t = 0;
+	for ( std::uint64_t q = top; q > 1; q >>= 1 )
+	{
+	    if ( cell[dim-1] & q )
+	    {
+		t ^= q - 1;
+	    }
+	}
+	for ( int d = 0; d < dim; ++d )
+	{
+	    cell[d] ^= t;
+	}
+    }
+
+    // Interleave the bits from the most significant down.
+    std::uint64_t index = 0;
+    for ( int b = num_bits - 1; b >= 0; --b )
+    {
+	for ( int d = 0; d < dim; ++d )
+	{
+	    index = (index << 1) | ((cell[d] >> b) & 1);
+	}
+    }
+    return index;
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+// end DTK_SpaceFillingCurve.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,114 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   DTK_SpaceFillingCurve.hpp
+ * \author Stuart R. Slattery
+ * \brief  Space-filling curve ordering of point clouds.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef DTK_SPACEFILLINGCURVE_HPP
+#define DTK_SPACEFILLINGCURVE_HPP
+
+#include <string>
+#include <cstdint>
+
+#include <Teuchos_ArrayView.hpp>
+#include <Teuchos_Array.hpp>
+
+namespace DataTransferKit
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \class SpaceFillingCurve
+ *
+ * \brief Order point clouds along a Morton or Hilbert curve.
+ *
+ * Points that are close on the curve are close in space. Searching or
+ * storing points in curve order keeps consecutive points in the same tree
+ * nodes and cache lines. The ordering is returned as a permutation so the
+ * results for the sorted points can be put back in the caller's order.
+ */
+//---------------------------------------------------------------------------//
+class SpaceFillingCurve
+{
+  public:
+
+    //! Curve types.
+    enum CurveType
+    {
+	NONE = 0,
+	MORTON,
+	HILBERT
+    };
+
+  public:
+
+    // Get a curve type from its parameter name.
+    static CurveType curveType( const std::string& name );
+
+    // Compute the permutation that sorts a point cloud along a curve.
+    static void sortPermutation( 
+	const int dim,
+	const Teuchos::ArrayView<const double>& points,
+	const CurveType curve,
+	Teuchos::Array<unsigned>& permutation );
+
+    // Gather the points of a cloud in permutation order.
+    static void permutePoints( 
+	const int dim,
+	const Teuchos::ArrayView<const double>& points,
+	const Teuchos::ArrayView<const unsigned>& permutation,
+	Teuchos::Array<double>& permuted_points );
+
+  private:
+
+    // Compute the curve index of a point from its integer coordinates.
+    static std::uint64_t curveIndex( const int dim,
+				     const int num_bits,
+				     const CurveType curve,
+				     std::uint64_t* cell );
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace DataTransferKit
+
+//---------------------------------------------------------------------------//
+
+#endif // end DTK_SPACEFILLINGCURVE_HPP
+
+//---------------------------------------------------------------------------//
+// end DTK_SpaceFillingCurve.hpp
+//---------------------------------------------------------------------------//
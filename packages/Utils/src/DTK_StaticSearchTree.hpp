@@ -41,12 +41,18 @@
 #ifndef DTK_STATICSEARCHTREE_HPP
 #define DTK_STATICSEARCHTREE_HPP
 
+#include <string>
+
 #include <Teuchos_ArrayView.hpp>
 #include <Teuchos_Array.hpp>
 #include <Teuchos_RCP.hpp>
+#include <Teuchos_Ptr.hpp>
 
 #include <DTK_nanoflann.hpp>
 
+#include "DTK_SpaceFillingCurve.hpp"
+#include "DTK_SearchTreeImage.hpp"
+
 namespace DataTransferKit
 {
 //---------------------------------------------------------------------------//
@@ -73,6 +79,69 @@ class StaticSearchTree
     virtual Teuchos::Array<unsigned> radiusSearch( 
 	const Teuchos::ArrayView<const double>& point, 
 	const double radius ) const = 0;
+
+    // Perform an n-nearest neighbor search for a batch of points.
+    virtual void nnSearchBatch(
+	const Teuchos::ArrayView<const double>& points,
+	const unsigned num_neighbors,
+	Teuchos::Array<std::size_t>& offsets,
+	Teuchos::Array<unsigned>& neighbors,
+	const Teuchos::Ptr<Teuchos::Array<double> >& neighbor_dists =
+	Teuchos::null ) const = 0;
+
+    // Perform a nearest neighbor search within a specified radius for a
+    // batch of points.
+    virtual void radiusSearchBatch(
+	const Teuchos::ArrayView<const double>& points,
+	const double radius,
+	Teuchos::Array<std::size_t>& offsets,
+	Teuchos::Array<unsigned>& neighbors,
+	const Teuchos::Ptr<Teuchos::Array<double> >& neighbor_dists =
+	Teuchos::null ) const = 0;
+
+  protected:
+
+    // Perform an n-nearest neighbor search for a batch of points with the
+    // single point search of a tree.
+    template<int DIM,class Tree>
+    static void nnSearchBatchImpl(
+	const Tree& tree,
+	const Teuchos::ArrayView<const double>& points,
+	const std::size_t num_neighbors,
+	Teuchos::Array<std::size_t>& offsets,
+	Teuchos::Array<unsigned>& neighbors,
+	const Teuchos::Ptr<Teuchos::Array<double> >& neighbor_dists,
+	const SpaceFillingCurve::CurveType query_curve = 
+	SpaceFillingCurve::NONE );
+
+    // Perform a radius search for a batch of points with the single point
+    // search of a tree.
+    template<int DIM,class Tree>
+    static void radiusSearchBatchImpl(
+	const Tree& tree,
+	const Teuchos::ArrayView<const double>& points,
+	const double radius,
+	Teuchos::Array<std::size_t>& offsets,
+	Teuchos::Array<unsigned>& neighbors,
+	const Teuchos::Ptr<Teuchos::Array<double> >& neighbor_dists,
+	const SpaceFillingCurve::CurveType query_curve = 
+	SpaceFillingCurve::NONE );
+
+    // Put the batch results of points searched in permuted order back in
+    // the order of the original points.
+    static void unpermuteBatch(
+	const Teuchos::ArrayView<const unsigned>& permutation,
+	const Teuchos::ArrayView<const std::size_t>& permuted_offsets,
+	const Teuchos::ArrayView<const unsigned>& permuted_neighbors,
+	const Teuchos::ArrayView<const double>& permuted_dists,
+	Teuchos::Array<std::size_t>& offsets,
+	Teuchos::Array<unsigned>& neighbors,
+	const Teuchos::Ptr<Teuchos::Array<double> >& neighbor_dists );
+
+  protected:
+
+    // Number of batch points searched together by a thread.
+    static const int b_batch_block_size = 256;
 };
 
 //---------------------------------------------------------------------------//
@@ -140,7 +209,12 @@ class NanoflannTree : public StaticSearchTree
 
     // Default constructor.
     NanoflannTree( const Teuchos::ArrayView<const double>& points,
-		   const unsigned max_leaf_size );
+		   const unsigned max_leaf_size,
+		   const bool parallel_build = false,
+		   const SpaceFillingCurve::CurveType curve = 
+		   SpaceFillingCurve::NONE,
+		   const bool leaf_blocks = false,
+		   const double eps = 0.0 );
 
     // Destructor.
     ~NanoflannTree()
@@ -156,8 +230,59 @@ class NanoflannTree : public StaticSearchTree
 	const Teuchos::ArrayView<const double>& point, 
 	const double radius ) const;
 
+    // Perform an n-nearest neighbor search into caller-owned buffers.
+    void nnSearch( const double* point,
+		   const unsigned num_neighbors,
+		   unsigned* neighbors,
+		   double* neighbor_dists ) const;
+
+    // Perform a nearest neighbor search within a specified radius into a
+    // caller-owned buffer.
+    void radiusSearch( 
+	const double* point,
+	const double radius,
+	Teuchos::Array<std::pair<unsigned,double> >& neighbors ) const;
+
+    // Perform an n-nearest neighbor search for a batch of points.
+    void nnSearchBatch(
+	const Teuchos::ArrayView<const double>& points,
+	const unsigned num_neighbors,
+	Teuchos::Array<std::size_t>& offsets,
+	Teuchos::Array<unsigned>& neighbors,
+	const Teuchos::Ptr<Teuchos::Array<double> >& neighbor_dists =
+	Teuchos::null ) const;
+
+    // Perform a nearest neighbor search within a specified radius for a
+    // batch of points.
+    void radiusSearchBatch(
+	const Teuchos::ArrayView<const double>& points,
+	const double radius,
+	Teuchos::Array<std::size_t>& offsets,
+	Teuchos::Array<unsigned>& neighbors,
+	const Teuchos::Ptr<Teuchos::Array<double> >& neighbor_dists =
+	Teuchos::null ) const;
+
+    // Write the tree to an image file.
+    void writeImage( const std::string& filename ) const;
+
+    // Get the memory used by the tree in bytes.
+    std::size_t usedMemory() const;
+
   private:
 
+    // Search parameters for n-nearest neighbor searches.
+    nanoflann::SearchParams d_knn_params;
+
+    // Curve the tree points and the batch query points are sorted along.
+    SpaceFillingCurve::CurveType d_curve;
+
+    // Original id of each tree point in curve order. Empty if the points
+    // are not sorted.
+    Teuchos::Array<unsigned> d_permutation;
+
+    // Tree points in curve order. Empty if the points are not sorted.
+    Teuchos::Array<double> d_permuted_points;
+
     // PointCloud.
     PointCloud<DIM> d_cloud;
 
@@ -42,14 +42,372 @@
 #define DTK_STATICSEARCHTREE_IMPL_HPP
 
 #include <limits>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
 
 #include "DTK_DBC.hpp"
+#include "DTK_BatchSearch.hpp"
 
 #include <Teuchos_as.hpp>
 
+#if HAVE_DTK_OPENMP
+#include <omp.h>
+#endif
+
 namespace DataTransferKit
 {
 //---------------------------------------------------------------------------//
+/*!
+ * \brief Radius search of a single batch point for BatchSearch.
+ */
+template<int DIM,class Tree>
+class StaticSearchTreeRadiusQuery
+{
+  public:
+
+    StaticSearchTreeRadiusQuery( const Tree& tree,
+				 const double* points,
+				 const double radius )
+	: d_tree( tree )
+	, d_points( points )
+	, d_radius( radius )
+    { /* ... */ }
+
+    void operator()( 
+	const int i, 
+	Teuchos::Array<std::pair<unsigned,double> >& neighbors ) const
+    {
+	d_tree.radiusSearch( d_points + i*DIM, d_radius, neighbors );
+    }
+
+  private:
+
+    const Tree& d_tree;
+    const double* d_points;
+    double d_radius;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Store the neighbors and distances of a batch radius search for
+ * BatchSearch.
+ */
+class StaticSearchTreeNeighborStore
+{
+  public:
+
+    StaticSearchTreeNeighborStore( 
+	Teuchos::Array<unsigned>& neighbors,
+	const Teuchos::Ptr<Teuchos::Array<double> >& neighbor_dists )
+	: d_neighbors( neighbors )
+	, d_neighbor_dists( neighbor_dists )
+	, d_neighbor_ptr( 0 )
+	, d_dist_ptr( 0 )
+    { /* ... */ }
+
+    void resize( const std::size_t num_neighbors )
+    {
+	d_neighbors.resize( num_neighbors );
+	d_neighbor_ptr = d_neighbors.getRawPtr();
+	if ( Teuchos::nonnull(d_neighbor_dists) )
+	{
+	    d_neighbor_dists->resize( num_neighbors );
+	    d_dist_ptr = d_neighbor_dists->getRawPtr();
+	}
+    }
+
+    // Distances are found squared.
+    void operator()( const std::size_t n, 
+		     const std::pair<unsigned,double>& neighbor ) const
+    {
+	d_neighbor_ptr[n] = neighbor.first;
+	if ( 0 != d_dist_ptr )
+	{
+	    d_dist_ptr[n] = std::sqrt( neighbor.second );
+	}
+    }
+
+  private:
+
+    Teuchos::Array<unsigned>& d_neighbors;
+    Teuchos::Ptr<Teuchos::Array<double> > d_neighbor_dists;
+    unsigned* d_neighbor_ptr;
+    double* d_dist_ptr;
+};
+
+//---------------------------------------------------------------------------//
+// StaticSearchTree Implementation.
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Perform an n-nearest neighbor search for a batch of points with
+ * the single point search of a tree.
+ *
+ * \param tree The tree. Its single point nnSearch must write the neighbors
+ * of a point and their squared distances into raw buffers.
+ *
+ * \param points The query point coordinates, DIM values per point.
+ *
+ * \param num_neighbors The number of neighbors to find for each point. Must
+ * not be more than the number of points in the tree.
+ *
+ * \param offsets Returns the offset of the first neighbor of each query
+ * point into the neighbors. Its size is the number of query points plus
+ * one.
+ *
+ * \param neighbors Returns the neighbors of all query points sorted by
+ * distance for each point.
+ *
+ * \param neighbor_dists If not null, returns the distance to each neighbor.
+ *
+ * \param query_curve If not NONE, the query points are searched in the
+ * order of this curve and the results are returned in the original order.
+ *
+ * The query points are split over the threads. The output arrays are
+ * resized so their storage may be reused by the caller between batches.
+ */
+template<int DIM,class Tree>
+void StaticSearchTree::nnSearchBatchImpl(
+    const Tree& tree,
+    const Teuchos::ArrayView<const double>& points,
+    const std::size_t num_neighbors,
+    Teuchos::Array<std::size_t>& offsets,
+    Teuchos::Array<unsigned>& neighbors,
+    const Teuchos::Ptr<Teuchos::Array<double> >& neighbor_dists,
+    const SpaceFillingCurve::CurveType query_curve )
+{
+    DTK_REQUIRE( 0 == points.size() % DIM );
+
+    int num_points = points.size() / DIM;
+    std::size_t num_found = num_neighbors;
+    bool store_dists = Teuchos::nonnull( neighbor_dists );
+
+    // Search the points in curve order so consecutive searches visit the
+    // same tree nodes. A single block gains nothing from sorting.
+    if ( SpaceFillingCurve::NONE != query_curve &&
+	 num_points > b_batch_block_size )
+    {
+	Teuchos::Array<unsigned> permutation;
+	Teuchos::Array<double> permuted_points;
+	SpaceFillingCurve::sortPermutation( 
+	    DIM, points, query_curve, permutation );
+	SpaceFillingCurve::permutePoints( 
+	    DIM, points, permutation(), permuted_points );
+	Teuchos::Array<std::size_t> permuted_offsets;
+	Teuchos::Array<unsigned> permuted_neighbors;
+	Teuchos::Array<double> permuted_dists;
+	nnSearchBatchImpl<DIM>( 
+	    tree, permuted_points(), num_neighbors, 
+	    permuted_offsets, permuted_neighbors,
+	    store_dists ? Teuchos::ptrFromRef(permuted_dists) 
+	    : Teuchos::Ptr<Teuchos::Array<double> >() );
+	unpermuteBatch( permutation(), permuted_offsets(), 
+			permuted_neighbors(), permuted_dists(),
+			offsets, neighbors, neighbor_dists );
+	return;
+    }
+
+    offsets.resize( num_points + 1 );
+    for ( int i = 0; i < num_points + 1; ++i )
+    {
+	offsets[i] = i * num_found;
+    }
+    neighbors.resize( num_points * num_found );
+    if ( store_dists )
+    {
+	neighbor_dists->resize( num_points * num_found );
+    }
+    if ( 0 == num_found )
+    {
+	return;
+    }
+
+    // Every point has the same number of neighbors so each one is written
+    // directly into its slot of the output.
+    int num_blocks = 
+	(num_points + b_batch_block_size - 1) / b_batch_block_size;
+    const double* point_ptr = points.getRawPtr();
+    unsigned* neighbor_ptr = neighbors.getRawPtr();
+    double* dist_ptr = store_dists ? neighbor_dists->getRawPtr() : 0;
+#if HAVE_DTK_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for ( int b = 0; b < num_blocks; ++b )
+    {
+	int begin = b * b_batch_block_size;
+	int end = std::min( begin + b_batch_block_size, num_points );
+	Teuchos::Array<double> block_dists( store_dists ? 0 : num_found );
+	double* dists = 0;
+	for ( int i = begin; i < end; ++i )
+	{
+	    dists = store_dists 
+		    ? dist_ptr + i*num_found : block_dists.getRawPtr();
+	    tree.nnSearch( point_ptr + i*DIM, num_found,
+			   neighbor_ptr + i*num_found, dists );
+	    if ( store_dists )
+	    {
+		for ( std::size_t n = 0; n < num_found; ++n )
+		{
+		    dists[n] = std::sqrt( dists[n] );
+		}
+	    }
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Perform a nearest neighbor search within a specified radius for a
+ * batch of points with the single point search of a tree.
+ *
+ * \param tree The tree. Its single point radiusSearch must fill a buffer
+ * with the neighbors of a point and their squared distances.
+ *
+ * \param points The query point coordinates, DIM values per point.
+ *
+ * \param radius The search radius.
+ *
+ * \param offsets Returns the offset of the first neighbor of each query
+ * point into the neighbors. Its size is the number of query points plus
+ * one.
+ *
+ * \param neighbors Returns the neighbors of all query points sorted by
+ * distance for each point.
+ *
+ * \param neighbor_dists If not null, returns the distance to each neighbor.
+ *
+ * \param query_curve If not NONE, the query points are searched in the
+ * order of this curve and the results are returned in the original order.
+ *
+ * The query points are split into blocks searched in parallel by
+ * BatchSearch. The output arrays are resized so their storage may be reused
+ * by the caller between batches.
+ */
+template<int DIM,class Tree>
+void StaticSearchTree::radiusSearchBatchImpl(
+    const Tree& tree,
+    const Teuchos::ArrayView<const double>& points,
+    const double radius,
+    Teuchos::Array<std::size_t>& offsets,
+    Teuchos::Array<unsigned>& neighbors,
+    const Teuchos::Ptr<Teuchos::Array<double> >& neighbor_dists,
+    const SpaceFillingCurve::CurveType query_curve )
+{
+    DTK_REQUIRE( 0 == points.size() % DIM );
+
+    int num_points = points.size() / DIM;
+    bool store_dists = Teuchos::nonnull( neighbor_dists );
+
+    // Search the points in curve order so consecutive searches visit the
+    // same tree nodes. A single block gains nothing from sorting.
+    if ( SpaceFillingCurve::NONE != query_curve &&
+	 num_points > b_batch_block_size )
+    {
+	Teuchos::Array<unsigned> permutation;
+	Teuchos::Array<double> permuted_points;
+	SpaceFillingCurve::sortPermutation( 
+	    DIM, points, query_curve, permutation );
+	SpaceFillingCurve::permutePoints( 
+	    DIM, points, permutation(), permuted_points );
+	Teuchos::Array<std::size_t> permuted_offsets;
+	Teuchos::Array<unsigned> permuted_neighbors;
+	Teuchos::Array<double> permuted_dists;
+	radiusSearchBatchImpl<DIM>( 
+	    tree, permuted_points(), radius, 
+	    permuted_offsets, permuted_neighbors,
+	    store_dists ? Teuchos::ptrFromRef(permuted_dists) 
+	    : Teuchos::Ptr<Teuchos::Array<double> >() );
+	unpermuteBatch( permutation(), permuted_offsets(), 
+			permuted_neighbors(), permuted_dists(),
+			offsets, neighbors, neighbor_dists );
+	return;
+    }
+
+    StaticSearchTreeRadiusQuery<DIM,Tree> query( 
+	tree, points.getRawPtr(), radius );
+    StaticSearchTreeNeighborStore store( neighbors, neighbor_dists );
+    BatchSearch::search<std::pair<unsigned,double> >( 
+	num_points, b_batch_block_size, query, store, offsets );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Put the batch results of points searched in permuted order back in
+ * the order of the original points.
+ *
+ * \param permutation The original index of each permuted point.
+ *
+ * \param permuted_offsets The neighbor offsets of the permuted points.
+ *
+ * \param permuted_neighbors The neighbors of the permuted points.
+ *
+ * \param permuted_dists The neighbor distances of the permuted points. Only
+ * read if neighbor_dists is not null.
+ *
+ * \param offsets Returns the neighbor offsets of the original points.
+ *
+ * \param neighbors Returns the neighbors of the original points.
+ *
+ * \param neighbor_dists If not null, returns the neighbor distances of the
+ * original points.
+ */
+inline void StaticSearchTree::unpermuteBatch(
+    const Teuchos::ArrayView<const unsigned>& permutation,
+    const Teuchos::ArrayView<const std::size_t>& permuted_offsets,
+    const Teuchos::ArrayView<const unsigned>& permuted_neighbors,
+    const Teuchos::ArrayView<const double>& permuted_dists,
+    Teuchos::Array<std::size_t>& offsets,
+    Teuchos::Array<unsigned>& neighbors,
+    const Teuchos::Ptr<Teuchos::Array<double> >& neighbor_dists )
+{
+    DTK_REQUIRE( permutation.size() + 1 == permuted_offsets.size() );
+
+    int num_points = permutation.size();
+    bool store_dists = Teuchos::nonnull( neighbor_dists );
+
+    // Compute the offsets in the original order.
+    offsets.assign( num_points + 1, 0 );
+    for ( int i = 0; i < num_points; ++i )
+    {
+	offsets[ permutation[i]+1 ] = 
+	    permuted_offsets[i+1] - permuted_offsets[i];
+    }
+    for ( int i = 0; i < num_points; ++i )
+    {
+	offsets[i+1] += offsets[i];
+    }
+    neighbors.resize( offsets.back() );
+    if ( store_dists )
+    {
+	neighbor_dists->resize( offsets.back() );
+    }
+
+    // Copy the results of each point into place.
+    const std::size_t* offset_ptr = offsets.getRawPtr();
+    unsigned* neighbor_ptr = neighbors.getRawPtr();
+    double* dist_ptr = store_dists ? neighbor_dists->getRawPtr() : 0;
+#if HAVE_DTK_OPENMP
+#pragma omp parallel for schedule(dynamic,b_batch_block_size)
+#endif
+    for ( int i = 0; i < num_points; ++i )
+    {
+	std::size_t begin = offset_ptr[ permutation[i] ];
+	std::size_t num_results = permuted_offsets[i+1] - permuted_offsets[i];
+	for ( std::size_t n = 0; n < num_results; ++n )
+	{
+	    neighbor_ptr[begin+n] = permuted_neighbors[permuted_offsets[i]+n];
+	    if ( store_dists )
+	    {
+		dist_ptr[begin+n] = permuted_dists[permuted_offsets[i]+n];
+	    }
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+// PointCloud Implementation.
+//---------------------------------------------------------------------------//
 /*! 
  * \brief Compute the distance between a given point and a point in the cloud.
  */
@@ -135,19 +493,88 @@ inline double PointCloud<3>::kdtree_get_pt( const std::size_t idx, int dim ) con
 //---------------------------------------------------------------------------//
 /*!
  * \brief Constructor.
+ *
+ * \param points The point cloud coordinates, DIM values per point.
+ *
+ * \param max_leaf_size The maximum number of points in a leaf.
+ *
+ * \param parallel_build If true, build the tree with threads. The top
+ * levels of splits are made in order and the subtrees below them are built
+ * concurrently. The tree is the same as the serial build.
+ *
+ * \param curve If not NONE, the tree stores a copy of the points sorted
+ * along this curve so the points of a leaf are close in memory, and batch
+ * queries are searched in curve order. Neighbors are always returned as
+ * indices into the original points. Neighbors at equal distance may come
+ * back in a different order than from an unsorted tree.
+ *
+ * \param leaf_blocks If true, the tree also stores the coordinates of each
+ * leaf by dimension so a leaf is scanned with vectorized distance loops
+ * instead of one point at a time. This costs a second copy of the
+ * coordinates.
+ *
+ * \param eps If positive, n-nearest neighbor searches are approximate: the
+ * distance to the i-th neighbor found is at most (1+eps) times the distance
+ * to the true i-th nearest neighbor. Larger values prune more of the tree.
+ * Radius searches are always exact.
  */
 template<int DIM>
 NanoflannTree<DIM>::NanoflannTree(
     const Teuchos::ArrayView<const double>& points, 
-    const unsigned max_leaf_size )
+    const unsigned max_leaf_size,
+    const bool parallel_build,
+    const SpaceFillingCurve::CurveType curve,
+    const bool leaf_blocks,
+    const double eps )
+    : d_curve( curve )
 {
     DTK_CHECK( 0 == points.size() % DIM );
+    DTK_REQUIRE( eps >= 0.0 );
+
+    // nanoflann applies its tolerance to squared distances.
+    d_knn_params.eps = (1.0 + eps) * (1.0 + eps) - 1.0;
 
-    d_cloud = PointCloud<DIM>( points );
+    if ( SpaceFillingCurve::NONE != d_curve )
+    {
+	SpaceFillingCurve::sortPermutation( 
+	    DIM, points, d_curve, d_permutation );
+	SpaceFillingCurve::permutePoints( 
+	    DIM, points, d_permutation(), d_permuted_points );
+	d_cloud = PointCloud<DIM>( d_permuted_points() );
+    }
+    else
+    {
+	d_cloud = PointCloud<DIM>( points );
+    }
     d_tree = Teuchos::rcp( 
 	new TreeType(DIM, d_cloud, 
 		     nanoflann::KDTreeSingleIndexAdaptorParams(max_leaf_size)) );
+
+#if HAVE_DTK_OPENMP
+    if ( parallel_build )
+    {
+	// Split until there are a few subtrees per thread so the unbalanced
+	// subtrees of the middle split still load balance.
+	int task_depth = 0;
+	while ( (1 << task_depth) < 4*omp_get_max_threads() )
+	{
+	    ++task_depth;
+	}
+	d_tree->buildIndexParallel( task_depth );
+    }
+    else
+    {
+	d_tree->buildIndex();
+    }
+#else
+    (void) parallel_build;
     d_tree->buildIndex();
+#endif
+
+    if ( leaf_blocks )
+    {
+	d_tree->buildLeafBlocks();
+    }
 }
 
 //---------------------------------------------------------------------------//
@@ -162,8 +589,8 @@ Teuchos::Array<unsigned> NanoflannTree<DIM>::nnSearch(
     DTK_REQUIRE( DIM == point.size() );
     Teuchos::Array<unsigned> neighbors( num_neighbors );
     Teuchos::Array<double> neighbor_dists( num_neighbors );
-    d_tree->knnSearch( point.getRawPtr(), num_neighbors,
-		       neighbors.getRawPtr(), neighbor_dists.getRawPtr() );
+    nnSearch( point.getRawPtr(), num_neighbors,
+	      neighbors.getRawPtr(), neighbor_dists.getRawPtr() );
     return neighbors;
 }
 
@@ -178,11 +605,7 @@ Teuchos::Array<unsigned> NanoflannTree<DIM>::radiusSearch(
 {
     DTK_REQUIRE( DIM == point.size() );
     Teuchos::Array<std::pair<unsigned,double> > neighbor_pairs;
-    nanoflann::SearchParams params;
-    double l2_radius = radius*radius + 
-		       100.0*std::numeric_limits<double>::epsilon();
-    d_tree->radiusSearch( 
-	point.getRawPtr(), l2_radius, neighbor_pairs, params );
+    radiusSearch( point.getRawPtr(), radius, neighbor_pairs );
 
     Teuchos::Array<std::pair<unsigned,double> >::const_iterator pair_it;
     Teuchos::Array<unsigned> neighbors( neighbor_pairs.size() );
@@ -198,6 +621,222 @@ Teuchos::Array<unsigned> NanoflannTree<DIM>::radiusSearch(
     return neighbors;
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Perform an n-nearest neighbor search into caller-owned buffers.
+ *
+ * The neighbors are sorted by distance and the squared distances are
+ * returned. Both buffers must hold num_neighbors entries and no more
+ * neighbors than there are points in the tree should be requested.
+ */
+template<int DIM>
+void NanoflannTree<DIM>::nnSearch( const double* point,
+				   const unsigned num_neighbors,
+				   unsigned* neighbors,
+				   double* neighbor_dists ) const
+{
+    DTK_REQUIRE( num_neighbors <= d_cloud.kdtree_get_point_count() );
+    if ( 0 == num_neighbors )
+    {
+	return;
+    }
+    nanoflann::KNNResultSet<double,unsigned> result_set( num_neighbors );
+    result_set.init( neighbors, neighbor_dists );
+    d_tree->findNeighbors( result_set, point, d_knn_params );
+    if ( !d_permutation.empty() )
+    {
+	for ( unsigned n = 0; n < num_neighbors; ++n )
+	{
+	    neighbors[n] = d_permutation[ neighbors[n] ];
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Perform a nearest neighbor search within a specified radius into a
+ * caller-owned buffer.
+ *
+ * The neighbor ids and their squared distances are sorted by distance. The
+ * buffer is cleared first and reusing it between searches avoids
+ * reallocation.
+ */ 
+template<int DIM>
+void NanoflannTree<DIM>::radiusSearch( 
+    const double* point,
+    const double radius,
+    Teuchos::Array<std::pair<unsigned,double> >& neighbors ) const
+{
+    nanoflann::SearchParams params;
+    double l2_radius = radius*radius + 
+		       100.0*std::numeric_limits<double>::epsilon();
+    d_tree->radiusSearch( point, l2_radius, neighbors, params );
+    if ( !d_permutation.empty() )
+    {
+	typename Teuchos::Array<std::pair<unsigned,double> >::iterator 
+	    neighbor_it;
+	for ( neighbor_it = neighbors.begin(); 
+	      neighbor_it != neighbors.end(); 
+	      ++neighbor_it )
+	{
+	    neighbor_it->first = d_permutation[ neighbor_it->first ];
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Perform an n-nearest neighbor search for a batch of points.
+ *
+ * \param points The query point coordinates, DIM values per point.
+ *
+ * \param num_neighbors The number of neighbors to find for each point. If
+ * the tree has fewer points then all of them are found.
+ *
+ * \param offsets Returns the offset of the first neighbor of each query
+ * point into the neighbors. Its size is the number of query points plus
+ * one.
+ *
+ * \param neighbors Returns the neighbors of all query points sorted by
+ * distance for each point.
+ *
+ * \param neighbor_dists If not null, returns the distance to each neighbor.
+ */
+template<int DIM>
+void NanoflannTree<DIM>::nnSearchBatch(
+    const Teuchos::ArrayView<const double>& points,
+    const unsigned num_neighbors,
+    Teuchos::Array<std::size_t>& offsets,
+    Teuchos::Array<unsigned>& neighbors,
+    const Teuchos::Ptr<Teuchos::Array<double> >& neighbor_dists ) const
+{
+    std::size_t num_found = std::min( 
+	Teuchos::as<std::size_t>(num_neighbors), 
+	d_cloud.kdtree_get_point_count() );
+    nnSearchBatchImpl<DIM>( *this, points, num_found, 
+			    offsets, neighbors, neighbor_dists, d_curve );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Perform a nearest neighbor search within a specified radius for a
+ * batch of points.
+ *
+ * \param points The query point coordinates, DIM values per point.
+ *
+ * \param radius The search radius.
+ *
+ * \param offsets Returns the offset of the first neighbor of each query
+ * point into the neighbors. Its size is the number of query points plus
+ * one.
+ *
+ * \param neighbors Returns the neighbors of all query points sorted by
+ * distance for each point.
+ *
+ * \param neighbor_dists If not null, returns the distance to each neighbor.
+ */
+template<int DIM>
+void NanoflannTree<DIM>::radiusSearchBatch(
+    const Teuchos::ArrayView<const double>& points,
+    const double radius,
+    Teuchos::Array<std::size_t>& offsets,
+    Teuchos::Array<unsigned>& neighbors,
+    const Teuchos::Ptr<Teuchos::Array<double> >& neighbor_dists ) const
+{
+    radiusSearchBatchImpl<DIM>( *this, points, radius, 
+				offsets, neighbors, neighbor_dists, d_curve );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get the memory used by the tree in bytes.
+ *
+ * This counts the tree nodes, the index, any leaf blocks and any sorted copy
+ * of the points but not the caller's points.
+ */
+template<int DIM>
+std::size_t NanoflannTree<DIM>::usedMemory() const
+{
+    return d_tree->usedMemory() + 
+	d_permutation.size() * sizeof(unsigned) +
+	d_permuted_points.size() * sizeof(double);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Write the tree to an image file.
+ *
+ * \param filename The image file to write.
+ *
+ * The image holds a copy of the points in tree order, their ids in the
+ * original points and the tree nodes in the format of
+ * SearchTreeImageHeader. A MappedSearchTree maps the image and searches it
+ * without rebuilding the tree. Neighbors are found exactly from the image
+ * even if this tree was built with a positive eps.
+ */
+template<int DIM>
+void NanoflannTree<DIM>::writeImage( const std::string& filename ) const
+{
+    const Teuchos::Array<unsigned>& indices = d_tree->getIndices();
+    Teuchos::Array<SearchTreeImageNode> nodes;
+    d_tree->flattenIndex( nodes );
+
+    // Fill in the header.
+    SearchTreeImageHeader header;
+    std::memset( &header, 0, sizeof(header) );
+    std::strncpy( header.magic, SearchTreeImageHeader::magicString(),
+		  sizeof(header.magic) );
+    header.byte_order = SearchTreeImageHeader::byte_order_marker;
+    header.version = SearchTreeImageHeader::current_version;
+    header.dim = DIM;
+    header.num_points = indices.size();
+    header.num_nodes = nodes.size();
+    header.points_offset = SearchTreeImageHeader::align( sizeof(header) );
+    header.ids_offset = SearchTreeImageHeader::align( 
+	header.points_offset + indices.size() * DIM * sizeof(double) );
+    header.nodes_offset = SearchTreeImageHeader::align(
+	header.ids_offset + indices.size() * sizeof(std::uint32_t) );
+    header.image_size = 
+	header.nodes_offset + nodes.size() * sizeof(SearchTreeImageNode);
+    if ( !nodes.empty() )
+    {
+	d_tree->getRootBoundingBox( header.low, header.high );
+    }
+
+    // Gather the points and their original ids in tree order.
+    Teuchos::Array<double> points( indices.size() * DIM );
+    Teuchos::Array<std::uint32_t> ids( indices.size() );
+    for ( int i = 0; i < indices.size(); ++i )
+    {
+	for ( int d = 0; d < DIM; ++d )
+	{
+	    points[i*DIM + d] = d_cloud.kdtree_get_pt( indices[i], d );
+	}
+	ids[i] = d_permutation.empty() 
+		 ? indices[i] : d_permutation[ indices[i] ];
+    }
+
+    // Write the sections with zero padding between them.
+    std::ofstream image( filename.c_str(), 
+			 std::ios::out | std::ios::binary | std::ios::trunc );
+    DTK_INSIST( image.good() );
+    const char padding[SearchTreeImageHeader::alignment] = {0};
+    image.write( reinterpret_cast<const char*>(&header), sizeof(header) );
+    image.write( padding, header.points_offset - sizeof(header) );
+    image.write( reinterpret_cast<const char*>(points.getRawPtr()),
+		 points.size() * sizeof(double) );
+    image.write( padding, header.ids_offset - header.points_offset -
+		 points.size() * sizeof(double) );
+    image.write( reinterpret_cast<const char*>(ids.getRawPtr()),
+		 ids.size() * sizeof(std::uint32_t) );
+    image.write( padding, header.nodes_offset - header.ids_offset -
+		 ids.size() * sizeof(std::uint32_t) );
+    image.write( reinterpret_cast<const char*>(nodes.getRawPtr()),
+		 nodes.size() * sizeof(SearchTreeImageNode) );
+    image.close();
+    DTK_INSIST( !image.fail() );
+}
+
 //---------------------------------------------------------------------------//
 
 } // end namespace DataTransferKit
@@ -0,0 +1,263 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   tstBoundingBoxTree.cpp
+ * \author Stuart R. Slattery
+ * \brief  Bounding box tree tests.
+ */
+//---------------------------------------------------------------------------//
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <cstdlib>
+
+#include <DTK_BoundingBoxTree.hpp>
+
+#include "Teuchos_UnitTestHarness.hpp"
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_Ptr.hpp"
+#include "Teuchos_Array.hpp"
+#include "Teuchos_ArrayRCP.hpp"
+
+//---------------------------------------------------------------------------//
+// Helper functions.
+//---------------------------------------------------------------------------//
+// Build random boxes of varying size.
+void randomBoxes( const int num_boxes, const double max_size,
+		  Teuchos::Array<double>& boxes )
+{
+    boxes.resize( 6*num_boxes );
+    double low = 0.0;
+    double size = 0.0;
+    for ( int i = 0; i < num_boxes; ++i )
+    {
+	for ( int d = 0; d < 3; ++d )
+	{
+	    low = double(std::rand()) / RAND_MAX;
+	    size = max_size * double(std::rand()) / RAND_MAX;
+	    boxes[6*i+d] = low;
+	    boxes[6*i+d+3] = low + size;
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( BoundingBoxTree, dim_1_test )
+{
+    // Unit boxes centered on the integers with the unused components left
+    // empty.
+    int num_boxes = 10;
+    Teuchos::Array<double> boxes( 6*num_boxes, 0.0 );
+    for ( int i = 0; i < num_boxes; ++i )
+    {
+	boxes[6*i] = i - 0.5;
+	boxes[6*i+3] = i + 0.5;
+    }
+    DataTransferKit::BoundingBoxTree tree( 1, boxes(), 2 );
+    TEST_EQUALITY( num_boxes, tree.numBoxes() );
+
+    // Points inside one box and on the shared face of two boxes.
+    Teuchos::Array<unsigned> box_ids;
+    double p1 = 4.2;
+    tree.pointSearch( &p1, box_ids );
+    TEST_EQUALITY( 1, box_ids.size() );
+    TEST_EQUALITY( 4, box_ids[0] );
+
+    double p2 = 6.5;
+    tree.pointSearch( &p2, box_ids );
+    TEST_EQUALITY( 2, box_ids.size() );
+    TEST_EQUALITY( 6, box_ids[0] );
+    TEST_EQUALITY( 7, box_ids[1] );
+
+    double p3 = 11.0;
+    tree.pointSearch( &p3, box_ids );
+    TEST_EQUALITY( 0, box_ids.size() );
+
+    // A box over several boxes.
+    Teuchos::Array<double> box( 6, 0.0 );
+    box[0] = 0.7;
+    box[3] = 3.1;
+    tree.boxSearch( box.getRawPtr(), box_ids );
+    TEST_EQUALITY( 3, box_ids.size() );
+    TEST_EQUALITY( 1, box_ids[0] );
+    TEST_EQUALITY( 2, box_ids[1] );
+    TEST_EQUALITY( 3, box_ids[2] );
+
+    // Nearest boxes to a point outside all of them.
+    Teuchos::Array<std::pair<unsigned,double> > neighbors;
+    tree.nearestSearch( &p3, 2, neighbors );
+    TEST_EQUALITY( 2, neighbors.size() );
+    TEST_EQUALITY( 9, neighbors[0].first );
+    TEST_FLOATING_EQUALITY( 1.5*1.5, neighbors[0].second, 1.0e-12 );
+    TEST_EQUALITY( 8, neighbors[1].first );
+    TEST_FLOATING_EQUALITY( 2.5*2.5, neighbors[1].second, 1.0e-12 );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( BoundingBoxTree, batch_test )
+{
+    // The tree finds the same boxes as a linear scan in every dimension.
+    int num_boxes = 2000;
+    Teuchos::Array<double> boxes;
+    randomBoxes( num_boxes, 0.1, boxes );
+    int num_queries = 700;
+    Teuchos::Array<double> query_boxes;
+    randomBoxes( num_queries, 0.05, query_boxes );
+    Teuchos::Array<double> points( 3*num_queries );
+    for ( int n = 0; n < 3*num_queries; ++n )
+    {
+	points[n] = 1.1 * double(std::rand()) / RAND_MAX;
+    }
+
+    Teuchos::Array<std::size_t> offsets;
+    Teuchos::Array<unsigned> box_ids;
+    Teuchos::Array<double> box_dists;
+    int num_neighbors = 5;
+    for ( int dim = 1; dim < 4; ++dim )
+    {
+	DataTransferKit::BoundingBoxTree tree( dim, boxes(), 3 );
+	Teuchos::ArrayView<const double> dim_points = 
+	    points( 0, dim*num_queries );
+
+	// Point queries.
+	tree.pointSearchBatch( dim_points, offsets, box_ids );
+	TEST_EQUALITY( num_queries + 1, offsets.size() );
+	for ( int q = 0; q < num_queries; ++q )
+	{
+	    Teuchos::Array<unsigned> expected;
+	    for ( int i = 0; i < num_boxes; ++i )
+	    {
+		bool inside = true;
+		for ( int d = 0; d < dim; ++d )
+		{
+		    inside = inside && 
+			     dim_points[dim*q+d] >= boxes[6*i+d] &&
+			     dim_points[dim*q+d] <= boxes[6*i+d+3];
+		}
+		if ( inside )
+		{
+		    expected.push_back( i );
+		}
+	    }
+	    TEST_COMPARE_ARRAYS( expected(), 
+				 box_ids(offsets[q],offsets[q+1]-offsets[q]) );
+	}
+
+	// Box queries.
+	tree.boxSearchBatch( query_boxes(), offsets, box_ids );
+	TEST_EQUALITY( num_queries + 1, offsets.size() );
+	for ( int q = 0; q < num_queries; ++q )
+	{
+	    Teuchos::Array<unsigned> expected;
+	    for ( int i = 0; i < num_boxes; ++i )
+	    {
+		bool overlap = true;
+		for ( int d = 0; d < dim; ++d )
+		{
+		    overlap = overlap && 
+			      query_boxes[6*q+d] <= boxes[6*i+d+3] &&
+			      query_boxes[6*q+d+3] >= boxes[6*i+d];
+		}
+		if ( overlap )
+		{
+		    expected.push_back( i );
+		}
+	    }
+	    TEST_COMPARE_ARRAYS( expected(), 
+				 box_ids(offsets[q],offsets[q+1]-offsets[q]) );
+	}
+
+	// Nearest box queries. Compare distances as boxes containing the
+	// point are at the same distance.
+	tree.nearestSearchBatch( dim_points, num_neighbors, offsets, box_ids,
+				 Teuchos::ptrFromRef(box_dists) );
+	TEST_EQUALITY( num_queries + 1, offsets.size() );
+	TEST_EQUALITY( num_queries*num_neighbors, box_ids.size() );
+	for ( int q = 0; q < num_queries; ++q )
+	{
+	    Teuchos::Array<double> expected( num_boxes );
+	    for ( int i = 0; i < num_boxes; ++i )
+	    {
+		double dist = 0.0;
+		for ( int d = 0; d < dim; ++d )
+		{
+		    double diff = std::max( 
+			0.0, std::max(boxes[6*i+d] - dim_points[dim*q+d],
+				      dim_points[dim*q+d] - boxes[6*i+d+3]) );
+		    dist += diff*diff;
+		}
+		expected[i] = std::sqrt( dist );
+	    }
+	    std::sort( expected.begin(), expected.end() );
+	    for ( int n = 0; n < num_neighbors; ++n )
+	    {
+		TEST_FLOATING_EQUALITY( 
+		    expected[n] + 1.0, 
+		    box_dists[q*num_neighbors+n] + 1.0, 1.0e-12 );
+	    }
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( BoundingBoxTree, empty_test )
+{
+    Teuchos::Array<double> boxes;
+    DataTransferKit::BoundingBoxTree tree( 3, boxes() );
+    TEST_EQUALITY( 0, tree.numBoxes() );
+
+    Teuchos::Array<double> points( 6, 0.5 );
+    Teuchos::Array<std::size_t> offsets;
+    Teuchos::Array<unsigned> box_ids;
+    tree.pointSearchBatch( points(), offsets, box_ids );
+    TEST_EQUALITY( 3, offsets.size() );
+    TEST_EQUALITY( 0, box_ids.size() );
+    tree.boxSearchBatch( points(), offsets, box_ids );
+    TEST_EQUALITY( 2, offsets.size() );
+    TEST_EQUALITY( 0, box_ids.size() );
+    tree.nearestSearchBatch( points(), 3, offsets, box_ids );
+    TEST_EQUALITY( 3, offsets.size() );
+    TEST_EQUALITY( 0, box_ids.size() );
+}
+
+//---------------------------------------------------------------------------//
+// end tstBoundingBoxTree.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,284 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   tstDynamicSearchTree.cpp
+ * \author Stuart R. Slattery
+ * \brief  Dynamic search tree tests.
+ */
+//---------------------------------------------------------------------------//
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+#include <DTK_DynamicSearchTree.hpp>
+
+#include "Teuchos_UnitTestHarness.hpp"
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_Ptr.hpp"
+#include "Teuchos_Array.hpp"
+#include "Teuchos_ArrayRCP.hpp"
+#include "Teuchos_DefaultComm.hpp"
+#include "Teuchos_CommHelpers.hpp"
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( DynamicSearchTree, dim_1_test )
+{
+    int num_points = 10;
+    Teuchos::Array<double> coords(num_points);
+    for ( int i = 0; i < num_points; ++i )
+    {
+	coords[i] = 1.0*i;
+    }
+
+    int max_leaf_size = 3;
+    DataTransferKit::DynamicSearchTree<1> tree( coords(), max_leaf_size );
+    TEST_EQUALITY( 10, tree.numPoints() );
+
+    Teuchos::Array<double> p1( 1, 4.9 );
+    Teuchos::Array<double> p2( 1, 11.4 );
+
+    Teuchos::Array<unsigned> nnearest = tree.nnSearch( p1(), 1 );
+    TEST_EQUALITY( 1, nnearest.size() );
+    TEST_EQUALITY( 5, nnearest[0] );
+
+    nnearest = tree.nnSearch( p2(), 1 );
+    TEST_EQUALITY( 1, nnearest.size() );
+    TEST_EQUALITY( 9, nnearest[0] );
+
+    nnearest = tree.radiusSearch( p1(), 1.1 );
+    TEST_EQUALITY( 3, nnearest.size() );
+    TEST_EQUALITY( 5, nnearest[0] )
+    TEST_EQUALITY( 4, nnearest[1] )
+    TEST_EQUALITY( 6, nnearest[2] )
+
+    nnearest = tree.radiusSearch( p2(), 1.1 );
+    TEST_EQUALITY( 0, nnearest.size() );
+
+    // Insert a point near the second search point.
+    Teuchos::Array<double> p3( 1, 11.0 );
+    unsigned id = tree.insert( p3() );
+    TEST_EQUALITY( 10, id );
+    TEST_EQUALITY( 11, tree.numPoints() );
+    nnearest = tree.radiusSearch( p2(), 1.1 );
+    TEST_EQUALITY( 1, nnearest.size() );
+    TEST_EQUALITY( 10, nnearest[0] );
+
+    // Remove the nearest point to the first search point.
+    tree.remove( 5 );
+    TEST_ASSERT( !tree.isActive(5) );
+    TEST_EQUALITY( 10, tree.numPoints() );
+    nnearest = tree.nnSearch( p1(), 1 );
+    TEST_EQUALITY( 4, nnearest[0] );
+    nnearest = tree.radiusSearch( p1(), 1.1 );
+    TEST_EQUALITY( 2, nnearest.size() );
+    TEST_EQUALITY( 4, nnearest[0] )
+    TEST_EQUALITY( 6, nnearest[1] )
+
+    // Move a point next to the first search point.
+    Teuchos::Array<unsigned> ids( 1, 0 );
+    Teuchos::Array<double> p4( 1, 5.0 );
+    tree.updatePoints( ids(), p4() );
+    nnearest = tree.nnSearch( p1(), 1 );
+    TEST_EQUALITY( 0, nnearest[0] );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( DynamicSearchTree, dim_3_update_test )
+{
+    // Build a lattice of points.
+    int dim = 3;
+    int num_side = 10;
+    int num_points = num_side*num_side*num_side;
+    Teuchos::Array<double> coords( dim*num_points );
+    for ( int k = 0; k < num_side; ++k )
+    {
+	for ( int j = 0; j < num_side; ++j )
+	{
+	    for ( int i = 0; i < num_side; ++i )
+	    {
+		int n = i + j*num_side + k*num_side*num_side;
+		coords[dim*n] = 1.0*i;
+		coords[dim*n+1] = 1.0*j;
+		coords[dim*n+2] = 1.0*k;
+	    }
+	}
+    }
+
+    int max_leaf_size = 10;
+    DataTransferKit::DynamicSearchTree<3> tree( coords(), max_leaf_size );
+    TEST_EQUALITY( 0, tree.numRebuilds() );
+
+    // Shift every point by a small amount. The tree is refit without a
+    // rebuild.
+    Teuchos::Array<unsigned> ids( num_points );
+    for ( int n = 0; n < num_points; ++n )
+    {
+	ids[n] = n;
+	coords[dim*n] += 0.1;
+	coords[dim*n+1] += 0.2;
+	coords[dim*n+2] += 0.3;
+    }
+    tree.updatePoints( ids(), coords() );
+    TEST_EQUALITY( 0, tree.numRebuilds() );
+
+    // Check the searches against the moved points.
+    Teuchos::Array<double> point( dim );
+    Teuchos::Array<unsigned> neighbors;
+    for ( int n = 0; n < num_points; n += 37 )
+    {
+	point[0] = coords[dim*n];
+	point[1] = coords[dim*n+1];
+	point[2] = coords[dim*n+2];
+	neighbors = tree.nnSearch( point(), 1 );
+	TEST_EQUALITY( 1, neighbors.size() );
+	TEST_EQUALITY( Teuchos::as<unsigned>(n), neighbors[0] );
+	neighbors = tree.radiusSearch( point(), 0.5 );
+	TEST_EQUALITY( 1, neighbors.size() );
+	TEST_EQUALITY( Teuchos::as<unsigned>(n), neighbors[0] );
+    }
+
+    // Reverse the lattice. The leaf boxes are unchanged in size so the tree
+    // is refit without a rebuild but the ids now map to mirrored points.
+    for ( int n = 0; n < num_points; ++n )
+    {
+	for ( int d = 0; d < dim; ++d )
+	{
+	    coords[dim*n+d] = 10.0 - coords[dim*n+d];
+	}
+    }
+    tree.updatePoints( ids(), coords() );
+    for ( int n = 0; n < num_points; n += 37 )
+    {
+	point[0] = coords[dim*n];
+	point[1] = coords[dim*n+1];
+	point[2] = coords[dim*n+2];
+	neighbors = tree.nnSearch( point(), 1 );
+	TEST_EQUALITY( Teuchos::as<unsigned>(n), neighbors[0] );
+    }
+
+    // Scatter the points by permuting the coordinates across the lattice.
+    // The leaf boxes grow and the tree is rebuilt.
+    Teuchos::Array<double> scattered( dim*num_points );
+    for ( int n = 0; n < num_points; ++n )
+    {
+	int m = (7*n) % num_points;
+	for ( int d = 0; d < dim; ++d )
+	{
+	    scattered[dim*n+d] = coords[dim*m+d];
+	}
+    }
+    coords = scattered;
+    tree.updatePoints( ids(), coords() );
+    TEST_EQUALITY( 1, tree.numRebuilds() );
+    for ( int n = 0; n < num_points; n += 37 )
+    {
+	point[0] = coords[dim*n];
+	point[1] = coords[dim*n+1];
+	point[2] = coords[dim*n+2];
+	neighbors = tree.nnSearch( point(), 1 );
+	TEST_EQUALITY( Teuchos::as<unsigned>(n), neighbors[0] );
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( DynamicSearchTree, dim_2_insert_remove_test )
+{
+    int dim = 2;
+    Teuchos::Array<double> coords;
+    int max_leaf_size = 4;
+    DataTransferKit::DynamicSearchTree<2> tree( coords(), max_leaf_size );
+    TEST_EQUALITY( 0, tree.numPoints() );
+
+    // Grow the tree from empty.
+    int num_side = 20;
+    Teuchos::Array<double> point( dim );
+    for ( int j = 0; j < num_side; ++j )
+    {
+	for ( int i = 0; i < num_side; ++i )
+	{
+	    point[0] = 1.0*i;
+	    point[1] = 1.0*j;
+	    TEST_EQUALITY( Teuchos::as<unsigned>(i + j*num_side),
+			   tree.insert(point()) );
+	}
+    }
+    TEST_EQUALITY( Teuchos::as<std::size_t>(num_side*num_side), 
+		   tree.numPoints() );
+
+    // Check the batched searches.
+    Teuchos::Array<double> queries( dim*num_side );
+    for ( int q = 0; q < num_side; ++q )
+    {
+	queries[dim*q] = q + 0.1;
+	queries[dim*q+1] = q + 0.1;
+    }
+    Teuchos::Array<std::size_t> offsets;
+    Teuchos::Array<unsigned> neighbors;
+    Teuchos::Array<double> dists;
+    tree.nnSearchBatch( queries(), 1, offsets, neighbors, 
+			Teuchos::ptrFromRef(dists) );
+    for ( int q = 0; q < num_side; ++q )
+    {
+	TEST_EQUALITY( Teuchos::as<unsigned>(q + q*num_side), neighbors[q] );
+	TEST_FLOATING_EQUALITY( dists[q], std::sqrt(0.02), 1.0e-12 );
+    }
+    tree.radiusSearchBatch( queries(), 1.0, offsets, neighbors );
+    TEST_EQUALITY( Teuchos::as<std::size_t>(num_side+1), offsets.size() );
+    TEST_EQUALITY( 3, Teuchos::as<int>(offsets[1] - offsets[0]) );
+    TEST_EQUALITY( 0, neighbors[0] );
+
+    // Remove the diagonal.
+    for ( int q = 0; q < num_side; ++q )
+    {
+	tree.remove( q + q*num_side );
+    }
+    tree.nnSearchBatch( queries(), 1, offsets, neighbors, 
+			Teuchos::ptrFromRef(dists) );
+    for ( int q = 0; q < num_side - 1; ++q )
+    {
+	TEST_ASSERT( !tree.isActive(q + q*num_side) );
+	TEST_INEQUALITY( Teuchos::as<unsigned>(q + q*num_side), 
+			 neighbors[q] );
+	TEST_FLOATING_EQUALITY( dists[q], std::sqrt(0.82), 1.0e-12 );
+    }
+}
+
+//---------------------------------------------------------------------------//
+// end tstDynamicSearchTree.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,366 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   tstMappedSearchTree.cpp
+ * \author Stuart R. Slattery
+ * \brief  Search tree image tests.
+ */
+//---------------------------------------------------------------------------//
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <stdexcept>
+#include <cstdlib>
+
+#include <DTK_MappedSearchTree.hpp>
+#include <DTK_StaticSearchTree.hpp>
+#include <DTK_SearchTreeFactory.hpp>
+#include <DTK_SearchTreeImage.hpp>
+#include <DTK_DBC.hpp>
+
+#include "Teuchos_UnitTestHarness.hpp"
+#include "Teuchos_DefaultComm.hpp"
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_Ptr.hpp"
+#include "Teuchos_Array.hpp"
+#include "Teuchos_ArrayRCP.hpp"
+
+//---------------------------------------------------------------------------//
+// Helper functions.
+//---------------------------------------------------------------------------//
+// Get an image file name unique to this process.
+std::string imageFilename( const std::string& name )
+{
+    std::stringstream filename;
+    filename << name << "_" 
+	     << Teuchos::DefaultComm<int>::getComm()->getRank() << ".dtktree";
+    return filename.str();
+}
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( MappedSearchTree, dim_1_test )
+{
+    int num_points = 10;
+    Teuchos::Array<double> coords( num_points );
+    for ( int i = 0; i < num_points; ++i )
+    {
+	coords[i] = 1.0*i;
+    }
+
+    int max_leaf_size = 3;
+    std::string filename = imageFilename( "mapped_dim_1" );
+    {
+	DataTransferKit::NanoflannTree<1> tree( coords(), max_leaf_size );
+	tree.writeImage( filename );
+    }
+    DataTransferKit::MappedSearchTree<1> tree( filename );
+    TEST_EQUALITY( 10, tree.numPoints() );
+
+    Teuchos::Array<double> p1( 1, 4.9 );
+    Teuchos::Array<double> p2( 1, 11.4 );
+
+    Teuchos::Array<unsigned> nnearest = tree.nnSearch( p1(), 1 );
+    TEST_EQUALITY( 1, nnearest.size() );
+    TEST_EQUALITY( 5, nnearest[0] );
+
+    nnearest = tree.nnSearch( p2(), 1 );
+    TEST_EQUALITY( 1, nnearest.size() );
+    TEST_EQUALITY( 9, nnearest[0] );
+
+    nnearest = tree.radiusSearch( p1(), 1.1 );
+    TEST_EQUALITY( 3, nnearest.size() );
+    TEST_EQUALITY( 5, nnearest[0] )
+    TEST_EQUALITY( 4, nnearest[1] )
+    TEST_EQUALITY( 6, nnearest[2] )
+
+    nnearest = tree.radiusSearch( p2(), 1.1 );
+    TEST_EQUALITY( 0, nnearest.size() );
+
+    std::remove( filename.c_str() );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( MappedSearchTree, factory_test )
+{
+    // Build an irregular cloud.
+    int num_points = 10000;
+    Teuchos::Array<double> coords( 3*num_points );
+    for ( int n = 0; n < coords.size(); ++n )
+    {
+	coords[n] = double(std::rand()) / RAND_MAX;
+    }
+    Teuchos::Array<double> queries( coords(0,3*500) );
+    for ( int n = 0; n < queries.size(); ++n )
+    {
+	queries[n] += 0.001;
+    }
+
+    // Trees mapped from images find the same neighbors with the same
+    // distances as the trees that wrote them, including trees with sorted
+    // points.
+    Teuchos::Array<std::size_t> offsets;
+    Teuchos::Array<unsigned> neighbors;
+    Teuchos::Array<double> dists;
+    Teuchos::Array<std::size_t> mapped_offsets;
+    Teuchos::Array<unsigned> mapped_neighbors;
+    Teuchos::Array<double> mapped_dists;
+    int max_leaf_size = 10;
+    for ( int dim = 1; dim < 4; ++dim )
+    {
+	Teuchos::ArrayView<const double> points = 
+	    coords( 0, dim*(3*num_points/dim) );
+	Teuchos::ArrayView<const double> dim_queries = 
+	    queries( 0, dim*(queries.size()/dim) );
+
+	for ( int sorted = 0; sorted < 2; ++sorted )
+	{
+	    DataTransferKit::SpaceFillingCurve::CurveType curve = sorted
+		? DataTransferKit::SpaceFillingCurve::HILBERT
+		: DataTransferKit::SpaceFillingCurve::NONE;
+	    Teuchos::RCP<DataTransferKit::StaticSearchTree> tree =
+		DataTransferKit::SearchTreeFactory::createStaticTree(
+		    dim, points, max_leaf_size, false, curve );
+
+	    std::string filename = imageFilename( "mapped_factory" );
+	    switch ( dim )
+	    {
+		case 1:
+		    Teuchos::rcp_dynamic_cast<
+			DataTransferKit::NanoflannTree<1> >(
+			    tree)->writeImage( filename );
+		    break;
+		case 2:
+		    Teuchos::rcp_dynamic_cast<
+			DataTransferKit::NanoflannTree<2> >(
+			    tree)->writeImage( filename );
+		    break;
+		case 3:
+		    Teuchos::rcp_dynamic_cast<
+			DataTransferKit::NanoflannTree<3> >(
+			    tree)->writeImage( filename );
+		    break;
+	    }
+	    Teuchos::RCP<DataTransferKit::StaticSearchTree> mapped_tree =
+		DataTransferKit::SearchTreeFactory::createMappedTree( 
+		    filename );
+
+	    tree->nnSearchBatch( dim_queries, 8, offsets, neighbors, 
+				 Teuchos::ptrFromRef(dists) );
+	    mapped_tree->nnSearchBatch( 
+		dim_queries, 8, mapped_offsets, mapped_neighbors, 
+		Teuchos::ptrFromRef(mapped_dists) );
+	    TEST_COMPARE_ARRAYS( offsets, mapped_offsets );
+	    TEST_COMPARE_ARRAYS( neighbors, mapped_neighbors );
+	    TEST_COMPARE_ARRAYS( dists, mapped_dists );
+
+	    tree->radiusSearchBatch( 
+		dim_queries, 0.05, offsets, neighbors, 
+		Teuchos::ptrFromRef(dists) );
+	    mapped_tree->radiusSearchBatch( 
+		dim_queries, 0.05, mapped_offsets, mapped_neighbors, 
+		Teuchos::ptrFromRef(mapped_dists) );
+	    TEST_COMPARE_ARRAYS( offsets, mapped_offsets );
+	    TEST_COMPARE_ARRAYS( neighbors, mapped_neighbors );
+	    TEST_COMPARE_ARRAYS( dists, mapped_dists );
+
+	    std::remove( filename.c_str() );
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( MappedSearchTree, memory_test )
+{
+    int num_side = 20;
+    Teuchos::Array<double> coords( 2*num_side*num_side );
+    for ( int j = 0; j < num_side; ++j )
+    {
+	for ( int i = 0; i < num_side; ++i )
+	{
+	    coords[ 2*(j*num_side + i) ] = 1.0*i;
+	    coords[ 2*(j*num_side + i) + 1 ] = 1.0*j;
+	}
+    }
+    int max_leaf_size = 4;
+    DataTransferKit::NanoflannTree<2> tree( coords(), max_leaf_size );
+    std::string filename = imageFilename( "mapped_memory" );
+    tree.writeImage( filename );
+
+    // Read the image into a buffer of doubles so it is aligned.
+    std::ifstream image_file( 
+	filename.c_str(), std::ios::in | std::ios::binary | std::ios::ate );
+    std::size_t image_size = image_file.tellg();
+    image_file.seekg( 0 );
+    Teuchos::Array<double> buffer( image_size / sizeof(double) + 1 );
+    image_file.read( reinterpret_cast<char*>(buffer.getRawPtr()), 
+		     image_size );
+    TEST_ASSERT( image_file.good() );
+    image_file.close();
+    std::remove( filename.c_str() );
+
+    Teuchos::ArrayView<const char> image( 
+	reinterpret_cast<const char*>(buffer.getRawPtr()), image_size );
+    DataTransferKit::MappedSearchTree<2> mapped_tree( image );
+    TEST_EQUALITY( num_side*num_side, mapped_tree.numPoints() );
+
+    for ( int q = 0; q < num_side*num_side; ++q )
+    {
+	Teuchos::Array<double> point( coords(2*q,2) );
+	point[0] += 0.1;
+	point[1] += 0.2;
+	Teuchos::Array<unsigned> nearest = mapped_tree.nnSearch( point(), 1 );
+	TEST_EQUALITY( 1, nearest.size() );
+	TEST_EQUALITY( Teuchos::as<unsigned>(q), nearest[0] );
+
+	Teuchos::Array<unsigned> mapped_neighbors = 
+	    mapped_tree.radiusSearch( point(), 1.5 );
+	Teuchos::Array<unsigned> neighbors = tree.radiusSearch( point(), 1.5 );
+	TEST_COMPARE_ARRAYS( neighbors, mapped_neighbors );
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( MappedSearchTree, bad_image_test )
+{
+    int num_points = 100;
+    Teuchos::Array<double> coords( 2*num_points );
+    for ( int i = 0; i < 2*num_points; ++i )
+    {
+	coords[i] = 0.5*i;
+    }
+    DataTransferKit::NanoflannTree<2> tree( coords(), 4 );
+    std::string filename = imageFilename( "mapped_bad" );
+    tree.writeImage( filename );
+
+    // Read the image into a buffer of doubles so it is aligned.
+    std::ifstream image_file( 
+	filename.c_str(), std::ios::in | std::ios::binary | std::ios::ate );
+    std::size_t image_size = image_file.tellg();
+    image_file.seekg( 0 );
+    Teuchos::Array<double> buffer( image_size / sizeof(double) + 1 );
+    image_file.read( reinterpret_cast<char*>(buffer.getRawPtr()), 
+		     image_size );
+    TEST_ASSERT( image_file.good() );
+    image_file.close();
+    std::remove( filename.c_str() );
+    const char* image = reinterpret_cast<const char*>( buffer.getRawPtr() );
+
+    // The intact image loads.
+    DataTransferKit::MappedSearchTree<2> mapped_tree( 
+	Teuchos::ArrayView<const char>(image, image_size) );
+    TEST_EQUALITY( num_points, mapped_tree.numPoints() );
+
+    // Images with a different dimension are rejected.
+    TEST_THROW( DataTransferKit::MappedSearchTree<3>( 
+		    Teuchos::ArrayView<const char>(image, image_size) ),
+		DataTransferKit::Assertion );
+
+    // Truncated images are rejected.
+    TEST_THROW( DataTransferKit::MappedSearchTree<2>( 
+		    Teuchos::ArrayView<const char>(image, image_size - 8) ),
+		DataTransferKit::Assertion );
+
+    // Headers with more points than the image holds are rejected.
+    Teuchos::Array<double> bad_buffer( buffer );
+    DataTransferKit::SearchTreeImageHeader* header = 
+	reinterpret_cast<DataTransferKit::SearchTreeImageHeader*>( 
+	    bad_buffer.getRawPtr() );
+    const char* bad_image = 
+	reinterpret_cast<const char*>( bad_buffer.getRawPtr() );
+    header->num_points *= 100;
+    TEST_THROW( DataTransferKit::MappedSearchTree<2>( 
+		    Teuchos::ArrayView<const char>(bad_image, image_size) ),
+		DataTransferKit::Assertion );
+
+    // Nodes pointing outside of the tree are rejected.
+    bad_buffer = buffer;
+    header = reinterpret_cast<DataTransferKit::SearchTreeImageHeader*>( 
+	bad_buffer.getRawPtr() );
+    bad_image = reinterpret_cast<const char*>( bad_buffer.getRawPtr() );
+    DataTransferKit::SearchTreeImageNode* nodes = 
+	reinterpret_cast<DataTransferKit::SearchTreeImageNode*>( 
+	    bad_buffer.getRawPtr() + header->nodes_offset / sizeof(double) );
+    TEST_INEQUALITY( -1, nodes[0].child1 );
+    nodes[0].child2 = header->num_nodes;
+    TEST_THROW( DataTransferKit::MappedSearchTree<2>( 
+		    Teuchos::ArrayView<const char>(bad_image, image_size) ),
+		DataTransferKit::Assertion );
+
+    // Leaves with points outside of the image are rejected.
+    bad_buffer = buffer;
+    header = reinterpret_cast<DataTransferKit::SearchTreeImageHeader*>( 
+	bad_buffer.getRawPtr() );
+    bad_image = reinterpret_cast<const char*>( bad_buffer.getRawPtr() );
+    nodes = reinterpret_cast<DataTransferKit::SearchTreeImageNode*>( 
+	bad_buffer.getRawPtr() + header->nodes_offset / sizeof(double) );
+    nodes[ header->num_nodes - 1 ].right = header->num_points + 1;
+    TEST_THROW( DataTransferKit::MappedSearchTree<2>( 
+		    Teuchos::ArrayView<const char>(bad_image, image_size) ),
+		DataTransferKit::Assertion );
+
+    // Trees with points but no nodes are rejected.
+    bad_buffer = buffer;
+    header = reinterpret_cast<DataTransferKit::SearchTreeImageHeader*>( 
+	bad_buffer.getRawPtr() );
+    bad_image = reinterpret_cast<const char*>( bad_buffer.getRawPtr() );
+    header->num_nodes = 0;
+    TEST_THROW( DataTransferKit::MappedSearchTree<2>( 
+		    Teuchos::ArrayView<const char>(bad_image, image_size) ),
+		DataTransferKit::Assertion );
+
+    // Bad image files and files too small to hold a header are rejected.
+    std::ofstream bad_file( 
+	filename.c_str(), std::ios::out | std::ios::binary );
+    bad_file.write( bad_image, image_size );
+    bad_file.close();
+    TEST_THROW( DataTransferKit::MappedSearchTree<2> bad_tree( filename ),
+		DataTransferKit::Assertion );
+    bad_file.open( filename.c_str(), std::ios::out | std::ios::binary );
+    bad_file.write( bad_image, 8 );
+    bad_file.close();
+    TEST_THROW( DataTransferKit::MappedSearchTree<2> bad_tree( filename ),
+		DataTransferKit::Assertion );
+    std::remove( filename.c_str() );
+}
+
+//---------------------------------------------------------------------------//
+// end tstMappedSearchTree.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,217 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   tstSpaceFillingCurve.cpp
+ * \author Stuart R. Slattery
+ * \brief  Space-filling curve tests.
+ */
+//---------------------------------------------------------------------------//
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+
+#include <DTK_SpaceFillingCurve.hpp>
+
+#include "Teuchos_UnitTestHarness.hpp"
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_Array.hpp"
+#include "Teuchos_ArrayView.hpp"
+
+//---------------------------------------------------------------------------//
+// HELPER FUNCTIONS
+//---------------------------------------------------------------------------//
+
+// Build a lattice of points in reverse order with num_side points per
+// dimension. An extra point is added at the far corner so the lattice lines
+// up with the curve cells.
+Teuchos::Array<double> buildLattice( const int dim, const int num_side )
+{
+    int num_points = 1;
+    for ( int d = 0; d < dim; ++d )
+    {
+	num_points *= num_side;
+    }
+    Teuchos::Array<double> points( dim*(num_points+1), 1.0*num_side );
+    int index = 0;
+    for ( int n = 0; n < num_points; ++n )
+    {
+	index = num_points - n - 1;
+	for ( int d = 0; d < dim; ++d )
+	{
+	    points[dim*n+d] = index % num_side;
+	    index /= num_side;
+	}
+    }
+    return points;
+}
+
+//---------------------------------------------------------------------------//
+// Check that the permutation is a permutation.
+bool isPermutation( const Teuchos::Array<unsigned>& permutation )
+{
+    Teuchos::Array<unsigned> sorted( permutation );
+    std::sort( sorted.begin(), sorted.end() );
+    bool is_permutation = true;
+    for ( int i = 0; i < sorted.size(); ++i )
+    {
+	is_permutation = 
+	    is_permutation && ( Teuchos::as<unsigned>(i) == sorted[i] );
+    }
+    return is_permutation;
+}
+
+//---------------------------------------------------------------------------//
+// Get the largest lattice step between consecutive lattice points in the
+// permuted order. The far corner point is skipped.
+double maxStep( const int dim,
+		const Teuchos::Array<double>& points,
+		const Teuchos::Array<unsigned>& permutation )
+{
+    unsigned corner = permutation.size() - 1;
+    double max_step = 0.0;
+    double step = 0.0;
+    int prev = -1;
+    for ( int i = 0; i < permutation.size(); ++i )
+    {
+	if ( corner != permutation[i] )
+	{
+	    if ( prev >= 0 )
+	    {
+		step = 0.0;
+		for ( int d = 0; d < dim; ++d )
+		{
+		    step += std::abs( points[dim*permutation[i]+d] - 
+				      points[dim*prev+d] );
+		}
+		max_step = std::max( max_step, step );
+	    }
+	    prev = permutation[i];
+	}
+    }
+    return max_step;
+}
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( SpaceFillingCurve, curve_type_test )
+{
+    using DataTransferKit::SpaceFillingCurve;
+    TEST_EQUALITY( SpaceFillingCurve::NONE, 
+		   SpaceFillingCurve::curveType("None") );
+    TEST_EQUALITY( SpaceFillingCurve::MORTON, 
+		   SpaceFillingCurve::curveType("Morton") );
+    TEST_EQUALITY( SpaceFillingCurve::HILBERT, 
+		   SpaceFillingCurve::curveType("Hilbert") );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( SpaceFillingCurve, none_test )
+{
+    using DataTransferKit::SpaceFillingCurve;
+    Teuchos::Array<double> points = buildLattice( 2, 4 );
+    Teuchos::Array<unsigned> permutation;
+    SpaceFillingCurve::sortPermutation( 
+	2, points(), SpaceFillingCurve::NONE, permutation );
+    TEST_EQUALITY( points.size() / 2, permutation.size() );
+    for ( int i = 0; i < permutation.size(); ++i )
+    {
+	TEST_EQUALITY( Teuchos::as<unsigned>(i), permutation[i] );
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( SpaceFillingCurve, morton_test )
+{
+    using DataTransferKit::SpaceFillingCurve;
+
+    // The first 2x2 block of a 2D lattice is visited before the rest in
+    // Z order.
+    int dim = 2;
+    Teuchos::Array<double> points = buildLattice( dim, 4 );
+    Teuchos::Array<unsigned> permutation;
+    SpaceFillingCurve::sortPermutation( 
+	dim, points(), SpaceFillingCurve::MORTON, permutation );
+    TEST_ASSERT( isPermutation(permutation) );
+    Teuchos::Array<double> sorted;
+    SpaceFillingCurve::permutePoints( dim, points(), permutation(), sorted );
+    TEST_EQUALITY( points.size(), sorted.size() );
+    double z_order[8] = { 0.0, 0.0, 0.0, 1.0, 1.0, 0.0, 1.0, 1.0 };
+    for ( int i = 0; i < 8; ++i )
+    {
+	TEST_EQUALITY( z_order[i], sorted[i] );
+    }
+
+    // Every point keeps its coordinates.
+    for ( int i = 0; i < permutation.size(); ++i )
+    {
+	for ( int d = 0; d < dim; ++d )
+	{
+	    TEST_EQUALITY( points[dim*permutation[i]+d], sorted[dim*i+d] );
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( SpaceFillingCurve, hilbert_test )
+{
+    using DataTransferKit::SpaceFillingCurve;
+
+    // Consecutive lattice points on a Hilbert curve are lattice neighbors
+    // in every dimension.
+    for ( int dim = 1; dim < 4; ++dim )
+    {
+	Teuchos::Array<double> points = buildLattice( dim, 8 );
+	Teuchos::Array<unsigned> permutation;
+	SpaceFillingCurve::sortPermutation( 
+	    dim, points(), SpaceFillingCurve::HILBERT, permutation );
+	TEST_ASSERT( isPermutation(permutation) );
+	TEST_EQUALITY( 1.0, maxStep(dim,points,permutation) );
+    }
+
+    // The Morton curve jumps between blocks.
+    Teuchos::Array<double> points = buildLattice( 3, 8 );
+    Teuchos::Array<unsigned> permutation;
+    SpaceFillingCurve::sortPermutation( 
+	3, points(), SpaceFillingCurve::MORTON, permutation );
+    TEST_ASSERT( maxStep(3,points,permutation) > 1.0 );
+}
+
+//---------------------------------------------------------------------------//
+// end tstSpaceFillingCurve.cpp
+//---------------------------------------------------------------------------//
@@ -43,6 +43,7 @@
 #include <cmath>
 #include <sstream>
 #include <stdexcept>
+#include <cstdlib>
 
 #include <DTK_StaticSearchTree.hpp>
 #include <DTK_SearchTreeFactory.hpp>
@@ -69,6 +70,18 @@ Teuchos::RCP<const Teuchos::Comm<int> > getDefaultComm()
 #endif
 }
 
+//---------------------------------------------------------------------------//
+// Fill an irregular cloud of random values in [0,1].
+Teuchos::Array<double> randomCloud( const int num_values )
+{
+    Teuchos::Array<double> values( num_values );
+    for ( int n = 0; n < num_values; ++n )
+    {
+	values[n] = double(std::rand()) / RAND_MAX;
+    }
+    return values;
+}
+
 //---------------------------------------------------------------------------//
 // Tests.
 //---------------------------------------------------------------------------//
@@ -377,6 +390,320 @@ TEUCHOS_UNIT_TEST( NanoflannTree, dim_3_factory_test )
     TEST_EQUALITY( 9, nnearest[0] )
 }
 
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( NanoflannTree, batch_test )
+{
+    int dim = 2;
+    int num_side = 20;
+    int num_points = num_side*num_side;
+    Teuchos::Array<double> coords( dim*num_points );
+    for ( int j = 0; j < num_side; ++j )
+    {
+	for ( int i = 0; i < num_side; ++i )
+	{
+	    coords[dim*(j*num_side+i)] = 1.0*i;
+	    coords[dim*(j*num_side+i)+1] = 1.0*j;
+	}
+    }
+
+    int max_leaf_size = 10;
+    Teuchos::RCP<DataTransferKit::StaticSearchTree> tree =
+	DataTransferKit::SearchTreeFactory::createStaticTree(
+	    2, coords(), max_leaf_size );
+
+    // Use enough query points to span several thread blocks.
+    int num_queries = 1000;
+    Teuchos::Array<double> queries( dim*num_queries );
+    for ( int q = 0; q < num_queries; ++q )
+    {
+	queries[dim*q] = 0.0191*q;
+	queries[dim*q+1] = 19.0 - 0.0173*q;
+    }
+
+    // Compare the batched searches to the single point searches.
+    Teuchos::Array<std::size_t> offsets;
+    Teuchos::Array<unsigned> neighbors;
+    Teuchos::Array<double> dists;
+    Teuchos::Array<unsigned> single;
+    double dx = 0.0;
+    double dy = 0.0;
+
+    double radius = 1.6;
+    tree->radiusSearchBatch( queries(), radius, offsets, neighbors, 
+			     Teuchos::ptrFromRef(dists) );
+    TEST_EQUALITY( num_queries + 1, offsets.size() );
+    TEST_EQUALITY( 0, offsets[0] );
+    TEST_EQUALITY( offsets.back(), neighbors.size() );
+    TEST_EQUALITY( neighbors.size(), dists.size() );
+    for ( int q = 0; q < num_queries; ++q )
+    {
+	single = tree->radiusSearch( queries(dim*q,dim), radius );
+	TEST_EQUALITY( single.size(), 
+		       Teuchos::as<int>(offsets[q+1] - offsets[q]) );
+	for ( int n = 0; n < single.size(); ++n )
+	{
+	    TEST_EQUALITY( single[n], neighbors[offsets[q]+n] );
+	    dx = queries[dim*q] - coords[dim*single[n]];
+	    dy = queries[dim*q+1] - coords[dim*single[n]+1];
+	    TEST_FLOATING_EQUALITY( 
+		std::sqrt(dx*dx+dy*dy), dists[offsets[q]+n], 1.0e-12 );
+	}
+    }
+
+    // Search again without distances reusing the output arrays.
+    Teuchos::Array<unsigned> with_dists( neighbors );
+    tree->radiusSearchBatch( queries(), radius, offsets, neighbors );
+    TEST_COMPARE_ARRAYS( with_dists, neighbors );
+
+    unsigned num_neighbors = 5;
+    tree->nnSearchBatch( queries(), num_neighbors, offsets, neighbors, 
+			 Teuchos::ptrFromRef(dists) );
+    TEST_EQUALITY( num_queries + 1, offsets.size() );
+    TEST_EQUALITY( num_queries*num_neighbors, neighbors.size() );
+    TEST_EQUALITY( num_queries*num_neighbors, dists.size() );
+    for ( int q = 0; q < num_queries; ++q )
+    {
+	TEST_EQUALITY( q*num_neighbors, offsets[q] );
+	single = tree->nnSearch( queries(dim*q,dim), num_neighbors );
+	for ( unsigned n = 0; n < num_neighbors; ++n )
+	{
+	    dx = queries[dim*q] - coords[dim*single[n]];
+	    dy = queries[dim*q+1] - coords[dim*single[n]+1];
+	    TEST_FLOATING_EQUALITY( 
+		std::sqrt(dx*dx+dy*dy), dists[offsets[q]+n], 1.0e-12 );
+	}
+    }
+
+    // Asking for more neighbors than points finds all points.
+    tree->nnSearchBatch( queries(0,2*dim), num_points + 10, 
+			 offsets, neighbors );
+    TEST_EQUALITY( 3, offsets.size() );
+    TEST_EQUALITY( Teuchos::as<std::size_t>(num_points), offsets[1] );
+    TEST_EQUALITY( 2*num_points, neighbors.size() );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( NanoflannTree, parallel_build_test )
+{
+    // Build an irregular cloud.
+    int dim = 3;
+    int num_points = 20000;
+    Teuchos::Array<double> coords = randomCloud( dim*num_points );
+
+    int max_leaf_size = 10;
+    Teuchos::RCP<DataTransferKit::StaticSearchTree> serial_tree =
+	DataTransferKit::SearchTreeFactory::createStaticTree(
+	    3, coords(), max_leaf_size, false );
+    Teuchos::RCP<DataTransferKit::StaticSearchTree> parallel_tree =
+	DataTransferKit::SearchTreeFactory::createStaticTree(
+	    3, coords(), max_leaf_size, true );
+
+    // The trees are identical so the searches give the same results in the
+    // same order.
+    Teuchos::Array<double> queries( coords(0,dim*1000) );
+    Teuchos::Array<std::size_t> serial_offsets;
+    Teuchos::Array<unsigned> serial_neighbors;
+    Teuchos::Array<std::size_t> parallel_offsets;
+    Teuchos::Array<unsigned> parallel_neighbors;
+
+    serial_tree->nnSearchBatch( 
+	queries(), 8, serial_offsets, serial_neighbors );
+    parallel_tree->nnSearchBatch( 
+	queries(), 8, parallel_offsets, parallel_neighbors );
+    TEST_COMPARE_ARRAYS( serial_offsets, parallel_offsets );
+    TEST_COMPARE_ARRAYS( serial_neighbors, parallel_neighbors );
+
+    serial_tree->radiusSearchBatch( 
+	queries(), 0.05, serial_offsets, serial_neighbors );
+    parallel_tree->radiusSearchBatch( 
+	queries(), 0.05, parallel_offsets, parallel_neighbors );
+    TEST_COMPARE_ARRAYS( serial_offsets, parallel_offsets );
+    TEST_COMPARE_ARRAYS( serial_neighbors, parallel_neighbors );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( NanoflannTree, curve_test )
+{
+    // Build an irregular cloud.
+    int dim = 3;
+    int num_points = 5000;
+    Teuchos::Array<double> coords = randomCloud( dim*num_points );
+
+    int max_leaf_size = 10;
+    Teuchos::RCP<DataTransferKit::StaticSearchTree> tree =
+	DataTransferKit::SearchTreeFactory::createStaticTree(
+	    3, coords(), max_leaf_size );
+
+    // Query enough points that the batches are sorted.
+    int num_queries = 1000;
+    Teuchos::Array<double> queries = randomCloud( dim*num_queries );
+    Teuchos::Array<std::size_t> offsets;
+    Teuchos::Array<unsigned> neighbors;
+    Teuchos::Array<double> dists;
+    tree->nnSearchBatch( queries(), 8, offsets, neighbors, 
+			 Teuchos::ptrFromRef(dists) );
+    Teuchos::Array<std::size_t> radius_offsets;
+    Teuchos::Array<unsigned> radius_neighbors;
+    tree->radiusSearchBatch( queries(), 0.1, radius_offsets, radius_neighbors );
+
+    // Trees sorted along a curve find the same neighbors in terms of the
+    // original point ids.
+    DataTransferKit::SpaceFillingCurve::CurveType curves[2] = 
+	{ DataTransferKit::SpaceFillingCurve::MORTON,
+	  DataTransferKit::SpaceFillingCurve::HILBERT };
+    Teuchos::Array<std::size_t> curve_offsets;
+    Teuchos::Array<unsigned> curve_neighbors;
+    Teuchos::Array<double> curve_dists;
+    Teuchos::Array<unsigned> single;
+    for ( int c = 0; c < 2; ++c )
+    {
+	Teuchos::RCP<DataTransferKit::StaticSearchTree> curve_tree =
+	    DataTransferKit::SearchTreeFactory::createStaticTree(
+		3, coords(), max_leaf_size, false, curves[c] );
+
+	curve_tree->nnSearchBatch( queries(), 8, curve_offsets, 
+				   curve_neighbors, 
+				   Teuchos::ptrFromRef(curve_dists) );
+	TEST_COMPARE_ARRAYS( offsets, curve_offsets );
+	TEST_COMPARE_ARRAYS( neighbors, curve_neighbors );
+	TEST_COMPARE_FLOATING_ARRAYS( dists, curve_dists, 1.0e-12 );
+
+	curve_tree->radiusSearchBatch( 
+	    queries(), 0.1, curve_offsets, curve_neighbors );
+	TEST_COMPARE_ARRAYS( radius_offsets, curve_offsets );
+	TEST_COMPARE_ARRAYS( radius_neighbors, curve_neighbors );
+
+	for ( int q = 0; q < num_queries; q += 97 )
+	{
+	    single = curve_tree->nnSearch( queries(dim*q,dim), 8 );
+	    TEST_COMPARE_ARRAYS( single(), neighbors(offsets[q],8) );
+	    single = curve_tree->radiusSearch( queries(dim*q,dim), 0.1 );
+	    TEST_COMPARE_ARRAYS( 
+		single(), 
+		radius_neighbors(radius_offsets[q],
+				 radius_offsets[q+1]-radius_offsets[q]) );
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( NanoflannTree, leaf_blocks_test )
+{
+    // Build an irregular cloud.
+    int num_points = 5000;
+    Teuchos::Array<double> coords = randomCloud( 3*num_points );
+
+    // Trees with leaf blocks compute the same distances and so find the
+    // same neighbors in every dimension. Use a leaf larger than a distance
+    // block.
+    Teuchos::Array<std::size_t> offsets;
+    Teuchos::Array<unsigned> neighbors;
+    Teuchos::Array<double> dists;
+    Teuchos::Array<std::size_t> block_offsets;
+    Teuchos::Array<unsigned> block_neighbors;
+    Teuchos::Array<double> block_dists;
+    for ( int dim = 1; dim < 4; ++dim )
+    {
+	Teuchos::ArrayView<const double> points = 
+	    coords( 0, dim*(3*num_points/dim) );
+	Teuchos::ArrayView<const double> queries = points( 0, dim*500 );
+	for ( int leaf_size = 10; leaf_size < 200; leaf_size += 90 )
+	{
+	    Teuchos::RCP<DataTransferKit::StaticSearchTree> tree =
+		DataTransferKit::SearchTreeFactory::createStaticTree(
+		    dim, points, leaf_size );
+	    Teuchos::RCP<DataTransferKit::StaticSearchTree> block_tree =
+		DataTransferKit::SearchTreeFactory::createStaticTree(
+		    dim, points, leaf_size, false,
+		    DataTransferKit::SpaceFillingCurve::NONE, true );
+
+	    tree->nnSearchBatch( 
+		queries, 8, offsets, neighbors, Teuchos::ptrFromRef(dists) );
+	    block_tree->nnSearchBatch( queries, 8, block_offsets, 
+				       block_neighbors, 
+				       Teuchos::ptrFromRef(block_dists) );
+	    TEST_COMPARE_ARRAYS( offsets, block_offsets );
+	    TEST_COMPARE_ARRAYS( neighbors, block_neighbors );
+	    TEST_COMPARE_ARRAYS( dists, block_dists );
+
+	    tree->radiusSearchBatch( 
+		queries, 0.05, offsets, neighbors, Teuchos::ptrFromRef(dists) );
+	    block_tree->radiusSearchBatch( queries, 0.05, block_offsets, 
+					   block_neighbors, 
+					   Teuchos::ptrFromRef(block_dists) );
+	    TEST_COMPARE_ARRAYS( offsets, block_offsets );
+	    TEST_COMPARE_ARRAYS( neighbors, block_neighbors );
+	    TEST_COMPARE_ARRAYS( dists, block_dists );
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( NanoflannTree, approximate_test )
+{
+    // Build an irregular cloud.
+    int dim = 3;
+    int num_points = 20000;
+    Teuchos::Array<double> coords = randomCloud( dim*num_points );
+    int num_queries = 500;
+    Teuchos::Array<double> queries = randomCloud( dim*num_queries );
+
+    int max_leaf_size = 10;
+    unsigned num_neighbors = 10;
+    Teuchos::RCP<DataTransferKit::StaticSearchTree> tree =
+	DataTransferKit::SearchTreeFactory::createStaticTree(
+	    dim, coords(), max_leaf_size );
+    Teuchos::Array<std::size_t> offsets;
+    Teuchos::Array<unsigned> neighbors;
+    Teuchos::Array<double> dists;
+    tree->nnSearchBatch( queries(), num_neighbors, offsets, neighbors, 
+			 Teuchos::ptrFromRef(dists) );
+
+    // A zero tolerance is exact.
+    Teuchos::Array<std::size_t> approx_offsets;
+    Teuchos::Array<unsigned> approx_neighbors;
+    Teuchos::Array<double> approx_dists;
+    Teuchos::RCP<DataTransferKit::StaticSearchTree> exact_tree =
+	DataTransferKit::SearchTreeFactory::createStaticTree(
+	    dim, coords(), max_leaf_size, false,
+	    DataTransferKit::SpaceFillingCurve::NONE, false, 0.0 );
+    exact_tree->nnSearchBatch( queries(), num_neighbors, approx_offsets, 
+			       approx_neighbors, 
+			       Teuchos::ptrFromRef(approx_dists) );
+    TEST_COMPARE_ARRAYS( neighbors, approx_neighbors );
+
+    // Approximate neighbors are within the tolerance of the exact ones.
+    double eps = 0.5;
+    Teuchos::RCP<DataTransferKit::StaticSearchTree> approx_tree =
+	DataTransferKit::SearchTreeFactory::createStaticTree(
+	    dim, coords(), max_leaf_size, false,
+	    DataTransferKit::SpaceFillingCurve::NONE, false, eps );
+    approx_tree->nnSearchBatch( queries(), num_neighbors, approx_offsets, 
+				approx_neighbors, 
+				Teuchos::ptrFromRef(approx_dists) );
+    TEST_COMPARE_ARRAYS( offsets, approx_offsets );
+    double dx = 0.0;
+    double dy = 0.0;
+    double dz = 0.0;
+    for ( int q = 0; q < num_queries; ++q )
+    {
+	for ( unsigned n = 0; n < num_neighbors; ++n )
+	{
+	    std::size_t i = offsets[q] + n;
+	    TEST_ASSERT( approx_dists[i] >= dists[i] );
+	    TEST_ASSERT( approx_dists[i] <= (1.0+eps)*dists[i] + 1.0e-12 );
+	    dx = queries[dim*q] - coords[dim*approx_neighbors[i]];
+	    dy = queries[dim*q+1] - coords[dim*approx_neighbors[i]+1];
+	    dz = queries[dim*q+2] - coords[dim*approx_neighbors[i]+2];
+	    TEST_FLOATING_EQUALITY( 
+		std::sqrt(dx*dx+dy*dy+dz*dz), approx_dists[i], 1.0e-12 );
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
 //---------------------------------------------------------------------------//
 // end tstStaticSearchTree.cpp
 //---------------------------------------------------------------------------//